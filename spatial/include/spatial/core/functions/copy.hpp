@@ -0,0 +1,20 @@
+#pragma once
+#include "spatial/common.hpp"
+
+namespace spatial {
+
+namespace core {
+
+struct CoreCopyFunctions {
+public:
+	static void Register(DatabaseInstance &db) {
+		RegisterGeoParquetCopyFunction(db);
+	}
+
+private:
+	static void RegisterGeoParquetCopyFunction(DatabaseInstance &db);
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -29,6 +29,9 @@ public:
 		RegisterStGeomFromHEXWKB(db);
         RegisterStGeomFromText(db);
 		RegisterStGeomFromWKB(db);
+		RegisterStGridCells(db);
+		RegisterStGridReferenceCell(db);
+		RegisterStHilbert(db);
 		RegisterStIntersects(db);
 		RegisterStIntersectsExtent(db);
 		RegisterStIsEmpty(db);
@@ -45,6 +48,8 @@ public:
 		RegisterStQuadKey(db);
 		RegisterStRemoveRepeatedPoints(db);
 		RegisterStStartPoint(db);
+		RegisterStTileCover(db);
+		RegisterStTileId(db);
 		RegisterStX(db);
 		RegisterStXMax(db);
 		RegisterStXMin(db);
@@ -123,6 +128,15 @@ private:
 	// ST_GeomFromWKB
 	static void RegisterStGeomFromWKB(DatabaseInstance &db);
 
+	// ST_GridCells
+	static void RegisterStGridCells(DatabaseInstance &db);
+
+	// ST_GridReferenceCell
+	static void RegisterStGridReferenceCell(DatabaseInstance &db);
+
+	// ST_Hilbert
+	static void RegisterStHilbert(DatabaseInstance &db);
+
 	// ST_Intersects
 	static void RegisterStIntersects(DatabaseInstance &db);
 
@@ -171,6 +185,12 @@ private:
 	// ST_StartPoint
 	static void RegisterStStartPoint(DatabaseInstance &db);
 
+	// ST_TileCover
+	static void RegisterStTileCover(DatabaseInstance &db);
+
+	// ST_TileId
+	static void RegisterStTileId(DatabaseInstance &db);
+
 	// ST_X
 	static void RegisterStX(DatabaseInstance &db);
 
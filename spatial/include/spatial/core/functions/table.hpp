@@ -13,6 +13,8 @@ public:
 		// TODO: Move these
 		RegisterShapefileTableFunction(db);
 		RegisterShapefileMetaTableFunction(db);
+		RegisterFlatGeobufTableFunction(db);
+		RegisterGeoJSONTableFunctions(db);
 		RegisterTestTableFunctions(db);
 	}
 
@@ -20,6 +22,8 @@ private:
 	static void RegisterOsmTableFunction(DatabaseInstance &db);
 	static void RegisterShapefileTableFunction(DatabaseInstance &db);
 	static void RegisterShapefileMetaTableFunction(DatabaseInstance &db);
+	static void RegisterFlatGeobufTableFunction(DatabaseInstance &db);
+	static void RegisterGeoJSONTableFunctions(DatabaseInstance &db);
 	static void RegisterTestTableFunctions(DatabaseInstance &db);
 };
 
@@ -0,0 +1,85 @@
+#pragma once
+#include "spatial/common.hpp"
+
+#include <cmath>
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Hilbert Curve
+//------------------------------------------------------------------------------
+// Positions on a hilbert curve laid over a 16-bit grid. Points that are close to each other in space tend to be close
+// to each other on the curve, so sorting by the curve position keeps spatially close rows together.
+
+inline uint32_t HilbertInterleave(uint32_t x) {
+	x = (x | (x << 8)) & 0x00FF00FF;
+	x = (x | (x << 4)) & 0x0F0F0F0F;
+	x = (x | (x << 2)) & 0x33333333;
+	x = (x | (x << 1)) & 0x55555555;
+	return x;
+}
+
+// Compute the position of (x, y) on a 16-bit hilbert curve
+inline uint32_t HilbertEncode(uint32_t x, uint32_t y) {
+	uint32_t a = x ^ y;
+	uint32_t b = 0xFFFF ^ a;
+	uint32_t c = 0xFFFF ^ (x | y);
+	uint32_t d = x & (y ^ 0xFFFF);
+
+	uint32_t A = a | (b >> 1);
+	uint32_t B = (a >> 1) ^ a;
+	uint32_t C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+	uint32_t D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+
+	a = A;
+	b = B;
+	c = C;
+	d = D;
+	A = ((a & (a >> 2)) ^ (b & (b >> 2)));
+	B = ((a & (b >> 2)) ^ (b & ((a ^ b) >> 2)));
+	C ^= ((a & (c >> 2)) ^ (b & (d >> 2)));
+	D ^= ((b & (c >> 2)) ^ ((a ^ b) & (d >> 2)));
+
+	a = A;
+	b = B;
+	c = C;
+	d = D;
+	A = ((a & (a >> 4)) ^ (b & (b >> 4)));
+	B = ((a & (b >> 4)) ^ (b & ((a ^ b) >> 4)));
+	C ^= ((a & (c >> 4)) ^ (b & (d >> 4)));
+	D ^= ((b & (c >> 4)) ^ ((a ^ b) & (d >> 4)));
+
+	a = A;
+	b = B;
+	c = C;
+	d = D;
+	C ^= ((a & (c >> 8)) ^ (b & (d >> 8)));
+	D ^= ((b & (c >> 8)) ^ ((a ^ b) & (d >> 8)));
+
+	a = C ^ (C >> 1);
+	b = D ^ (D >> 1);
+
+	uint32_t i0 = x ^ y;
+	uint32_t i1 = b | (0xFFFF ^ (i0 | a));
+
+	return (HilbertInterleave(i1) << 1) | HilbertInterleave(i0);
+}
+
+// Compute the position of (x, y) on the hilbert curve laid over the given extent.
+// Points outside of the extent are clamped to its edges.
+inline uint32_t HilbertEncode(double x, double y, double min_x, double min_y, double max_x, double max_y) {
+	auto width = max_x - min_x;
+	auto height = max_y - min_y;
+	auto scale_x = width > 0 ? 0xFFFF / width : 0;
+	auto scale_y = height > 0 ? 0xFFFF / height : 0;
+	// Written so that NaN ends up at 0
+	auto hilbert_x = std::min(65535.0, std::max(0.0, std::floor((x - min_x) * scale_x)));
+	auto hilbert_y = std::min(65535.0, std::max(0.0, std::floor((y - min_y) * scale_y)));
+	return HilbertEncode(static_cast<uint32_t>(hilbert_x), static_cast<uint32_t>(hilbert_y));
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,87 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry_type.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// PolygonEdgeIndex
+//------------------------------------------------------------------------------
+// An index over the edges of a POLYGON or MULTIPOLYGON for locating many points in the same polygon.
+// The edges are sorted into buckets of equal height along the y axis, so locating a point only has to look at the
+// edges in the bucket the point falls into, instead of walking all of the rings.
+class PolygonEdgeIndex {
+public:
+	// UNKNOWN means the point is too close to an edge to tell which side it is on using doubles
+	enum class Location : uint8_t { EXTERIOR, BOUNDARY, INTERIOR, UNKNOWN };
+
+	// Below this many lookups it is cheaper to check all the edges than to sort them into buckets
+	static constexpr idx_t MIN_BUCKETED_LOOKUPS = 4;
+
+	struct Edge {
+		double x1;
+		double y1;
+		double x2;
+		double y2;
+	};
+
+	// Index the edges of the polygon, with buckets sized for locating about the given number of points.
+	// Returns false if the geometry is not a POLYGON or MULTIPOLYGON
+	bool TryBuild(const geometry_t &geom, idx_t expected_lookups);
+
+	// Locate a point in the polygon, the rings are combined using the even-odd rule
+	Location Locate(double x, double y) const;
+
+	// The number of lookups the index was built for
+	idx_t GetExpectedLookups() const {
+		return expected_lookups;
+	}
+
+private:
+	double min_x = 0;
+	double min_y = 0;
+	double max_x = 0;
+	double max_y = 0;
+	double bucket_height = 0;
+	idx_t bucket_count = 0;
+	idx_t expected_lookups = 0;
+	// The edges of bucket i are edges[bucket_offsets[i]] up to edges[bucket_offsets[i + 1]]
+	vector<idx_t> bucket_offsets;
+	vector<Edge> edges;
+	// Scratch space for building the index
+	vector<Edge> all_edges;
+
+	idx_t GetBucket(double y) const;
+};
+
+//------------------------------------------------------------------------------
+// PolygonIndexCache
+//------------------------------------------------------------------------------
+// Keeps the indexes of the last few polygons, so that a polygon that shows up again in the next chunks (e.g. the
+// build side of a join) is not indexed again. Entries are matched on the bytes of the serialized polygon.
+class PolygonIndexCache {
+public:
+	// Returns the index of the polygon, building it if it is not cached.
+	// Returns nullptr if the geometry is not a POLYGON or MULTIPOLYGON
+	optional_ptr<const PolygonEdgeIndex> Get(const geometry_t &geom, idx_t lookups);
+
+private:
+	static constexpr idx_t CACHE_SIZE = 8;
+
+	struct Entry {
+		string blob;
+		hash_t hash = 0;
+		idx_t last_used = 0;
+		// The lookups made so far, used to rebuild the index with buckets once it is used often enough
+		idx_t lookups = 0;
+		PolygonEdgeIndex index;
+	};
+	vector<Entry> entries;
+	idx_t clock = 0;
+};
+
+} // namespace core
+
+} // namespace spatial
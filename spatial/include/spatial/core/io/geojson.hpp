@@ -0,0 +1,56 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+#include "yyjson.h"
+
+namespace spatial {
+
+namespace core {
+
+struct GeometryFactory;
+
+class JSONAllocator {
+	// Stolen from the JSON extension :)
+public:
+	explicit JSONAllocator(ArenaAllocator &allocator)
+	    : allocator(allocator), yyjson_allocator({Allocate, Reallocate, Free, &allocator}) {
+	}
+
+	inline duckdb_yyjson_spatial::yyjson_alc *GetYYJSONAllocator() {
+		return &yyjson_allocator;
+	}
+
+	void Reset() {
+		allocator.Reset();
+	}
+
+private:
+	static inline void *Allocate(void *ctx, size_t size) {
+		auto alloc = (ArenaAllocator *)ctx;
+		return alloc->AllocateAligned(size);
+	}
+
+	static inline void *Reallocate(void *ctx, void *ptr, size_t old_size, size_t size) {
+		auto alloc = (ArenaAllocator *)ctx;
+		return alloc->ReallocateAligned((data_ptr_t)ptr, old_size, size);
+	}
+
+	static inline void Free(void *ctx, void *ptr) {
+		// NOP because ArenaAllocator can't free
+	}
+
+private:
+	ArenaAllocator &allocator;
+	duckdb_yyjson_spatial::yyjson_alc yyjson_allocator;
+};
+
+struct GeoJSON {
+	// Convert a GeoJSON geometry object to a geometry, "raw" is only used in error messages
+	static Geometry FromGeoJSON(duckdb_yyjson_spatial::yyjson_val *root, GeometryFactory &factory, const string_t &raw,
+	                            bool &has_z);
+};
+
+} // namespace core
+
+} // namespace spatial
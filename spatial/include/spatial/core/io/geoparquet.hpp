@@ -0,0 +1,30 @@
+#pragma once
+#include "spatial/common.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// The struct column and its fields that hold the bounding box of a geometry column
+struct GeoParquetBBoxCovering {
+	string column;
+	// The names of the xmin, ymin, xmax and ymax fields
+	string fields[4];
+
+	bool Equals(const GeoParquetBBoxCovering &other) const {
+		return column == other.column && fields[0] == other.fields[0] && fields[1] == other.fields[1] &&
+		       fields[2] == other.fields[2] && fields[3] == other.fields[3];
+	}
+};
+
+struct GeoParquetMetadata {
+	// Read the "geo" key-value metadata from the footer of a parquet file, returns false if there is none
+	static bool TryRead(ClientContext &context, const string &file_name, string &result);
+	// Find the bbox covering of a geometry column in the "geo" metadata, returns false if it has none
+	static bool TryGetBBoxCovering(const string &geo_metadata, const string &column_name,
+	                               GeoParquetBBoxCovering &result);
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -96,6 +96,22 @@ struct EncodingUtil {
 		}
 		return len;
 	}
+
+	// Same as above, but for a buffer of known length that is not null terminated
+	static idx_t LatinToUTF8Buffer(const_data_ptr_t in, idx_t in_len, data_ptr_t out) {
+		idx_t len = 0;
+		for (idx_t i = 0; i < in_len; i++) {
+			if (in[i] < 128) {
+				*out++ = in[i];
+				len += 1;
+			} else {
+				*out++ = 0xc2 + (in[i] > 0xbf);
+				*out++ = (in[i] & 0x3f) + 0x80;
+				len += 2;
+			}
+		}
+		return len;
+	}
 };
 
 } // namespace core
@@ -14,7 +14,6 @@ struct GdalTableFunction : ArrowTableFunction {
 private:
 	static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindInput &input,
 	                                     vector<LogicalType> &return_types, vector<string> &names);
-	static void RenameColumns(vector<string> &names);
 
 	static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext &context, TableFunctionInitInput &input);
 	static unique_ptr<LocalTableFunctionState> InitLocal(ExecutionContext &context, TableFunctionInitInput &input,
@@ -26,11 +25,14 @@ private:
 
 	static unique_ptr<NodeStatistics> Cardinality(ClientContext &context, const FunctionData *data);
 
+	static string ToString(const FunctionData *bind_data_p);
+
 	static unique_ptr<TableRef> ReplacementScan(ClientContext &context, const string &table_name,
 	                                            ReplacementScanData *data);
 
 public:
 	static void Register(DatabaseInstance &db);
+	static void RenameColumns(vector<string> &names);
 };
 
 struct GdalDriversTableFunction {
@@ -1,6 +1,7 @@
 #pragma once
 #include "spatial/common.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/polygon_index.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
 namespace spatial {
 
@@ -10,6 +11,9 @@ struct GEOSFunctionLocalState : FunctionLocalState {
 public:
 	GeosContextWrapper ctx;
 	core::GeometryFactory factory;
+	// Reused by the point in polygon predicates, see GEOSExecutor::TryExecutePointInPolygon
+	core::PolygonIndexCache polygon_indexes;
+	vector<std::pair<string_t, idx_t>> polygon_rows;
 
 public:
 	explicit GEOSFunctionLocalState(ClientContext &context);
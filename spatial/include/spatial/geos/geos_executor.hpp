@@ -5,11 +5,15 @@
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/common.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/polygon_index.hpp"
 
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
 #include "duckdb/common/vector_operations/binary_executor.hpp"
 
+#include <algorithm>
+
 namespace spatial {
 
 namespace geos {
@@ -95,6 +99,111 @@ struct GEOSExecutor {
 			    });
 		}
 	}
+
+	// Spatial joins between points and polygons produce chunks where every row pairs a POINT with a POLYGON or
+	// MULTIPOLYGON, and where the same (large) polygon shows up in many rows. Instead of handing every pair to GEOS,
+	// we index the edges of each distinct polygon in the chunk once and look all of its points up in the index.
+	// Points the index can not place reliably are handed to GEOS after all.
+	// Returns false without touching the result if the chunk does not look like that.
+	static bool TryExecutePointInPolygon(GEOSFunctionLocalState &lstate, Vector &polygons, Vector &points, idx_t count,
+	                                     Vector &result, bool include_boundary) {
+		using core::GeometryType;
+		using core::PolygonEdgeIndex;
+		using PolygonRow = std::pair<string_t, idx_t>;
+
+		auto is_constant = polygons.GetVectorType() == VectorType::CONSTANT_VECTOR &&
+		                   points.GetVectorType() == VectorType::CONSTANT_VECTOR;
+		if (is_constant) {
+			count = 1;
+		}
+
+		UnifiedVectorFormat polygon_format;
+		UnifiedVectorFormat point_format;
+		polygons.ToUnifiedFormat(count, polygon_format);
+		points.ToUnifiedFormat(count, point_format);
+		auto polygon_data = UnifiedVectorFormat::GetData<geometry_t>(polygon_format);
+		auto point_data = UnifiedVectorFormat::GetData<geometry_t>(point_format);
+
+		// Check the shape of the chunk, and collect the rows of each polygon
+		auto &rows = lstate.polygon_rows;
+		rows.clear();
+		for (idx_t i = 0; i < count; i++) {
+			auto polygon_idx = polygon_format.sel->get_index(i);
+			auto point_idx = point_format.sel->get_index(i);
+			if (!polygon_format.validity.RowIsValid(polygon_idx) || !point_format.validity.RowIsValid(point_idx)) {
+				continue;
+			}
+			auto &polygon = polygon_data[polygon_idx];
+			auto polygon_type = polygon.GetType();
+			if ((polygon_type != GeometryType::POLYGON && polygon_type != GeometryType::MULTIPOLYGON) ||
+			    point_data[point_idx].GetType() != GeometryType::POINT) {
+				return false;
+			}
+			rows.emplace_back(polygon, i);
+		}
+
+		// Rows that point to the same bytes have the same polygon (e.g. rows from the build side of a join)
+		std::sort(rows.begin(), rows.end(), [](const PolygonRow &a, const PolygonRow &b) {
+			if (a.first.GetData() != b.first.GetData()) {
+				return a.first.GetData() < b.first.GetData();
+			}
+			if (a.first.GetSize() != b.first.GetSize()) {
+				return a.first.GetSize() < b.first.GetSize();
+			}
+			return a.second < b.second;
+		});
+
+		auto result_data = FlatVector::GetData<bool>(result);
+		for (idx_t i = 0; i < count; i++) {
+			if (!polygon_format.validity.RowIsValid(polygon_format.sel->get_index(i)) ||
+			    !point_format.validity.RowIsValid(point_format.sel->get_index(i))) {
+				FlatVector::SetNull(result, i, true);
+			}
+		}
+
+		auto &ctx = lstate.ctx.GetCtx();
+		GEOSPreparedBinaryPredicate predicate = include_boundary ? GEOSPreparedCovers_r : GEOSPreparedContains_r;
+		core::BoundingBox point_bbox;
+		idx_t start = 0;
+		while (start < rows.size()) {
+			auto &polygon = rows[start].first;
+			auto end = start + 1;
+			while (end < rows.size() && rows[end].first.GetData() == polygon.GetData() &&
+			       rows[end].first.GetSize() == polygon.GetSize()) {
+				end++;
+			}
+
+			auto &index = *lstate.polygon_indexes.Get(geometry_t(polygon), end - start);
+			GeometryPtr polygon_geom;
+			unique_ptr<const GEOSPreparedGeometry, GeosDeleter<const GEOSPreparedGeometry>> polygon_prepared;
+			for (auto i = start; i < end; i++) {
+				auto row = rows[i].second;
+				auto &point = point_data[point_format.sel->get_index(row)];
+				// Points have no bounding box in their header, so this gives us their exact coordinates
+				auto location = PolygonEdgeIndex::Location::EXTERIOR;
+				if (core::GeometryFactory::TryGetSerializedBoundingBox(point, point_bbox)) {
+					location = index.Locate(point_bbox.minx, point_bbox.miny);
+				}
+				if (location == PolygonEdgeIndex::Location::UNKNOWN) {
+					if (!polygon_prepared) {
+						polygon_geom = lstate.ctx.Deserialize(geometry_t(polygon));
+						polygon_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, polygon_geom.get()));
+					}
+					auto point_geom = lstate.ctx.Deserialize(point);
+					result_data[row] = predicate(ctx, polygon_prepared.get(), point_geom.get()) == 1;
+					continue;
+				}
+				result_data[row] = location == PolygonEdgeIndex::Location::INTERIOR ||
+				                   (include_boundary && location == PolygonEdgeIndex::Location::BOUNDARY);
+			}
+			start = end;
+		}
+
+		if (is_constant) {
+			result.SetVectorType(VectorType::CONSTANT_VECTOR);
+		}
+		return true;
+	}
 };
 
 } // namespace geos
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "spatial/common.hpp"
+#include "spatial/proj/fast_transform.hpp"
+
+#include "proj.h"
+
+#include <list>
+
+namespace spatial {
+
+namespace proj {
+
+struct ProjObjectDelete {
+	void operator()(PJ *obj) {
+		proj_destroy(obj);
+	}
+};
+
+using ProjObject = unique_ptr<PJ, ProjObjectDelete>;
+
+//------------------------------------------------------------------------------
+// ProjTransformation
+//------------------------------------------------------------------------------
+// A transformation from one CRS to another. Uses a closed-form implementation instead of PROJ if there is one.
+class ProjTransformation {
+public:
+	ProjTransformation(ProjObject pj_p, FastTransform fast_p) : pj(std::move(pj_p)), fast(fast_p) {
+	}
+
+	PJ *Get() const {
+		return pj.get();
+	}
+
+	// Transform the coordinates in place. The strides are in bytes, just like in proj_trans_generic
+	void Transform(double *x, size_t x_stride, double *y, size_t y_stride, idx_t count) const {
+		if (fast.IsValid()) {
+			fast.Transform(x, x_stride, y, y_stride, count);
+		} else {
+			proj_trans_generic(pj.get(), PJ_FWD, x, x_stride, count, y, y_stride, count, nullptr, 0, 0, nullptr, 0,
+			                   0);
+		}
+	}
+
+private:
+	ProjObject pj;
+	FastTransform fast;
+};
+
+//------------------------------------------------------------------------------
+// ProjContext
+//------------------------------------------------------------------------------
+// A PROJ context, together with the CRS definitions and transformations created in it.
+// Setting up a context opens the embedded proj.db, and resolving a CRS or creating a transformation queries it,
+// so contexts are pooled (see ProjModule::AcquireContext) and keep all of this around between queries.
+// A context may only be used by one thread at a time.
+class ProjContext {
+public:
+	// The number of transformations kept around
+	static constexpr idx_t TRANSFORMATION_CACHE_SIZE = 64;
+	// The number of resolved CRS definitions kept around
+	static constexpr idx_t CRS_CACHE_SIZE = 256;
+
+	ProjContext();
+	~ProjContext();
+
+	PJ_CONTEXT *Get() const {
+		return ctx;
+	}
+
+	// Get the transformation from one CRS to another, creating it if it isnt cached yet
+	const ProjTransformation &GetTransformation(const string_t &from, const string_t &to, bool always_xy);
+
+private:
+	struct Transformation {
+		string from;
+		string to;
+		bool always_xy;
+		ProjTransformation transformation;
+
+		bool Matches(const string_t &from_p, const string_t &to_p, bool always_xy_p) const;
+	};
+
+	static string GetTransformationKey(const string_t &from, const string_t &to, bool always_xy);
+	PJ *GetCRS(const string &definition);
+	ProjTransformation CreateTransformation(const string &from, const string &to, bool always_xy);
+
+	PJ_CONTEXT *ctx;
+
+	// Most recently used first
+	std::list<Transformation> transformations;
+	unordered_map<string, std::list<Transformation>::iterator> transformation_map;
+
+	unordered_map<string, ProjObject> crs_map;
+};
+
+} // namespace proj
+
+} // namespace spatial
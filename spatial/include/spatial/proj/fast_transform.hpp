@@ -0,0 +1,58 @@
+#pragma once
+
+#include "spatial/common.hpp"
+
+#include "proj.h"
+
+namespace spatial {
+
+namespace proj {
+
+//------------------------------------------------------------------------------
+// FastTransform
+//------------------------------------------------------------------------------
+// Closed-form implementations of the transformations we see the most: WGS84 to/from Web Mercator and WGS84 to/from
+// the WGS84 UTM zones. These follow the math of the PROJ operations they replace ("webmerc" and the default, exact,
+// Krüger series "tmerc"), but run as plain loops over the coordinates without going through the PROJ pipeline for
+// every single one of them.
+class FastTransform {
+public:
+	enum class Kind : uint8_t {
+		NONE,
+		GEOGRAPHIC_TO_WEB_MERCATOR,
+		WEB_MERCATOR_TO_GEOGRAPHIC,
+		GEOGRAPHIC_TO_UTM,
+		UTM_TO_GEOGRAPHIC
+	};
+
+	FastTransform() : kind(Kind::NONE), lat_first(false), lon_0(0), y_0(0) {
+	}
+
+	// Look for a closed-form implementation of the transformation between two resolved CRSs.
+	// Returns a transform of kind NONE if there is none, in which case PROJ has to be used
+	static FastTransform Create(PJ_CONTEXT *ctx, PJ *from, PJ *to, bool always_xy);
+
+	bool IsValid() const {
+		return kind != Kind::NONE;
+	}
+
+	Kind GetKind() const {
+		return kind;
+	}
+
+	// Transform the coordinates in place. The strides are in bytes, just like in proj_trans_generic.
+	// Coordinates that can not be transformed are set to HUGE_VAL, like PROJ does
+	void Transform(double *x, size_t x_stride, double *y, size_t y_stride, idx_t count) const;
+
+private:
+	Kind kind;
+	// Whether the geographic coordinates are in latitude, longitude order (the EPSG:4326 axis order)
+	bool lat_first;
+	// The central meridian (in radians) and false northing of the UTM zone
+	double lon_0;
+	double y_0;
+};
+
+} // namespace proj
+
+} // namespace spatial
@@ -8,9 +8,18 @@ namespace spatial {
 
 namespace proj {
 
+class ProjContext;
+
 struct ProjModule {
 public:
-	static PJ_CONTEXT *GetThreadProjContext();
+	// Create a new context that reads from the embedded proj.db
+	static PJ_CONTEXT *CreateContext();
+
+	// Get a context from the shared pool (or a new one, if the pool is empty).
+	// Return it with ReleaseContext once done, so that other threads and queries can reuse it.
+	static unique_ptr<ProjContext> AcquireContext();
+	static void ReleaseContext(unique_ptr<ProjContext> context);
+
 	static void Register(DatabaseInstance &db);
 };
 
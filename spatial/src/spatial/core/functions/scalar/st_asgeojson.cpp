@@ -8,6 +8,7 @@
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/io/geojson.hpp"
 #include "spatial/core/types.hpp"
 
 #include "yyjson.h"
@@ -20,41 +21,6 @@ namespace core {
 
 using namespace duckdb_yyjson_spatial;
 
-class JSONAllocator {
-	// Stolen from the JSON extension :)
-public:
-	explicit JSONAllocator(ArenaAllocator &allocator)
-	    : allocator(allocator), yyjson_allocator({Allocate, Reallocate, Free, &allocator}) {
-	}
-
-	inline yyjson_alc *GetYYJSONAllocator() {
-		return &yyjson_allocator;
-	}
-
-	void Reset() {
-		allocator.Reset();
-	}
-
-private:
-	static inline void *Allocate(void *ctx, size_t size) {
-		auto alloc = (ArenaAllocator *)ctx;
-		return alloc->AllocateAligned(size);
-	}
-
-	static inline void *Reallocate(void *ctx, void *ptr, size_t old_size, size_t size) {
-		auto alloc = (ArenaAllocator *)ctx;
-		return alloc->ReallocateAligned((data_ptr_t)ptr, old_size, size);
-	}
-
-	static inline void Free(void *ctx, void *ptr) {
-		// NOP because ArenaAllocator can't free
-	}
-
-private:
-	ArenaAllocator &allocator;
-	yyjson_alc yyjson_allocator;
-};
-
 //------------------------------------------------------------------------------
 // GEOMETRY -> GEOJSON Fragment
 //------------------------------------------------------------------------------
@@ -444,8 +410,6 @@ static MultiPolygon MultiPolygonFromGeoJSON(yyjson_val *coord_array, GeometryFac
 	}
 }
 
-static Geometry FromGeoJSON(yyjson_val *root, GeometryFactory &factory, const string_t &raw, bool &has_z);
-
 static GeometryCollection GeometryCollectionFromGeoJSON(yyjson_val *root, GeometryFactory &factory, const string_t &raw,
                                                         bool &has_z) {
 	auto geometries_val = yyjson_obj_get(root, "geometries");
@@ -465,14 +429,14 @@ static GeometryCollection GeometryCollectionFromGeoJSON(yyjson_val *root, Geomet
 		size_t idx, max;
 		yyjson_val *geometry_val;
 		yyjson_arr_foreach(geometries_val, idx, max, geometry_val) {
-			geometry_collection[idx] = FromGeoJSON(geometry_val, factory, raw, has_z);
+			geometry_collection[idx] = GeoJSON::FromGeoJSON(geometry_val, factory, raw, has_z);
 		}
 
 		return geometry_collection;
 	}
 }
 
-static Geometry FromGeoJSON(yyjson_val *root, GeometryFactory &factory, const string_t &raw, bool &has_z) {
+Geometry GeoJSON::FromGeoJSON(yyjson_val *root, GeometryFactory &factory, const string_t &raw, bool &has_z) {
 	auto type_val = yyjson_obj_get(root, "type");
 	if (!type_val) {
 		throw InvalidInputException("GeoJSON input does not have a type field: %s", raw.GetString());
@@ -536,7 +500,7 @@ static void GeoJSONFragmentToGeometryFunction(DataChunk &args, ExpressionState &
 			throw InvalidInputException("Could not parse GeoJSON input: %s, (%s)", err.msg, input.GetString());
 		} else {
 			bool has_z = false;
-			auto geom = FromGeoJSON(root, lstate.factory, input, has_z);
+			auto geom = GeoJSON::FromGeoJSON(root, lstate.factory, input, has_z);
 			if (has_z) {
 				// Ensure the geometries has consistent Z values
 				geom.SetVertexType(lstate.factory.allocator, has_z, false);
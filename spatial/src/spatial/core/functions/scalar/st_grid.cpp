@@ -0,0 +1,176 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+
+#include <cmath>
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Grid
+//------------------------------------------------------------------------------
+// A uniform grid of square cells anchored at the origin, used to partition spatial joins. Geometries are assigned to
+// the cells their (header) bounding box overlaps. Cell ids pack the column and row of the cell into a single UBIGINT.
+
+// The most cells we assign a single geometry to
+static constexpr idx_t MAX_GRID_CELLS = 1 << 20;
+
+static void CheckCellSize(const char *function_name, double cell_size) {
+	if (!(cell_size > 0) || !std::isfinite(cell_size)) {
+		throw InvalidInputException("%s: Cell size must be a positive number", function_name);
+	}
+}
+
+static int32_t GetCell(double value, double cell_size) {
+	auto cell = std::floor(value / cell_size);
+	// Written so that NaN ends up in the first cell
+	if (!(cell >= static_cast<double>(NumericLimits<int32_t>::Minimum()))) {
+		return NumericLimits<int32_t>::Minimum();
+	}
+	if (cell > static_cast<double>(NumericLimits<int32_t>::Maximum())) {
+		return NumericLimits<int32_t>::Maximum();
+	}
+	return static_cast<int32_t>(cell);
+}
+
+static uint64_t GetCellId(int32_t x, int32_t y) {
+	return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+//------------------------------------------------------------------------------
+// ST_GridCells
+//------------------------------------------------------------------------------
+static void GridCellsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &geom = args.data[0];
+	auto &cell_size = args.data[1];
+	auto count = args.size();
+
+	BoundingBox bbox;
+	BinaryExecutor::Execute<geometry_t, double, list_entry_t>(
+	    geom, cell_size, result, count, [&](geometry_t input, double cell_size) {
+		    CheckCellSize("ST_GridCells", cell_size);
+
+		    auto offset = ListVector::GetListSize(result);
+		    if (!GeometryFactory::TryGetSerializedBoundingBox(input, bbox)) {
+			    // Empty geometries are not in any cell
+			    return list_entry_t {offset, 0};
+		    }
+
+		    auto min_x = GetCell(bbox.minx, cell_size);
+		    auto min_y = GetCell(bbox.miny, cell_size);
+		    auto max_x = GetCell(bbox.maxx, cell_size);
+		    auto max_y = GetCell(bbox.maxy, cell_size);
+
+		    auto width = static_cast<idx_t>(static_cast<int64_t>(max_x) - min_x + 1);
+		    auto height = static_cast<idx_t>(static_cast<int64_t>(max_y) - min_y + 1);
+		    if (width > MAX_GRID_CELLS || height > MAX_GRID_CELLS || width * height > MAX_GRID_CELLS) {
+			    throw InvalidInputException(
+			        "ST_GridCells: The geometry overlaps more than %d cells, try a larger cell size", MAX_GRID_CELLS);
+		    }
+		    auto length = width * height;
+
+		    ListVector::Reserve(result, offset + length);
+		    auto cell_data = FlatVector::GetData<uint64_t>(ListVector::GetEntry(result)) + offset;
+		    for (int64_t x = min_x; x <= max_x; x++) {
+			    for (int64_t y = min_y; y <= max_y; y++) {
+				    *cell_data++ = GetCellId(static_cast<int32_t>(x), static_cast<int32_t>(y));
+			    }
+		    }
+		    ListVector::SetListSize(result, offset + length);
+		    return list_entry_t {offset, length};
+	    });
+}
+
+//------------------------------------------------------------------------------
+// ST_GridReferenceCell
+//------------------------------------------------------------------------------
+// When both sides of a join are assigned to multiple cells, a pair of geometries meets in every cell they both overlap.
+// To report each pair only once, we only keep it in the cell that contains the lower left corner of the intersection
+// of their bounding boxes (the "reference point"). That corner is in both bounding boxes, so the cell is always one
+// that both geometries were assigned to.
+static void GridReferenceCellFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto count = args.size();
+	auto &left_vec = args.data[0];
+	auto &right_vec = args.data[1];
+	auto &size_vec = args.data[2];
+
+	auto is_constant = left_vec.GetVectorType() == VectorType::CONSTANT_VECTOR &&
+	                   right_vec.GetVectorType() == VectorType::CONSTANT_VECTOR &&
+	                   size_vec.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	if (is_constant) {
+		count = 1;
+	}
+
+	UnifiedVectorFormat left_format;
+	UnifiedVectorFormat right_format;
+	UnifiedVectorFormat size_format;
+	left_vec.ToUnifiedFormat(count, left_format);
+	right_vec.ToUnifiedFormat(count, right_format);
+	size_vec.ToUnifiedFormat(count, size_format);
+	auto left_data = UnifiedVectorFormat::GetData<geometry_t>(left_format);
+	auto right_data = UnifiedVectorFormat::GetData<geometry_t>(right_format);
+	auto size_data = UnifiedVectorFormat::GetData<double>(size_format);
+
+	auto result_data = FlatVector::GetData<uint64_t>(result);
+
+	BoundingBox left_bbox;
+	BoundingBox right_bbox;
+	for (idx_t i = 0; i < count; i++) {
+		auto left_idx = left_format.sel->get_index(i);
+		auto right_idx = right_format.sel->get_index(i);
+		auto size_idx = size_format.sel->get_index(i);
+		if (!left_format.validity.RowIsValid(left_idx) || !right_format.validity.RowIsValid(right_idx) ||
+		    !size_format.validity.RowIsValid(size_idx)) {
+			FlatVector::SetNull(result, i, true);
+			continue;
+		}
+		auto cell_size = size_data[size_idx];
+		CheckCellSize("ST_GridReferenceCell", cell_size);
+
+		// Geometries whose bounding boxes dont intersect dont share a cell
+		if (!GeometryFactory::TryGetSerializedBoundingBox(left_data[left_idx], left_bbox) ||
+		    !GeometryFactory::TryGetSerializedBoundingBox(right_data[right_idx], right_bbox) ||
+		    !left_bbox.Intersects(right_bbox)) {
+			FlatVector::SetNull(result, i, true);
+			continue;
+		}
+		auto x = std::max(left_bbox.minx, right_bbox.minx);
+		auto y = std::max(left_bbox.miny, right_bbox.miny);
+		result_data[i] = GetCellId(GetCell(x, cell_size), GetCell(y, cell_size));
+	}
+
+	if (is_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStGridCells(DatabaseInstance &db) {
+	ScalarFunctionSet set("ST_GridCells");
+
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::DOUBLE}, LogicalType::LIST(LogicalType::UBIGINT),
+	                               GridCellsFunction));
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+void CoreScalarFunctions::RegisterStGridReferenceCell(DatabaseInstance &db) {
+	ScalarFunctionSet set("ST_GridReferenceCell");
+
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), GeoTypes::GEOMETRY(), LogicalType::DOUBLE},
+	                               LogicalType::UBIGINT, GridReferenceCellFunction));
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+} // namespace core
+
+} // namespace spatial
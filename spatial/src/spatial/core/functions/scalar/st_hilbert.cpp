@@ -0,0 +1,98 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/hilbert.hpp"
+
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/common/vector_operations/generic_executor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Coordinates
+//------------------------------------------------------------------------------
+static void CoordinateHilbertFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	using DOUBLE_TYPE = PrimitiveType<double>;
+	using BOX_TYPE = StructTypeQuaternary<double, double, double, double>;
+	using UINT32_TYPE = PrimitiveType<uint32_t>;
+
+	GenericExecutor::ExecuteTernary<DOUBLE_TYPE, DOUBLE_TYPE, BOX_TYPE, UINT32_TYPE>(
+	    args.data[0], args.data[1], args.data[2], result, args.size(),
+	    [&](DOUBLE_TYPE x, DOUBLE_TYPE y, BOX_TYPE &box) {
+		    return HilbertEncode(x.val, y.val, box.a_val, box.b_val, box.c_val, box.d_val);
+	    });
+}
+
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+// We only look at the center of the bounding box in the geometry header, so we never have to deserialize the geometry
+static void GeometryHilbertFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto count = args.size();
+	auto &geom_vec = args.data[0];
+	auto &box_vec = args.data[1];
+
+	auto is_constant = geom_vec.GetVectorType() == VectorType::CONSTANT_VECTOR &&
+	                   box_vec.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	if (is_constant) {
+		count = 1;
+	}
+
+	UnifiedVectorFormat geom_format;
+	geom_vec.ToUnifiedFormat(count, geom_format);
+	auto geom_data = UnifiedVectorFormat::GetData<geometry_t>(geom_format);
+
+	box_vec.Flatten(count);
+	auto &box_validity = FlatVector::Validity(box_vec);
+	auto &box_children = StructVector::GetEntries(box_vec);
+	auto min_x_data = FlatVector::GetData<double>(*box_children[0]);
+	auto min_y_data = FlatVector::GetData<double>(*box_children[1]);
+	auto max_x_data = FlatVector::GetData<double>(*box_children[2]);
+	auto max_y_data = FlatVector::GetData<double>(*box_children[3]);
+
+	auto result_data = FlatVector::GetData<uint32_t>(result);
+
+	BoundingBox bbox;
+	for (idx_t i = 0; i < count; i++) {
+		auto geom_idx = geom_format.sel->get_index(i);
+		if (!geom_format.validity.RowIsValid(geom_idx) || !box_validity.RowIsValid(i)) {
+			FlatVector::SetNull(result, i, true);
+			continue;
+		}
+		if (!GeometryFactory::TryGetSerializedBoundingBox(geom_data[geom_idx], bbox)) {
+			// Empty geometries have no position on the curve
+			FlatVector::SetNull(result, i, true);
+			continue;
+		}
+		auto center_x = (bbox.minx + bbox.maxx) / 2;
+		auto center_y = (bbox.miny + bbox.maxy) / 2;
+		result_data[i] =
+		    HilbertEncode(center_x, center_y, min_x_data[i], min_y_data[i], max_x_data[i], max_y_data[i]);
+	}
+
+	if (is_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStHilbert(DatabaseInstance &db) {
+	ScalarFunctionSet set("ST_Hilbert");
+
+	set.AddFunction(ScalarFunction({LogicalType::DOUBLE, LogicalType::DOUBLE, GeoTypes::BOX_2D()},
+	                               LogicalType::UINTEGER, CoordinateHilbertFunction));
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), GeoTypes::BOX_2D()}, LogicalType::UINTEGER,
+	                               GeometryHilbertFunction));
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -5,27 +5,89 @@
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
 #include "spatial/core/types.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 namespace spatial {
 
 namespace core {
 
-static void GetQuadKey(double lon, double lat, int32_t level, char *buffer) {
+//------------------------------------------------------------------------------
+// Tiles
+//------------------------------------------------------------------------------
+// Tiles follow the Bing Maps/Web Mercator tiling scheme, where tile y grows from north to south.
+
+static constexpr double MAX_LATITUDE = 85.05112878;
+static constexpr int32_t MIN_LEVEL = 1;
+static constexpr int32_t MAX_LEVEL = 23;
 
-	lat = std::max(-85.05112878, std::min(85.05112878, lat));
+static void ClampCoordinates(double &lon, double &lat) {
+	lat = std::max(-MAX_LATITUDE, std::min(MAX_LATITUDE, lat));
 	lon = std::max(-180.0, std::min(180.0, lon));
+}
 
+// Get the tile a lon/lat point falls into at the given level, the point has to be clamped already
+static void GetTileXY(double lon, double lat, int32_t level, uint32_t &x, uint32_t &y) {
 	double lat_rad = lat * PI / 180.0;
-	auto x = static_cast<int32_t>((lon + 180.0) / 360.0 * (1 << level));
-	auto y =
-	    static_cast<int32_t>((1.0 - std::log(std::tan(lat_rad) + 1.0 / std::cos(lat_rad)) / PI) / 2.0 * (1 << level));
+	auto n = static_cast<double>(1 << level);
+	auto fx = (lon + 180.0) / 360.0 * n;
+	auto fy = (1.0 - std::log(std::tan(lat_rad) + 1.0 / std::cos(lat_rad)) / PI) / 2.0 * n;
+	// Points on the east/south edge of the world belong to the last tile
+	auto max_tile = n - 1;
+	x = static_cast<uint32_t>(std::max(0.0, std::min(max_tile, std::floor(fx))));
+	y = static_cast<uint32_t>(std::max(0.0, std::min(max_tile, std::floor(fy))));
+}
+
+// The longitude of the west edge of tile column x
+static double GetTileLon(double x, int32_t level) {
+	return x / static_cast<double>(1 << level) * 360.0 - 180.0;
+}
+
+// The latitude of the north edge of tile row y
+static double GetTileLat(double y, int32_t level) {
+	return std::atan(std::sinh(PI * (1.0 - 2.0 * y / static_cast<double>(1 << level)))) * 180.0 / PI;
+}
+
+// Spread the bits of a 32 bit integer out over the even bits of a 64 bit integer
+static uint64_t SpreadBits(uint32_t value) {
+	uint64_t x = value;
+	x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+	x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+	x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	x = (x | (x << 2)) & 0x3333333333333333ULL;
+	x = (x | (x << 1)) & 0x5555555555555555ULL;
+	return x;
+}
+
+// The tile id is the quadkey of the tile read as a base 4 number (i.e. the tile x and y interleaved, in Morton order)
+// with an extra 1 bit in front of it to encode the level. This keeps the ids of tiles on different levels distinct,
+// and the id of the parent tile is just the id shifted two bits to the right.
+static uint64_t EncodeTileId(uint32_t x, uint32_t y, int32_t level) {
+	return (1ULL << (2 * level)) | SpreadBits(x) | (SpreadBits(y) << 1);
+}
+
+static void CheckLevel(const char *function_name, int32_t level) {
+	if (level < MIN_LEVEL || level > MAX_LEVEL) {
+		throw InvalidInputException("%s: Level must be between %d and %d", function_name, MIN_LEVEL, MAX_LEVEL);
+	}
+}
+
+//------------------------------------------------------------------------------
+// ST_QuadKey
+//------------------------------------------------------------------------------
+static void GetQuadKey(double lon, double lat, int32_t level, char *buffer) {
+	ClampCoordinates(lon, lat);
+
+	uint32_t x;
+	uint32_t y;
+	GetTileXY(lon, lat, level, x, y);
 
 	for (int i = level; i > 0; --i) {
 		char digit = '0';
-		int32_t mask = 1 << (i - 1);
+		uint32_t mask = 1 << (i - 1);
 		if ((x & mask) != 0) {
 			digit += 1;
 		}
@@ -47,9 +109,7 @@ static void CoordinateQuadKeyFunction(DataChunk &args, ExpressionState &state, V
 
 	TernaryExecutor::Execute<double, double, int32_t, string_t>(
 	    lon_in, lat_in, level, result, count, [&](double lon, double lat, int32_t level) {
-		    if (level < 1 || level > 23) {
-			    throw InvalidInputException("ST_QuadKey: Level must be between 1 and 23");
-		    }
+		    CheckLevel("ST_QuadKey", level);
 		    char buffer[64];
 		    GetQuadKey(lon, lat, level, buffer);
 		    return StringVector::AddString(result, buffer, level);
@@ -79,9 +139,7 @@ static void GeometryQuadKeyFunction(DataChunk &args, ExpressionState &state, Vec
 		    auto x = vertex.x;
 		    auto y = vertex.y;
 
-		    if (level < 1 || level > 23) {
-			    throw InvalidInputException("ST_QuadKey: Level must be between 1 and 23");
-		    }
+		    CheckLevel("ST_QuadKey", level);
 
 		    char buffer[64];
 		    GetQuadKey(x, y, level, buffer);
@@ -89,6 +147,264 @@ static void GeometryQuadKeyFunction(DataChunk &args, ExpressionState &state, Vec
 	    });
 }
 
+//------------------------------------------------------------------------------
+// ST_TileId
+//------------------------------------------------------------------------------
+static uint64_t GetTileId(double lon, double lat, int32_t level) {
+	ClampCoordinates(lon, lat);
+	uint32_t x;
+	uint32_t y;
+	GetTileXY(lon, lat, level, x, y);
+	return EncodeTileId(x, y, level);
+}
+
+//------------------------------------------------------------------------------
+// Coordinates
+//------------------------------------------------------------------------------
+static void CoordinateTileIdFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lon_in = args.data[0];
+	auto &lat_in = args.data[1];
+	auto &level_in = args.data[2];
+	auto count = args.size();
+
+	if (level_in.GetVectorType() == VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(level_in)) {
+		// Common case: the level is constant, so we only have to check it once
+		auto level = ConstantVector::GetData<int32_t>(level_in)[0];
+		CheckLevel("ST_TileId", level);
+		BinaryExecutor::Execute<double, double, uint64_t>(
+		    lon_in, lat_in, result, count, [&](double lon, double lat) { return GetTileId(lon, lat, level); });
+	} else {
+		TernaryExecutor::Execute<double, double, int32_t, uint64_t>(
+		    lon_in, lat_in, level_in, result, count, [&](double lon, double lat, int32_t level) {
+			    CheckLevel("ST_TileId", level);
+			    return GetTileId(lon, lat, level);
+		    });
+	}
+}
+
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+static void GeometryTileIdFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &ctx = GeometryFunctionLocalState::ResetAndGet(state);
+
+	auto &geom = args.data[0];
+	auto &level = args.data[1];
+	auto count = args.size();
+
+	BinaryExecutor::Execute<geometry_t, int32_t, uint64_t>(
+	    geom, level, result, count, [&](geometry_t input, int32_t level) {
+		    if (input.GetType() != GeometryType::POINT) {
+			    throw InvalidInputException("ST_TileId: Only POINT geometries are supported");
+		    }
+		    auto point = ctx.factory.Deserialize(input);
+		    if (point.IsEmpty()) {
+			    throw InvalidInputException("ST_TileId: Empty geometries are not supported");
+		    }
+		    CheckLevel("ST_TileId", level);
+		    auto vertex = point.As<Point>().Vertices().Get(0);
+		    return GetTileId(vertex.x, vertex.y, level);
+	    });
+}
+
+//------------------------------------------------------------------------------
+// ST_TileCover
+//------------------------------------------------------------------------------
+// The most tiles we return for a single geometry
+static constexpr idx_t MAX_TILE_COVER_SIZE = 1 << 20;
+
+// Collects the ids of all tiles that a geometry touches. Lines are traced through the tile grid segment by segment,
+// and polygons additionally get the tiles whose centers are inside of them, one tile row at a time.
+// Coordinates are in lon/lat and clamped to the bounds of the tiling scheme, like for ST_QuadKey.
+class TileCoverProcessor final : GeometryProcessor<> {
+	int32_t level = 0;
+	vector<uint64_t> tiles;
+	vector<VertexData> rings;
+	vector<double> crossings;
+
+	void AddTile(uint32_t x, uint32_t y) {
+		// Allow for some duplicates, these are only removed at the end
+		if (tiles.size() >= 4 * MAX_TILE_COVER_SIZE) {
+			throw InvalidInputException("ST_TileCover: The geometry covers more than %d tiles at level %d",
+			                            MAX_TILE_COVER_SIZE, level);
+		}
+		tiles.push_back(EncodeTileId(x, y, level));
+	}
+
+	static void GetVertex(const VertexData &vertices, uint32_t i, double &lon, double &lat) {
+		lon = Load<double>(vertices.data[0] + i * vertices.stride[0]);
+		lat = Load<double>(vertices.data[1] + i * vertices.stride[1]);
+		ClampCoordinates(lon, lat);
+	}
+
+	void AddSegment(double lon0, double lat0, double lon1, double lat1) {
+		uint32_t x, y, x_end, y_end;
+		GetTileXY(lon0, lat0, level, x, y);
+		GetTileXY(lon1, lat1, level, x_end, y_end);
+		AddTile(x, y);
+
+		auto dlon = lon1 - lon0;
+		auto dlat = lat1 - lat0;
+		// Tile y grows southwards
+		int32_t step_x = x_end > x ? 1 : -1;
+		int32_t step_y = y_end > y ? 1 : -1;
+
+		// Step into the next tile along the segment, whichever edge it crosses first
+		while (x != x_end || y != y_end) {
+			auto t_x = NumericLimits<double>::Maximum();
+			auto t_y = NumericLimits<double>::Maximum();
+			if (x != x_end) {
+				t_x = (GetTileLon(x + (step_x > 0 ? 1 : 0), level) - lon0) / dlon;
+			}
+			if (y != y_end) {
+				t_y = (GetTileLat(y + (step_y > 0 ? 1 : 0), level) - lat0) / dlat;
+			}
+			if (t_x < t_y) {
+				x += step_x;
+			} else if (t_y < t_x) {
+				y += step_y;
+			} else {
+				// Right through a corner, include the tiles on both sides to be safe
+				AddTile(x + step_x, y);
+				AddTile(x, y + step_y);
+				x += step_x;
+				y += step_y;
+			}
+			AddTile(x, y);
+		}
+	}
+
+	void AddLine(const VertexData &vertices) {
+		if (vertices.count == 0) {
+			return;
+		}
+		double lon0, lat0;
+		GetVertex(vertices, 0, lon0, lat0);
+		if (vertices.count == 1) {
+			AddSegment(lon0, lat0, lon0, lat0);
+			return;
+		}
+		for (uint32_t i = 1; i < vertices.count; i++) {
+			double lon1, lat1;
+			GetVertex(vertices, i, lon1, lat1);
+			AddSegment(lon0, lat0, lon1, lat1);
+			lon0 = lon1;
+			lat0 = lat1;
+		}
+	}
+
+	// Add the tiles whose centers are inside the polygon (even-odd rule over all rings)
+	void FillPolygon() {
+		auto &shell = rings[0];
+		if (shell.count < 4) {
+			return;
+		}
+		double min_lat = MAX_LATITUDE;
+		double max_lat = -MAX_LATITUDE;
+		for (uint32_t i = 0; i < shell.count; i++) {
+			double lon, lat;
+			GetVertex(shell, i, lon, lat);
+			min_lat = std::min(min_lat, lat);
+			max_lat = std::max(max_lat, lat);
+		}
+		uint32_t x, y_min, y_max;
+		GetTileXY(0, max_lat, level, x, y_min);
+		GetTileXY(0, min_lat, level, x, y_max);
+
+		auto n = static_cast<double>(1 << level);
+		for (auto y = y_min; y <= y_max; y++) {
+			auto row_lat = GetTileLat(y + 0.5, level);
+
+			crossings.clear();
+			for (auto &ring : rings) {
+				for (uint32_t i = 1; i < ring.count; i++) {
+					double lon0, lat0, lon1, lat1;
+					GetVertex(ring, i - 1, lon0, lat0);
+					GetVertex(ring, i, lon1, lat1);
+					if ((lat0 > row_lat) != (lat1 > row_lat)) {
+						crossings.push_back(lon0 + (row_lat - lat0) * (lon1 - lon0) / (lat1 - lat0));
+					}
+				}
+			}
+			std::sort(crossings.begin(), crossings.end());
+
+			for (idx_t i = 0; i + 1 < crossings.size(); i += 2) {
+				// The tiles with their center between the two crossings
+				auto first = std::ceil((crossings[i] + 180.0) / 360.0 * n - 0.5);
+				auto last = std::floor((crossings[i + 1] + 180.0) / 360.0 * n - 0.5);
+				first = std::max(0.0, first);
+				last = std::min(n - 1, last);
+				for (auto tile_x = first; tile_x <= last; tile_x++) {
+					AddTile(static_cast<uint32_t>(tile_x), y);
+				}
+			}
+		}
+	}
+
+	void ProcessPoint(const VertexData &vertices) override {
+		AddLine(vertices);
+	}
+
+	void ProcessLineString(const VertexData &vertices) override {
+		AddLine(vertices);
+	}
+
+	void ProcessPolygon(PolygonState &state) override {
+		rings.clear();
+		while (!state.IsDone()) {
+			auto ring = state.Next();
+			AddLine(ring);
+			rings.push_back(ring);
+		}
+		if (!rings.empty()) {
+			FillPolygon();
+		}
+	}
+
+	void ProcessCollection(CollectionState &state) override {
+		while (!state.IsDone()) {
+			state.Next();
+		}
+	}
+
+public:
+	// Returns the sorted and deduplicated ids of the tiles
+	const vector<uint64_t> &Execute(const geometry_t &geometry, int32_t level_p) {
+		level = level_p;
+		tiles.clear();
+		Process(geometry);
+		std::sort(tiles.begin(), tiles.end());
+		tiles.erase(std::unique(tiles.begin(), tiles.end()), tiles.end());
+		if (tiles.size() > MAX_TILE_COVER_SIZE) {
+			throw InvalidInputException("ST_TileCover: The geometry covers more than %d tiles at level %d",
+			                            MAX_TILE_COVER_SIZE, level);
+		}
+		return tiles;
+	}
+};
+
+static void GeometryTileCoverFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &geom = args.data[0];
+	auto &level = args.data[1];
+	auto count = args.size();
+
+	TileCoverProcessor processor;
+	BinaryExecutor::Execute<geometry_t, int32_t, list_entry_t>(
+	    geom, level, result, count, [&](geometry_t input, int32_t level) {
+		    CheckLevel("ST_TileCover", level);
+		    auto &tiles = processor.Execute(input, level);
+
+		    auto offset = ListVector::GetListSize(result);
+		    ListVector::Reserve(result, offset + tiles.size());
+		    auto tile_data = FlatVector::GetData<uint64_t>(ListVector::GetEntry(result));
+		    if (!tiles.empty()) {
+			    memcpy(tile_data + offset, tiles.data(), tiles.size() * sizeof(uint64_t));
+		    }
+		    ListVector::SetListSize(result, offset + tiles.size());
+		    return list_entry_t {offset, tiles.size()};
+	    });
+}
+
 //------------------------------------------------------------------------------
 // Register functions
 //------------------------------------------------------------------------------
@@ -105,6 +421,29 @@ void CoreScalarFunctions::RegisterStQuadKey(DatabaseInstance &db) {
 	ExtensionUtil::RegisterFunction(db, set);
 }
 
+void CoreScalarFunctions::RegisterStTileId(DatabaseInstance &db) {
+
+	ScalarFunctionSet set("ST_TileId");
+
+	set.AddFunction(ScalarFunction({LogicalType::DOUBLE, LogicalType::DOUBLE, LogicalType::INTEGER},
+	                               LogicalType::UBIGINT, CoordinateTileIdFunction));
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::INTEGER}, LogicalType::UBIGINT,
+	                               GeometryTileIdFunction, nullptr, nullptr, nullptr,
+	                               GeometryFunctionLocalState::Init));
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
+void CoreScalarFunctions::RegisterStTileCover(DatabaseInstance &db) {
+
+	ScalarFunctionSet set("ST_TileCover");
+
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::INTEGER},
+	                               LogicalType::LIST(LogicalType::UBIGINT), GeometryTileCoverFunction));
+
+	ExtensionUtil::RegisterFunction(db, set);
+}
+
 } // namespace core
 
 } // namespace spatial
@@ -0,0 +1,241 @@
+#include "spatial/core/geometry/polygon_index.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
+
+#include "duckdb/common/types/hash.hpp"
+
+#include <cmath>
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Edge Collection
+//------------------------------------------------------------------------------
+class PolygonEdgeCollector final : GeometryProcessor<> {
+	vector<PolygonEdgeIndex::Edge> &edges;
+
+	void ProcessPoint(const VertexData &vertices) override {
+	}
+
+	void ProcessLineString(const VertexData &vertices) override {
+	}
+
+	void ProcessPolygon(PolygonState &state) override {
+		while (!state.IsDone()) {
+			auto ring = state.Next();
+			for (uint32_t i = 1; i < ring.count; i++) {
+				PolygonEdgeIndex::Edge edge;
+				edge.x1 = Load<double>(ring.data[0] + (i - 1) * ring.stride[0]);
+				edge.y1 = Load<double>(ring.data[1] + (i - 1) * ring.stride[1]);
+				edge.x2 = Load<double>(ring.data[0] + i * ring.stride[0]);
+				edge.y2 = Load<double>(ring.data[1] + i * ring.stride[1]);
+				if (edge.x1 == edge.x2 && edge.y1 == edge.y2) {
+					// Repeated point
+					continue;
+				}
+				edges.push_back(edge);
+			}
+		}
+	}
+
+	void ProcessCollection(CollectionState &state) override {
+		while (!state.IsDone()) {
+			state.Next();
+		}
+	}
+
+public:
+	explicit PolygonEdgeCollector(vector<PolygonEdgeIndex::Edge> &edges) : edges(edges) {
+	}
+
+	void Execute(const geometry_t &geom) {
+		edges.clear();
+		Process(geom);
+	}
+};
+
+//------------------------------------------------------------------------------
+// PolygonEdgeIndex
+//------------------------------------------------------------------------------
+// The edges per bucket we aim for, and the most buckets we use
+static constexpr idx_t EDGES_PER_BUCKET = 4;
+static constexpr idx_t MAX_BUCKETS = 1 << 16;
+// Edges spanning multiple buckets are stored once per bucket, this bounds how many copies we make in total
+static constexpr idx_t MAX_EDGE_COPIES = 16;
+// The relative error bound of the side test below, see "Adaptive Precision Floating-Point Arithmetic and Fast
+// Robust Geometric Predicates" (Shewchuk). The machine epsilon here is 2^-53
+static constexpr double SIDE_EPSILON = 1.1102230246251565e-16;
+static constexpr double SIDE_ERROR_BOUND = (3.0 + 16.0 * SIDE_EPSILON) * SIDE_EPSILON;
+
+idx_t PolygonEdgeIndex::GetBucket(double y) const {
+	if (bucket_height <= 0) {
+		return 0;
+	}
+	auto bucket = std::floor((y - min_y) / bucket_height);
+	return static_cast<idx_t>(std::max(0.0, std::min(static_cast<double>(bucket_count - 1), bucket)));
+}
+
+bool PolygonEdgeIndex::TryBuild(const geometry_t &geom, idx_t expected_lookups_p) {
+	auto type = geom.GetType();
+	if (type != GeometryType::POLYGON && type != GeometryType::MULTIPOLYGON) {
+		return false;
+	}
+	expected_lookups = expected_lookups_p;
+
+	PolygonEdgeCollector collector(all_edges);
+	collector.Execute(geom);
+
+	edges.clear();
+	bucket_offsets.clear();
+	bucket_count = 0;
+	if (all_edges.empty()) {
+		// Empty polygon, nothing is inside of it
+		return true;
+	}
+
+	min_x = NumericLimits<double>::Maximum();
+	min_y = NumericLimits<double>::Maximum();
+	max_x = -NumericLimits<double>::Maximum();
+	max_y = -NumericLimits<double>::Maximum();
+	for (auto &edge : all_edges) {
+		min_x = std::min(min_x, std::min(edge.x1, edge.x2));
+		min_y = std::min(min_y, std::min(edge.y1, edge.y2));
+		max_x = std::max(max_x, std::max(edge.x1, edge.x2));
+		max_y = std::max(max_y, std::max(edge.y1, edge.y2));
+	}
+
+	bucket_count = 1;
+	if (expected_lookups >= MIN_BUCKETED_LOOKUPS) {
+		bucket_count = MinValue<idx_t>(MAX_BUCKETS, all_edges.size() / EDGES_PER_BUCKET + 1);
+	}
+
+	// Count the edges in each bucket, and use fewer buckets if the edges are too long for them
+	while (true) {
+		bucket_height = (max_y - min_y) / static_cast<double>(bucket_count);
+		bucket_offsets.assign(bucket_count + 1, 0);
+		for (auto &edge : all_edges) {
+			auto first = GetBucket(std::min(edge.y1, edge.y2));
+			auto last = GetBucket(std::max(edge.y1, edge.y2));
+			for (auto bucket = first; bucket <= last; bucket++) {
+				bucket_offsets[bucket + 1]++;
+			}
+		}
+		idx_t total = 0;
+		for (idx_t i = 1; i <= bucket_count; i++) {
+			total += bucket_offsets[i];
+		}
+		if (bucket_count == 1 || total <= MAX_EDGE_COPIES * all_edges.size()) {
+			break;
+		}
+		bucket_count = MaxValue<idx_t>(1, bucket_count / 4);
+	}
+
+	// Turn the counts into offsets, and then put the edges into place
+	for (idx_t i = 1; i <= bucket_count; i++) {
+		bucket_offsets[i] += bucket_offsets[i - 1];
+	}
+	edges.resize(bucket_offsets[bucket_count]);
+	vector<idx_t> positions(bucket_offsets.begin(), bucket_offsets.end() - 1);
+	for (auto &edge : all_edges) {
+		auto first = GetBucket(std::min(edge.y1, edge.y2));
+		auto last = GetBucket(std::max(edge.y1, edge.y2));
+		for (auto bucket = first; bucket <= last; bucket++) {
+			edges[positions[bucket]++] = edge;
+		}
+	}
+	return true;
+}
+
+PolygonEdgeIndex::Location PolygonEdgeIndex::Locate(double x, double y) const {
+	// Written so that NaN ends up outside
+	if (bucket_count == 0 || !(x >= min_x && x <= max_x && y >= min_y && y <= max_y)) {
+		return Location::EXTERIOR;
+	}
+
+	// Every edge whose y range contains the point is in the bucket of the point, count how many of them a ray from
+	// the point towards +x crosses
+	auto bucket = GetBucket(y);
+	bool inside = false;
+	for (auto i = bucket_offsets[bucket]; i < bucket_offsets[bucket + 1]; i++) {
+		auto &edge = edges[i];
+		if (y < std::min(edge.y1, edge.y2) || y > std::max(edge.y1, edge.y2)) {
+			continue;
+		}
+		// Which side of the edge the point is on, positive if it is to the left. If the side is within the rounding
+		// error of the products we can not trust its sign. Unless both products are exactly zero, e.g. for points
+		// on the line through an axis aligned edge
+		auto left = (edge.x2 - edge.x1) * (y - edge.y1);
+		auto right = (edge.y2 - edge.y1) * (x - edge.x1);
+		auto side = left - right;
+		if (std::abs(side) <= SIDE_ERROR_BOUND * (std::abs(left) + std::abs(right)) && (left != 0 || right != 0)) {
+			return Location::UNKNOWN;
+		}
+		if (side == 0) {
+			if (x >= std::min(edge.x1, edge.x2) && x <= std::max(edge.x1, edge.x2)) {
+				return Location::BOUNDARY;
+			}
+			continue;
+		}
+		// The y range of the edge is half open here, so that rays through a vertex are only counted once.
+		// The edge is to the right of the point if the point is on its left going up, or on its right going down
+		if ((edge.y1 > y) != (edge.y2 > y) && (side > 0) == (edge.y2 > edge.y1)) {
+			inside = !inside;
+		}
+	}
+	return inside ? Location::INTERIOR : Location::EXTERIOR;
+}
+
+//------------------------------------------------------------------------------
+// PolygonIndexCache
+//------------------------------------------------------------------------------
+optional_ptr<const PolygonEdgeIndex> PolygonIndexCache::Get(const geometry_t &geom, idx_t lookups) {
+	auto type = geom.GetType();
+	if (type != GeometryType::POLYGON && type != GeometryType::MULTIPOLYGON) {
+		return nullptr;
+	}
+	auto blob = static_cast<string_t>(geom);
+	auto hash = Hash(blob.GetData(), blob.GetSize());
+	clock++;
+
+	optional_ptr<Entry> result;
+	for (auto &entry : entries) {
+		if (entry.hash == hash && entry.blob.size() == blob.GetSize() &&
+		    memcmp(entry.blob.data(), blob.GetData(), blob.GetSize()) == 0) {
+			result = &entry;
+			break;
+		}
+	}
+
+	if (!result) {
+		// Replace the least recently used entry
+		if (entries.size() < CACHE_SIZE) {
+			entries.emplace_back();
+			result = &entries.back();
+		} else {
+			result = &entries[0];
+			for (auto &entry : entries) {
+				if (entry.last_used < result->last_used) {
+					result = &entry;
+				}
+			}
+		}
+		result->blob.assign(blob.GetData(), blob.GetSize());
+		result->hash = hash;
+		result->lookups = lookups;
+		result->index.TryBuild(geom, lookups);
+	} else {
+		result->lookups += lookups;
+		if (result->index.GetExpectedLookups() < PolygonEdgeIndex::MIN_BUCKETED_LOOKUPS &&
+		    result->lookups >= PolygonEdgeIndex::MIN_BUCKETED_LOOKUPS) {
+			// The polygon is used more than we expected when we indexed it
+			result->index.TryBuild(geom, result->lookups);
+		}
+	}
+	result->last_used = clock;
+	return &result->index;
+}
+
+} // namespace core
+
+} // namespace spatial
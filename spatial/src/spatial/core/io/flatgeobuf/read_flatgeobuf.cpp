@@ -0,0 +1,1157 @@
+#include "duckdb/parser/parsed_data/create_table_function_info.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/functions/table.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+
+#include "utf8proc_wrapper.hpp"
+
+#include <algorithm>
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// FlatBuffer Parsing
+//------------------------------------------------------------------------------
+// FlatGeobuf files consist of a header, an optional packed Hilbert R-tree and a sequence of size-prefixed
+// features, where the header and the features are FlatBuffer tables. We dont pull in the FlatBuffers library
+// (or the generated schema code) for this, the few table accessors we need are simple enough to write by hand.
+// All reads are bounds checked, as the files may come from anywhere.
+
+static constexpr uint8_t FGB_MAGIC[] = {'f', 'g', 'b', 3, 'f', 'g', 'b'};
+static constexpr idx_t FGB_MAGIC_SIZE = 8;
+static constexpr idx_t FGB_NODE_ITEM_SIZE = 40;
+
+static void ThrowInvalidFlatGeobuf() {
+	throw InvalidInputException("Invalid FlatGeobuf file: malformed FlatBuffer data");
+}
+
+struct FlatBufferTable {
+	const_data_ptr_t buffer_start = nullptr;
+	const_data_ptr_t buffer_end = nullptr;
+	const_data_ptr_t table = nullptr;
+	const_data_ptr_t vtable = nullptr;
+	uint16_t vtable_size = 0;
+
+	FlatBufferTable() = default;
+
+	FlatBufferTable(const_data_ptr_t buffer_start_p, const_data_ptr_t buffer_end_p, const_data_ptr_t table_p)
+	    : buffer_start(buffer_start_p), buffer_end(buffer_end_p), table(table_p) {
+		Check(table, sizeof(int32_t));
+		vtable = table - Load<int32_t>(table);
+		Check(vtable, 2 * sizeof(uint16_t));
+		vtable_size = Load<uint16_t>(vtable);
+		Check(vtable, vtable_size);
+	}
+
+	// The root table of a (non size-prefixed) FlatBuffer
+	static FlatBufferTable Root(const_data_ptr_t buffer, idx_t size) {
+		if (size < sizeof(uint32_t)) {
+			ThrowInvalidFlatGeobuf();
+		}
+		return FlatBufferTable(buffer, buffer + size, buffer + Load<uint32_t>(buffer));
+	}
+
+	void Check(const_data_ptr_t ptr, idx_t size) const {
+		if (ptr < buffer_start || ptr > buffer_end || size > static_cast<idx_t>(buffer_end - ptr)) {
+			ThrowInvalidFlatGeobuf();
+		}
+	}
+
+	// Returns a pointer to the field data, or nullptr if the field is not present
+	const_data_ptr_t Field(idx_t field_idx) const {
+		auto vtable_offset = 4 + field_idx * sizeof(uint16_t);
+		if (vtable_offset + sizeof(uint16_t) > vtable_size) {
+			return nullptr;
+		}
+		auto field_offset = Load<uint16_t>(vtable + vtable_offset);
+		return field_offset == 0 ? nullptr : table + field_offset;
+	}
+
+	template <class T>
+	T Get(idx_t field_idx, T default_value) const {
+		auto ptr = Field(field_idx);
+		if (!ptr) {
+			return default_value;
+		}
+		Check(ptr, sizeof(T));
+		return Load<T>(ptr);
+	}
+
+	// Follow an offset to a vector, returning a pointer to the first element and setting the element count
+	template <class T>
+	const_data_ptr_t GetVector(idx_t field_idx, uint32_t &count) const {
+		count = 0;
+		auto ptr = Field(field_idx);
+		if (!ptr) {
+			return nullptr;
+		}
+		Check(ptr, sizeof(uint32_t));
+		auto vec = ptr + Load<uint32_t>(ptr);
+		Check(vec, sizeof(uint32_t));
+		count = Load<uint32_t>(vec);
+		Check(vec + sizeof(uint32_t), static_cast<idx_t>(count) * sizeof(T));
+		return vec + sizeof(uint32_t);
+	}
+
+	string GetString(idx_t field_idx) const {
+		uint32_t length;
+		auto ptr = GetVector<char>(field_idx, length);
+		return ptr ? string(const_char_ptr_cast(ptr), length) : string();
+	}
+
+	bool HasField(idx_t field_idx) const {
+		return Field(field_idx) != nullptr;
+	}
+
+	FlatBufferTable GetTable(idx_t field_idx) const {
+		auto ptr = Field(field_idx);
+		Check(ptr, sizeof(uint32_t));
+		return FlatBufferTable(buffer_start, buffer_end, ptr + Load<uint32_t>(ptr));
+	}
+
+	// Get a table from a vector of tables
+	FlatBufferTable GetTableElement(const_data_ptr_t vector_data, uint32_t element_idx) const {
+		auto ptr = vector_data + element_idx * sizeof(uint32_t);
+		return FlatBufferTable(buffer_start, buffer_end, ptr + Load<uint32_t>(ptr));
+	}
+};
+
+// Field indices of the FlatGeobuf schema tables
+enum class FgbHeaderField : idx_t {
+	NAME = 0,
+	ENVELOPE = 1,
+	GEOMETRY_TYPE = 2,
+	HAS_Z = 3,
+	HAS_M = 4,
+	COLUMNS = 7,
+	FEATURES_COUNT = 8,
+	INDEX_NODE_SIZE = 9,
+};
+
+enum class FgbColumnField : idx_t { NAME = 0, TYPE = 1 };
+
+enum class FgbFeatureField : idx_t { GEOMETRY = 0, PROPERTIES = 1 };
+
+enum class FgbGeometryField : idx_t { ENDS = 0, XY = 1, Z = 2, M = 3, TYPE = 6, PARTS = 7 };
+
+enum class FgbGeometryType : uint8_t {
+	UNKNOWN = 0,
+	POINT = 1,
+	LINESTRING = 2,
+	POLYGON = 3,
+	MULTIPOINT = 4,
+	MULTILINESTRING = 5,
+	MULTIPOLYGON = 6,
+	GEOMETRYCOLLECTION = 7,
+};
+
+enum class FgbColumnType : uint8_t {
+	BYTE = 0,
+	UBYTE = 1,
+	BOOL = 2,
+	SHORT = 3,
+	USHORT = 4,
+	INT = 5,
+	UINT = 6,
+	LONG = 7,
+	ULONG = 8,
+	FLOAT = 9,
+	DOUBLE = 10,
+	STRING = 11,
+	JSON = 12,
+	DATETIME = 13,
+	BINARY = 14,
+};
+
+static LogicalType FgbColumnTypeToLogicalType(FgbColumnType type) {
+	switch (type) {
+	case FgbColumnType::BYTE:
+		return LogicalType::TINYINT;
+	case FgbColumnType::UBYTE:
+		return LogicalType::UTINYINT;
+	case FgbColumnType::BOOL:
+		return LogicalType::BOOLEAN;
+	case FgbColumnType::SHORT:
+		return LogicalType::SMALLINT;
+	case FgbColumnType::USHORT:
+		return LogicalType::USMALLINT;
+	case FgbColumnType::INT:
+		return LogicalType::INTEGER;
+	case FgbColumnType::UINT:
+		return LogicalType::UINTEGER;
+	case FgbColumnType::LONG:
+		return LogicalType::BIGINT;
+	case FgbColumnType::ULONG:
+		return LogicalType::UBIGINT;
+	case FgbColumnType::FLOAT:
+		return LogicalType::FLOAT;
+	case FgbColumnType::DOUBLE:
+		return LogicalType::DOUBLE;
+	case FgbColumnType::STRING:
+	case FgbColumnType::JSON:
+		return LogicalType::VARCHAR;
+	case FgbColumnType::DATETIME:
+		return LogicalType::TIMESTAMP;
+	case FgbColumnType::BINARY:
+		return LogicalType::BLOB;
+	default:
+		throw InvalidInputException("Invalid FlatGeobuf file: unknown column type %d", static_cast<int>(type));
+	}
+}
+
+// The size of a fixed size property value, or 0 if the value is prefixed by its length
+static idx_t FgbColumnTypeSize(FgbColumnType type) {
+	switch (type) {
+	case FgbColumnType::BYTE:
+	case FgbColumnType::UBYTE:
+	case FgbColumnType::BOOL:
+		return 1;
+	case FgbColumnType::SHORT:
+	case FgbColumnType::USHORT:
+		return 2;
+	case FgbColumnType::INT:
+	case FgbColumnType::UINT:
+	case FgbColumnType::FLOAT:
+		return 4;
+	case FgbColumnType::LONG:
+	case FgbColumnType::ULONG:
+	case FgbColumnType::DOUBLE:
+		return 8;
+	default:
+		return 0;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Packed Hilbert R-Tree
+//------------------------------------------------------------------------------
+// The index is stored level by level, from the root down to the leaves. Every leaf node corresponds to
+// a feature (in file order) and stores its byte offset in the feature section, while internal nodes store
+// the index of their first child node.
+
+struct PackedRTree {
+	// The [start, end) node indices of each level, from the leaves (level 0) up to the root
+	vector<pair<idx_t, idx_t>> level_bounds;
+	idx_t node_count = 0;
+
+	PackedRTree() = default;
+
+	PackedRTree(idx_t item_count, idx_t node_size) {
+		if (item_count == 0 || node_size < 2) {
+			return;
+		}
+		vector<idx_t> level_node_counts;
+		auto n = item_count;
+		node_count = n;
+		level_node_counts.push_back(n);
+		do {
+			n = (n + node_size - 1) / node_size;
+			node_count += n;
+			level_node_counts.push_back(n);
+		} while (n != 1);
+
+		n = node_count;
+		for (auto level_node_count : level_node_counts) {
+			level_bounds.emplace_back(n - level_node_count, n);
+			n -= level_node_count;
+		}
+	}
+
+	idx_t ByteSize() const {
+		return node_count * FGB_NODE_ITEM_SIZE;
+	}
+
+	idx_t LeafStart() const {
+		return level_bounds[0].first;
+	}
+};
+
+struct FgbNodeItem {
+	double min_x;
+	double min_y;
+	double max_x;
+	double max_y;
+	uint64_t offset;
+
+	static FgbNodeItem Load(const_data_ptr_t ptr) {
+		return {duckdb::Load<double>(ptr), duckdb::Load<double>(ptr + 8), duckdb::Load<double>(ptr + 16),
+		        duckdb::Load<double>(ptr + 24), duckdb::Load<uint64_t>(ptr + 32)};
+	}
+};
+
+//------------------------------------------------------------------------------
+// Bind
+//------------------------------------------------------------------------------
+
+struct FgbColumn {
+	string name;
+	FgbColumnType type;
+};
+
+struct FlatGeobufBindData : TableFunctionData {
+	string file_name;
+	idx_t file_size = 0;
+	FgbGeometryType geometry_type = FgbGeometryType::UNKNOWN;
+	bool has_z = false;
+	bool has_m = false;
+	vector<FgbColumn> columns;
+	idx_t features_count = 0;
+	idx_t index_node_size = 0;
+	// The file offsets of the index and the feature section
+	idx_t index_offset = 0;
+	idx_t features_offset = 0;
+	PackedRTree tree;
+
+	bool has_spatial_filter = false;
+	double filter_min_x = 0;
+	double filter_min_y = 0;
+	double filter_max_x = 0;
+	double filter_max_y = 0;
+
+	explicit FlatGeobufBindData(string file_name_p) : file_name(std::move(file_name_p)) {
+	}
+
+	bool HasIndex() const {
+		return index_node_size > 0 && features_count > 0;
+	}
+
+	bool IntersectsFilter(double min_x, double min_y, double max_x, double max_y) const {
+		return !(min_x > filter_max_x || max_x < filter_min_x || min_y > filter_max_y || max_y < filter_min_y);
+	}
+};
+
+static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindInput &input,
+                                     vector<LogicalType> &return_types, vector<string> &names) {
+
+	auto file_name = StringValue::Get(input.inputs[0]);
+	auto result = make_uniq<FlatGeobufBindData>(file_name);
+
+	for (auto &kv : input.named_parameters) {
+		if (kv.first == "spatial_filter_box") {
+			auto &children = StructValue::GetChildren(kv.second);
+			result->has_spatial_filter = true;
+			result->filter_min_x = children[0].GetValue<double>();
+			result->filter_min_y = children[1].GetValue<double>();
+			result->filter_max_x = children[2].GetValue<double>();
+			result->filter_max_y = children[3].GetValue<double>();
+		}
+	}
+
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto handle = fs.OpenFile(file_name, FileFlags::FILE_FLAGS_READ);
+	result->file_size = handle->GetFileSize();
+
+	// Check the magic bytes, we only support version 3 files
+	data_t prefix[FGB_MAGIC_SIZE + sizeof(uint32_t)];
+	if (result->file_size < sizeof(prefix)) {
+		throw InvalidInputException("Invalid FlatGeobuf file: '%s' is too small", file_name);
+	}
+	handle->Read(prefix, sizeof(prefix), 0);
+	if (memcmp(prefix, FGB_MAGIC, sizeof(FGB_MAGIC)) != 0) {
+		throw InvalidInputException("Invalid FlatGeobuf file: '%s' does not start with the FlatGeobuf v3 magic bytes",
+		                            file_name);
+	}
+
+	// Read the header
+	auto header_size = Load<uint32_t>(prefix + FGB_MAGIC_SIZE);
+	if (header_size > result->file_size - sizeof(prefix)) {
+		throw InvalidInputException("Invalid FlatGeobuf file: '%s' has a truncated header", file_name);
+	}
+	auto header_buffer = make_unsafe_uniq_array<data_t>(header_size);
+	handle->Read(header_buffer.get(), header_size, sizeof(prefix));
+	auto header = FlatBufferTable::Root(header_buffer.get(), header_size);
+
+	result->geometry_type = static_cast<FgbGeometryType>(
+	    header.Get<uint8_t>(static_cast<idx_t>(FgbHeaderField::GEOMETRY_TYPE), 0));
+	if (result->geometry_type > FgbGeometryType::GEOMETRYCOLLECTION) {
+		throw NotImplementedException("FlatGeobuf geometry type %d is not supported",
+		                              static_cast<int>(result->geometry_type));
+	}
+	result->has_z = header.Get<uint8_t>(static_cast<idx_t>(FgbHeaderField::HAS_Z), 0) != 0;
+	result->has_m = header.Get<uint8_t>(static_cast<idx_t>(FgbHeaderField::HAS_M), 0) != 0;
+	result->features_count = header.Get<uint64_t>(static_cast<idx_t>(FgbHeaderField::FEATURES_COUNT), 0);
+	result->index_node_size = header.Get<uint16_t>(static_cast<idx_t>(FgbHeaderField::INDEX_NODE_SIZE), 16);
+	if (result->index_node_size == 1) {
+		// A node size of 0 means there is no index, but a tree needs at least two items per node
+		throw InvalidInputException("Invalid FlatGeobuf file: '%s' has an index node size of 1", file_name);
+	}
+
+	uint32_t column_count;
+	auto columns = header.GetVector<uint32_t>(static_cast<idx_t>(FgbHeaderField::COLUMNS), column_count);
+	for (uint32_t i = 0; i < column_count; i++) {
+		auto column = header.GetTableElement(columns, i);
+		FgbColumn fgb_column;
+		fgb_column.name = column.GetString(static_cast<idx_t>(FgbColumnField::NAME));
+		fgb_column.type = static_cast<FgbColumnType>(column.Get<uint8_t>(static_cast<idx_t>(FgbColumnField::TYPE), 0));
+		names.push_back(fgb_column.name);
+		return_types.push_back(FgbColumnTypeToLogicalType(fgb_column.type));
+		result->columns.push_back(std::move(fgb_column));
+	}
+
+	// The geometry is always last
+	names.push_back("geom");
+	return_types.push_back(GeoTypes::GEOMETRY());
+
+	// Locate the index and the features
+	result->index_offset = sizeof(prefix) + header_size;
+	result->features_offset = result->index_offset;
+	if (result->HasIndex()) {
+		result->tree = PackedRTree(result->features_count, result->index_node_size);
+		result->features_offset += result->tree.ByteSize();
+		if (result->features_offset > result->file_size) {
+			throw InvalidInputException("Invalid FlatGeobuf file: '%s' has a truncated index", file_name);
+		}
+	}
+
+	return std::move(result);
+}
+
+//------------------------------------------------------------------------------
+// Init Global
+//------------------------------------------------------------------------------
+
+// The location of a single feature (without its size prefix) in the file
+struct FgbFeatureEntry {
+	idx_t feature_idx;
+	idx_t offset;
+	idx_t size;
+};
+
+struct FlatGeobufGlobalState : public GlobalTableFunctionState {
+	mutex lock;
+	idx_t max_threads;
+	idx_t batch_idx = 0;
+	atomic<idx_t> features_read;
+	vector<idx_t> column_ids;
+
+	// When the file has an index and we are not filtering, batches are ranges of feature indices, and
+	// every thread looks up the feature offsets of its batch in the leaf nodes of the index.
+	idx_t next_feature_idx = 0;
+
+	// When filtering on an indexed file, the features found by searching the index
+	bool is_search = false;
+	vector<FgbFeatureEntry> search_results;
+
+	// Without an index we have to walk the size prefixes of the features one by one
+	unique_ptr<FileHandle> handle;
+	idx_t next_offset = 0;
+	AllocatedData prefix_buffer;
+	idx_t prefix_buffer_offset = 0;
+	idx_t prefix_buffer_size = 0;
+
+	FlatGeobufGlobalState(idx_t max_threads_p, vector<idx_t> column_ids_p)
+	    : max_threads(max_threads_p), features_read(0), column_ids(std::move(column_ids_p)) {
+	}
+
+	idx_t MaxThreads() const override {
+		return max_threads;
+	}
+};
+
+// Search the index for all features whose bounding box intersects the filter box
+static vector<FgbFeatureEntry> SearchIndex(const FlatGeobufBindData &bind_data, FileHandle &handle) {
+	auto &tree = bind_data.tree;
+	auto node_size = bind_data.index_node_size;
+	auto features_size = bind_data.file_size - bind_data.features_offset;
+
+	vector<FgbFeatureEntry> results;
+	vector<data_t> nodes;
+	// (node index, level) pairs still to visit
+	vector<pair<idx_t, idx_t>> queue;
+	queue.emplace_back(0, tree.level_bounds.size() - 1);
+
+	while (!queue.empty()) {
+		auto node_idx = queue.back().first;
+		auto level = queue.back().second;
+		queue.pop_back();
+
+		auto level_end = tree.level_bounds[level].second;
+		auto node_end = MinValue<idx_t>(node_idx + node_size, level_end);
+		if (node_idx >= node_end) {
+			throw InvalidInputException("Invalid FlatGeobuf file: corrupt index");
+		}
+		// For leaves also read the next item, so that we know where the last feature ends
+		auto read_end = level == 0 ? MinValue<idx_t>(node_end + 1, level_end) : node_end;
+		nodes.resize((read_end - node_idx) * FGB_NODE_ITEM_SIZE);
+		handle.Read(nodes.data(), nodes.size(), bind_data.index_offset + node_idx * FGB_NODE_ITEM_SIZE);
+
+		for (auto pos = node_idx; pos < node_end; pos++) {
+			auto item = FgbNodeItem::Load(nodes.data() + (pos - node_idx) * FGB_NODE_ITEM_SIZE);
+			if (!bind_data.IntersectsFilter(item.min_x, item.min_y, item.max_x, item.max_y)) {
+				continue;
+			}
+			if (level == 0) {
+				auto end = pos + 1 < read_end
+				               ? FgbNodeItem::Load(nodes.data() + (pos + 1 - node_idx) * FGB_NODE_ITEM_SIZE).offset
+				               : features_size;
+				if (item.offset + sizeof(uint32_t) > end || end > features_size) {
+					throw InvalidInputException("Invalid FlatGeobuf file: corrupt index");
+				}
+				results.push_back({pos - tree.LeafStart(), bind_data.features_offset + item.offset + sizeof(uint32_t),
+				                   end - item.offset - sizeof(uint32_t)});
+			} else {
+				if (level == 0 || item.offset < tree.level_bounds[level - 1].first ||
+				    item.offset >= tree.level_bounds[level - 1].second) {
+					throw InvalidInputException("Invalid FlatGeobuf file: corrupt index");
+				}
+				queue.emplace_back(item.offset, level - 1);
+			}
+		}
+	}
+
+	// Return the features in file order
+	std::sort(results.begin(), results.end(),
+	          [](const FgbFeatureEntry &a, const FgbFeatureEntry &b) { return a.feature_idx < b.feature_idx; });
+	return results;
+}
+
+static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext &context, TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<FlatGeobufBindData>();
+	auto &fs = FileSystem::GetFileSystem(context);
+
+	auto threads = context.db->NumberOfThreads();
+	if (!bind_data.HasIndex()) {
+		// Without an index we can only find the features one after another
+		auto result = make_uniq<FlatGeobufGlobalState>(1, input.column_ids);
+		result->handle = fs.OpenFile(bind_data.file_name, FileFlags::FILE_FLAGS_READ);
+		result->next_offset = bind_data.features_offset;
+		return std::move(result);
+	}
+
+	if (bind_data.has_spatial_filter) {
+		auto handle = fs.OpenFile(bind_data.file_name, FileFlags::FILE_FLAGS_READ);
+		auto search_results = SearchIndex(bind_data, *handle);
+		auto batch_count = (search_results.size() + STANDARD_VECTOR_SIZE - 1) / STANDARD_VECTOR_SIZE;
+		auto result =
+		    make_uniq<FlatGeobufGlobalState>(MinValue<idx_t>(threads, MaxValue<idx_t>(batch_count, 1)), input.column_ids);
+		result->is_search = true;
+		result->search_results = std::move(search_results);
+		return std::move(result);
+	}
+
+	auto batch_count = (bind_data.features_count + STANDARD_VECTOR_SIZE - 1) / STANDARD_VECTOR_SIZE;
+	auto result =
+	    make_uniq<FlatGeobufGlobalState>(MinValue<idx_t>(threads, MaxValue<idx_t>(batch_count, 1)), input.column_ids);
+	return std::move(result);
+}
+
+//------------------------------------------------------------------------------
+// Init Local
+//------------------------------------------------------------------------------
+
+struct FlatGeobufLocalState : public LocalTableFunctionState {
+	Allocator &allocator;
+	GeometryFactory factory;
+	unique_ptr<FileHandle> handle;
+	idx_t batch_idx = 0;
+	// The features of the current batch
+	vector<FgbFeatureEntry> entries;
+	// Scratch space for reading the leaf nodes of the index
+	vector<data_t> node_buffer;
+	// The raw features of the current batch, and the position of each feature in the buffer
+	AllocatedData feature_buffer;
+	vector<idx_t> feature_positions;
+
+	FlatGeobufLocalState(ClientContext &context, const FlatGeobufBindData &bind_data)
+	    : allocator(BufferAllocator::Get(context)), factory(BufferAllocator::Get(context)) {
+		auto &fs = FileSystem::GetFileSystem(context);
+		handle = fs.OpenFile(bind_data.file_name, FileFlags::FILE_FLAGS_READ);
+	}
+
+	void ReserveFeatureBuffer(idx_t size) {
+		if (feature_buffer.GetSize() < size) {
+			feature_buffer = allocator.Allocate(MaxValue<idx_t>(size, feature_buffer.GetSize() * 2));
+		}
+	}
+};
+
+static unique_ptr<LocalTableFunctionState> InitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+                                                     GlobalTableFunctionState *global_state) {
+	auto &bind_data = input.bind_data->Cast<FlatGeobufBindData>();
+	return make_uniq<FlatGeobufLocalState>(context.client, bind_data);
+}
+
+//------------------------------------------------------------------------------
+// Batches
+//------------------------------------------------------------------------------
+
+// Read the size prefix at the given offset when walking an unindexed file, buffering the reads
+static uint32_t ReadSizePrefix(const FlatGeobufBindData &bind_data, FlatGeobufGlobalState &gstate, idx_t offset) {
+	static constexpr idx_t PREFIX_BUFFER_SIZE = 1024 * 1024;
+	if (offset < gstate.prefix_buffer_offset ||
+	    offset + sizeof(uint32_t) > gstate.prefix_buffer_offset + gstate.prefix_buffer_size) {
+		if (!gstate.prefix_buffer.get()) {
+			gstate.prefix_buffer = Allocator::DefaultAllocator().Allocate(PREFIX_BUFFER_SIZE);
+		}
+		gstate.prefix_buffer_offset = offset;
+		gstate.prefix_buffer_size = MinValue<idx_t>(PREFIX_BUFFER_SIZE, bind_data.file_size - offset);
+		gstate.handle->Read(gstate.prefix_buffer.get(), gstate.prefix_buffer_size, offset);
+	}
+	return Load<uint32_t>(gstate.prefix_buffer.get() + (offset - gstate.prefix_buffer_offset));
+}
+
+// Claim the next batch of features, returns false if there are no features left
+static bool GetNextBatch(const FlatGeobufBindData &bind_data, FlatGeobufGlobalState &gstate,
+                         FlatGeobufLocalState &lstate) {
+	auto &entries = lstate.entries;
+	entries.clear();
+
+	if (!bind_data.HasIndex()) {
+		lock_guard<mutex> glock(gstate.lock);
+		while (entries.size() < STANDARD_VECTOR_SIZE && gstate.next_offset + sizeof(uint32_t) <= bind_data.file_size) {
+			auto size = ReadSizePrefix(bind_data, gstate, gstate.next_offset);
+			auto offset = gstate.next_offset + sizeof(uint32_t);
+			if (size > bind_data.file_size - offset) {
+				throw InvalidInputException("Invalid FlatGeobuf file: feature %llu is truncated",
+				                            gstate.next_feature_idx);
+			}
+			entries.push_back({gstate.next_feature_idx++, offset, size});
+			gstate.next_offset = offset + size;
+		}
+		if (entries.empty()) {
+			return false;
+		}
+		lstate.batch_idx = gstate.batch_idx++;
+		return true;
+	}
+
+	if (gstate.is_search) {
+		lock_guard<mutex> glock(gstate.lock);
+		auto start = gstate.next_feature_idx;
+		if (start >= gstate.search_results.size()) {
+			return false;
+		}
+		auto count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, gstate.search_results.size() - start);
+		entries.assign(gstate.search_results.begin() + start, gstate.search_results.begin() + start + count);
+		gstate.next_feature_idx += count;
+		lstate.batch_idx = gstate.batch_idx++;
+		return true;
+	}
+
+	idx_t start;
+	idx_t count;
+	{
+		lock_guard<mutex> glock(gstate.lock);
+		start = gstate.next_feature_idx;
+		if (start >= bind_data.features_count) {
+			return false;
+		}
+		count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, bind_data.features_count - start);
+		gstate.next_feature_idx += count;
+		lstate.batch_idx = gstate.batch_idx++;
+	}
+
+	// Look up the offsets of the features in the leaf nodes. Also read the leaf after the batch (if any),
+	// which tells us where the last feature in the batch ends.
+	auto read_count = start + count < bind_data.features_count ? count + 1 : count;
+	auto &nodes = lstate.node_buffer;
+	nodes.resize(read_count * FGB_NODE_ITEM_SIZE);
+	lstate.handle->Read(nodes.data(), nodes.size(),
+	                    bind_data.index_offset + (bind_data.tree.LeafStart() + start) * FGB_NODE_ITEM_SIZE);
+
+	auto features_size = bind_data.file_size - bind_data.features_offset;
+	for (idx_t i = 0; i < count; i++) {
+		auto offset = Load<uint64_t>(nodes.data() + i * FGB_NODE_ITEM_SIZE + 32);
+		auto end = i + 1 < read_count ? Load<uint64_t>(nodes.data() + (i + 1) * FGB_NODE_ITEM_SIZE + 32) : features_size;
+		if (offset + sizeof(uint32_t) > end || end > features_size) {
+			throw InvalidInputException("Invalid FlatGeobuf file: corrupt index");
+		}
+		entries.push_back(
+		    {start + i, bind_data.features_offset + offset + sizeof(uint32_t), end - offset - sizeof(uint32_t)});
+	}
+	return true;
+}
+
+// Read the features of the current batch, features that are close to each other are read in one go
+static void ReadFeatures(FlatGeobufLocalState &lstate) {
+	static constexpr idx_t MAX_GAP = 64 * 1024;
+
+	auto &entries = lstate.entries;
+	auto &positions = lstate.feature_positions;
+	positions.resize(entries.size());
+
+	// Lay out the features back to back in the buffer
+	idx_t total_size = 0;
+	for (idx_t i = 0; i < entries.size(); i++) {
+		positions[i] = total_size;
+		total_size += entries[i].size;
+	}
+
+	// Split the features into runs that we can read at once, runs that contain gaps are read into scratch
+	// space after the features and then moved into place
+	vector<pair<idx_t, idx_t>> runs;
+	idx_t scratch_size = 0;
+	idx_t run_start = 0;
+	while (run_start < entries.size()) {
+		auto run_end = run_start + 1;
+		while (run_end < entries.size()) {
+			auto prev_end = entries[run_end - 1].offset + entries[run_end - 1].size;
+			if (entries[run_end].offset < prev_end || entries[run_end].offset - prev_end > MAX_GAP) {
+				break;
+			}
+			run_end++;
+		}
+		auto span_size = entries[run_end - 1].offset + entries[run_end - 1].size - entries[run_start].offset;
+		auto features_size = positions[run_end - 1] + entries[run_end - 1].size - positions[run_start];
+		if (span_size != features_size) {
+			scratch_size = MaxValue<idx_t>(scratch_size, span_size);
+		}
+		runs.emplace_back(run_start, run_end);
+		run_start = run_end;
+	}
+
+	lstate.ReserveFeatureBuffer(total_size + scratch_size);
+	auto buffer = lstate.feature_buffer.get();
+	auto scratch = buffer + total_size;
+
+	for (auto &run : runs) {
+		auto span_start = entries[run.first].offset;
+		auto span_size = entries[run.second - 1].offset + entries[run.second - 1].size - span_start;
+		auto features_size = positions[run.second - 1] + entries[run.second - 1].size - positions[run.first];
+		if (span_size == features_size) {
+			// No gaps, read straight into place
+			lstate.handle->Read(buffer + positions[run.first], span_size, span_start);
+			continue;
+		}
+		lstate.handle->Read(scratch, span_size, span_start);
+		for (auto i = run.first; i < run.second; i++) {
+			memcpy(buffer + positions[i], scratch + (entries[i].offset - span_start), entries[i].size);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// Geometry Conversion
+//------------------------------------------------------------------------------
+
+struct FgbGeometryData {
+	const FlatBufferTable &table;
+	const_data_ptr_t xy;
+	const_data_ptr_t z;
+	const_data_ptr_t m;
+	const_data_ptr_t ends;
+	uint32_t vertex_count;
+	uint32_t ends_count;
+
+	FgbGeometryData(const FlatBufferTable &table_p, bool has_z, bool has_m) : table(table_p) {
+		uint32_t xy_count;
+		xy = table.GetVector<double>(static_cast<idx_t>(FgbGeometryField::XY), xy_count);
+		vertex_count = xy_count / 2;
+		uint32_t z_count = 0;
+		uint32_t m_count = 0;
+		z = has_z ? table.GetVector<double>(static_cast<idx_t>(FgbGeometryField::Z), z_count) : nullptr;
+		m = has_m ? table.GetVector<double>(static_cast<idx_t>(FgbGeometryField::M), m_count) : nullptr;
+		if ((has_z && z_count < vertex_count) || (has_m && m_count < vertex_count)) {
+			ThrowInvalidFlatGeobuf();
+		}
+		ends = table.GetVector<uint32_t>(static_cast<idx_t>(FgbGeometryField::ENDS), ends_count);
+	}
+
+	VertexArray ReadVertices(ArenaAllocator &arena, uint32_t start, uint32_t count, bool has_z, bool has_m) const {
+		if (start > vertex_count || count > vertex_count - start) {
+			ThrowInvalidFlatGeobuf();
+		}
+		if (!has_z && !has_m) {
+			// The XY vertex layout is the same as ours
+			return VertexArray::Copy(arena, xy + start * 2 * sizeof(double), count, false, false);
+		}
+		auto vertices = VertexArray::Create(arena, count, has_z, has_m);
+		for (uint32_t i = 0; i < count; i++) {
+			auto idx = start + i;
+			auto x = Load<double>(xy + idx * 2 * sizeof(double));
+			auto y = Load<double>(xy + idx * 2 * sizeof(double) + sizeof(double));
+			auto zv = has_z ? Load<double>(z + idx * sizeof(double)) : 0;
+			auto mv = has_m ? Load<double>(m + idx * sizeof(double)) : 0;
+			vertices.Set(i, x, y, zv, mv);
+		}
+		return vertices;
+	}
+
+	// The number of parts (rings or lines) and their vertex ranges, a geometry without ends has a single part
+	uint32_t PartCount() const {
+		return ends_count == 0 ? 1 : ends_count;
+	}
+
+	void PartRange(uint32_t part_idx, uint32_t &start, uint32_t &count) const {
+		if (ends_count == 0) {
+			start = 0;
+			count = vertex_count;
+			return;
+		}
+		start = part_idx == 0 ? 0 : Load<uint32_t>(ends + (part_idx - 1) * sizeof(uint32_t));
+		auto end = Load<uint32_t>(ends + part_idx * sizeof(uint32_t));
+		if (end < start || end > vertex_count) {
+			ThrowInvalidFlatGeobuf();
+		}
+		count = end - start;
+	}
+};
+
+static Polygon ReadPolygon(const FgbGeometryData &data, ArenaAllocator &arena, bool has_z, bool has_m) {
+	if (data.vertex_count == 0) {
+		return Polygon(has_z, has_m);
+	}
+	Polygon polygon(arena, data.PartCount(), has_z, has_m);
+	for (uint32_t i = 0; i < data.PartCount(); i++) {
+		uint32_t start, count;
+		data.PartRange(i, start, count);
+		polygon[i] = data.ReadVertices(arena, start, count, has_z, has_m);
+	}
+	return polygon;
+}
+
+static Geometry ReadGeometry(const FlatBufferTable &table, FgbGeometryType type, ArenaAllocator &arena, bool has_z,
+                             bool has_m, idx_t depth = 0) {
+	if (depth > 64) {
+		throw InvalidInputException("Invalid FlatGeobuf file: geometry is nested too deeply");
+	}
+	if (type == FgbGeometryType::UNKNOWN) {
+		type = static_cast<FgbGeometryType>(table.Get<uint8_t>(static_cast<idx_t>(FgbGeometryField::TYPE), 0));
+	}
+	FgbGeometryData data(table, has_z, has_m);
+
+	switch (type) {
+	case FgbGeometryType::POINT: {
+		if (data.vertex_count == 0) {
+			return Point(has_z, has_m);
+		}
+		return Point(data.ReadVertices(arena, 0, 1, has_z, has_m));
+	}
+	case FgbGeometryType::LINESTRING:
+		return LineString(data.ReadVertices(arena, 0, data.vertex_count, has_z, has_m));
+	case FgbGeometryType::POLYGON:
+		return ReadPolygon(data, arena, has_z, has_m);
+	case FgbGeometryType::MULTIPOINT: {
+		MultiPoint multi_point(arena, data.vertex_count, has_z, has_m);
+		for (uint32_t i = 0; i < data.vertex_count; i++) {
+			multi_point[i] = Point(data.ReadVertices(arena, i, 1, has_z, has_m));
+		}
+		return multi_point;
+	}
+	case FgbGeometryType::MULTILINESTRING: {
+		if (data.vertex_count == 0) {
+			return MultiLineString(has_z, has_m);
+		}
+		MultiLineString multi_line_string(arena, data.PartCount(), has_z, has_m);
+		for (uint32_t i = 0; i < data.PartCount(); i++) {
+			uint32_t start, count;
+			data.PartRange(i, start, count);
+			multi_line_string[i] = LineString(data.ReadVertices(arena, start, count, has_z, has_m));
+		}
+		return multi_line_string;
+	}
+	case FgbGeometryType::MULTIPOLYGON: {
+		uint32_t part_count;
+		auto parts = table.GetVector<uint32_t>(static_cast<idx_t>(FgbGeometryField::PARTS), part_count);
+		MultiPolygon multi_polygon(arena, part_count, has_z, has_m);
+		for (uint32_t i = 0; i < part_count; i++) {
+			auto part = table.GetTableElement(parts, i);
+			multi_polygon[i] = ReadPolygon(FgbGeometryData(part, has_z, has_m), arena, has_z, has_m);
+		}
+		return multi_polygon;
+	}
+	case FgbGeometryType::GEOMETRYCOLLECTION: {
+		uint32_t part_count;
+		auto parts = table.GetVector<uint32_t>(static_cast<idx_t>(FgbGeometryField::PARTS), part_count);
+		GeometryCollection collection(arena, part_count, has_z, has_m);
+		for (uint32_t i = 0; i < part_count; i++) {
+			auto part = table.GetTableElement(parts, i);
+			collection[i] = ReadGeometry(part, FgbGeometryType::UNKNOWN, arena, has_z, has_m, depth + 1);
+		}
+		return collection;
+	}
+	default:
+		throw NotImplementedException("FlatGeobuf geometry type %d is not supported", static_cast<int>(type));
+	}
+}
+
+// Compute the bounding box of the raw vertices of a geometry (and its parts)
+static void GetGeometryBounds(const FlatBufferTable &table, BoundingBox &bbox, idx_t depth = 0) {
+	if (depth > 64) {
+		throw InvalidInputException("Invalid FlatGeobuf file: geometry is nested too deeply");
+	}
+	uint32_t xy_count;
+	auto xy = table.GetVector<double>(static_cast<idx_t>(FgbGeometryField::XY), xy_count);
+	for (uint32_t i = 0; i + 1 < xy_count; i += 2) {
+		auto x = Load<double>(xy + i * sizeof(double));
+		auto y = Load<double>(xy + (i + 1) * sizeof(double));
+		bbox.minx = std::min(bbox.minx, x);
+		bbox.miny = std::min(bbox.miny, y);
+		bbox.maxx = std::max(bbox.maxx, x);
+		bbox.maxy = std::max(bbox.maxy, y);
+	}
+	uint32_t part_count;
+	auto parts = table.GetVector<uint32_t>(static_cast<idx_t>(FgbGeometryField::PARTS), part_count);
+	for (uint32_t i = 0; i < part_count; i++) {
+		GetGeometryBounds(table.GetTableElement(parts, i), bbox, depth + 1);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Attribute Conversion
+//------------------------------------------------------------------------------
+
+template <class T>
+static void SetPropertyValue(Vector &vec, idx_t row_idx, const_data_ptr_t value) {
+	FlatVector::GetData<T>(vec)[row_idx] = Load<T>(value);
+}
+
+static void SetStringProperty(Vector &vec, idx_t row_idx, const_data_ptr_t value, uint32_t length, idx_t feature_idx) {
+	auto str = const_char_ptr_cast(value);
+	if (Utf8Proc::Analyze(str, length) == UnicodeType::INVALID) {
+		throw InvalidInputException("Invalid FlatGeobuf file: feature %llu contains a string that is not valid UTF-8",
+		                            feature_idx);
+	}
+	FlatVector::GetData<string_t>(vec)[row_idx] = StringVector::AddString(vec, str, length);
+}
+
+// Decode the properties of a feature into the output vectors. Properties are stored as a sequence of
+// (column index, value) pairs, missing properties are NULL.
+static void ReadProperties(const FlatGeobufBindData &bind_data, const FlatBufferTable &feature,
+                           const vector<optional_ptr<Vector>> &column_vectors, idx_t row_idx, idx_t feature_idx) {
+	for (auto &vec : column_vectors) {
+		if (vec) {
+			FlatVector::SetNull(*vec, row_idx, true);
+		}
+	}
+
+	uint32_t length;
+	auto properties = feature.GetVector<uint8_t>(static_cast<idx_t>(FgbFeatureField::PROPERTIES), length);
+	idx_t pos = 0;
+	while (pos + sizeof(uint16_t) <= length) {
+		auto column_idx = Load<uint16_t>(properties + pos);
+		pos += sizeof(uint16_t);
+		if (column_idx >= bind_data.columns.size()) {
+			ThrowInvalidFlatGeobuf();
+		}
+		auto type = bind_data.columns[column_idx].type;
+
+		// Find the size of the value
+		auto value_size = FgbColumnTypeSize(type);
+		auto value = properties + pos;
+		if (value_size == 0) {
+			if (pos + sizeof(uint32_t) > length) {
+				ThrowInvalidFlatGeobuf();
+			}
+			value_size = Load<uint32_t>(value);
+			value += sizeof(uint32_t);
+			pos += sizeof(uint32_t);
+		}
+		if (value_size > length - pos) {
+			ThrowInvalidFlatGeobuf();
+		}
+		pos += value_size;
+
+		auto &vec = column_vectors[column_idx];
+		if (!vec) {
+			// Not projected
+			continue;
+		}
+		FlatVector::Validity(*vec).SetValid(row_idx);
+
+		switch (type) {
+		case FgbColumnType::BYTE:
+			SetPropertyValue<int8_t>(*vec, row_idx, value);
+			break;
+		case FgbColumnType::UBYTE:
+			SetPropertyValue<uint8_t>(*vec, row_idx, value);
+			break;
+		case FgbColumnType::BOOL:
+			FlatVector::GetData<bool>(*vec)[row_idx] = *value != 0;
+			break;
+		case FgbColumnType::SHORT:
+			SetPropertyValue<int16_t>(*vec, row_idx, value);
+			break;
+		case FgbColumnType::USHORT:
+			SetPropertyValue<uint16_t>(*vec, row_idx, value);
+			break;
+		case FgbColumnType::INT:
+			SetPropertyValue<int32_t>(*vec, row_idx, value);
+			break;
+		case FgbColumnType::UINT:
+			SetPropertyValue<uint32_t>(*vec, row_idx, value);
+			break;
+		case FgbColumnType::LONG:
+			SetPropertyValue<int64_t>(*vec, row_idx, value);
+			break;
+		case FgbColumnType::ULONG:
+			SetPropertyValue<uint64_t>(*vec, row_idx, value);
+			break;
+		case FgbColumnType::FLOAT:
+			SetPropertyValue<float>(*vec, row_idx, value);
+			break;
+		case FgbColumnType::DOUBLE:
+			SetPropertyValue<double>(*vec, row_idx, value);
+			break;
+		case FgbColumnType::STRING:
+		case FgbColumnType::JSON:
+			SetStringProperty(*vec, row_idx, value, value_size, feature_idx);
+			break;
+		case FgbColumnType::DATETIME: {
+			// Stored as an ISO 8601 string, anything we cant parse becomes NULL
+			timestamp_t timestamp;
+			if (Timestamp::TryConvertTimestamp(const_char_ptr_cast(value), value_size, timestamp) ==
+			    TimestampCastResult::SUCCESS) {
+				FlatVector::GetData<timestamp_t>(*vec)[row_idx] = timestamp;
+			} else {
+				FlatVector::SetNull(*vec, row_idx, true);
+			}
+		} break;
+		case FgbColumnType::BINARY:
+			FlatVector::GetData<string_t>(*vec)[row_idx] =
+			    StringVector::AddStringOrBlob(*vec, const_char_ptr_cast(value), value_size);
+			break;
+		default:
+			ThrowInvalidFlatGeobuf();
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// Execute
+//------------------------------------------------------------------------------
+
+static void Execute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	auto &bind_data = input.bind_data->Cast<FlatGeobufBindData>();
+	auto &gstate = input.global_state->Cast<FlatGeobufGlobalState>();
+	auto &lstate = input.local_state->Cast<FlatGeobufLocalState>();
+
+	// Map the file columns to the output vectors
+	auto geom_column_id = bind_data.columns.size();
+	vector<optional_ptr<Vector>> column_vectors(bind_data.columns.size());
+	optional_ptr<Vector> geom_vector;
+	optional_ptr<Vector> row_id_vector;
+	bool has_attributes = false;
+	for (idx_t col_idx = 0; col_idx < gstate.column_ids.size(); col_idx++) {
+		auto column_id = gstate.column_ids[col_idx];
+		if (column_id == COLUMN_IDENTIFIER_ROW_ID) {
+			row_id_vector = output.data[col_idx];
+		} else if (column_id == geom_column_id) {
+			geom_vector = output.data[col_idx];
+		} else {
+			column_vectors[column_id] = output.data[col_idx];
+			has_attributes = true;
+		}
+	}
+	// Without an index we have to check the bounding box of every feature ourselves
+	auto filter_features = bind_data.has_spatial_filter && !bind_data.HasIndex();
+
+	while (true) {
+		if (!GetNextBatch(bind_data, gstate, lstate)) {
+			output.SetCardinality(0);
+			return;
+		}
+		ReadFeatures(lstate);
+		lstate.factory.allocator.Reset();
+
+		auto buffer = lstate.feature_buffer.get();
+		idx_t count = 0;
+		for (idx_t i = 0; i < lstate.entries.size(); i++) {
+			auto &entry = lstate.entries[i];
+			auto feature = FlatBufferTable::Root(buffer + lstate.feature_positions[i], entry.size);
+			auto has_geometry = feature.HasField(static_cast<idx_t>(FgbFeatureField::GEOMETRY));
+
+			if (filter_features) {
+				if (!has_geometry) {
+					continue;
+				}
+				BoundingBox bbox;
+				GetGeometryBounds(feature.GetTable(static_cast<idx_t>(FgbFeatureField::GEOMETRY)), bbox);
+				if (!bind_data.IntersectsFilter(bbox.minx, bbox.miny, bbox.maxx, bbox.maxy)) {
+					continue;
+				}
+			}
+
+			if (geom_vector) {
+				if (has_geometry) {
+					auto geom_table = feature.GetTable(static_cast<idx_t>(FgbFeatureField::GEOMETRY));
+					auto geom = ReadGeometry(geom_table, bind_data.geometry_type, lstate.factory.allocator,
+					                         bind_data.has_z, bind_data.has_m);
+					FlatVector::GetData<geometry_t>(*geom_vector)[count] =
+					    lstate.factory.Serialize(*geom_vector, geom, bind_data.has_z, bind_data.has_m);
+				} else {
+					FlatVector::SetNull(*geom_vector, count, true);
+				}
+			}
+			if (has_attributes) {
+				ReadProperties(bind_data, feature, column_vectors, count, entry.feature_idx);
+			}
+			if (row_id_vector) {
+				FlatVector::GetData<int64_t>(*row_id_vector)[count] = static_cast<int64_t>(entry.feature_idx);
+			}
+			count++;
+		}
+
+		gstate.features_read += lstate.entries.size();
+
+		if (count == 0) {
+			// Nothing in this batch passed the filter, move on to the next one
+			continue;
+		}
+		output.SetCardinality(count);
+		return;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Progress and Cardinality
+//------------------------------------------------------------------------------
+
+static double GetProgress(ClientContext &context, const FunctionData *bind_data_p,
+                          const GlobalTableFunctionState *global_state) {
+	auto &gstate = global_state->Cast<FlatGeobufGlobalState>();
+	auto &bind_data = bind_data_p->Cast<FlatGeobufBindData>();
+
+	auto total = gstate.is_search ? gstate.search_results.size() : bind_data.features_count;
+	if (total == 0) {
+		return 100;
+	}
+	return MinValue<double>(100, 100 * ((double)gstate.features_read / (double)total));
+}
+
+static idx_t GetBatchIndex(ClientContext &context, const FunctionData *bind_data_p,
+                           LocalTableFunctionState *local_state, GlobalTableFunctionState *global_state) {
+	auto &lstate = local_state->Cast<FlatGeobufLocalState>();
+	return lstate.batch_idx;
+}
+
+static unique_ptr<NodeStatistics> GetCardinality(ClientContext &context, const FunctionData *data) {
+	auto &bind_data = data->Cast<FlatGeobufBindData>();
+	auto result = make_uniq<NodeStatistics>();
+
+	// The header tells us how many features there are (if the writer knew)
+	if (bind_data.features_count > 0) {
+		result->has_max_cardinality = true;
+		result->max_cardinality = bind_data.features_count;
+		if (!bind_data.has_spatial_filter) {
+			result->has_estimated_cardinality = true;
+			result->estimated_cardinality = bind_data.features_count;
+		}
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------------
+// Register table function
+//------------------------------------------------------------------------------
+void CoreTableFunctions::RegisterFlatGeobufTableFunction(DatabaseInstance &db) {
+	TableFunction read_func("ST_ReadFGB", {LogicalType::VARCHAR}, Execute, Bind, InitGlobal, InitLocal);
+
+	read_func.named_parameters["spatial_filter_box"] = GeoTypes::BOX_2D();
+	read_func.table_scan_progress = GetProgress;
+	read_func.get_batch_index = GetBatchIndex;
+	read_func.cardinality = GetCardinality;
+	read_func.projection_pushdown = true;
+	ExtensionUtil::RegisterFunction(db, read_func);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,731 @@
+#include "duckdb/parser/parsed_data/create_table_function_info.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/functions/table.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/io/geojson.hpp"
+
+#include "yyjson.h"
+
+#include <algorithm>
+
+namespace spatial {
+
+namespace core {
+
+using namespace duckdb_yyjson_spatial;
+
+//------------------------------------------------------------------------------
+// GeoJSON Reader
+//------------------------------------------------------------------------------
+// ST_ReadGeoJSONSeq reads newline-delimited GeoJSON features (GeoJSONSeq/GeoJSONL, optionally compressed).
+// The file is read sequentially in large blocks that end on a line boundary, but each block is parsed and
+// converted by the thread that claimed it, so the parsing scales with the number of threads.
+//
+// ST_ReadGeoJSON reads a single FeatureCollection (or Feature). The document is parsed once, after which
+// the features are converted to rows in parallel.
+//
+// In both cases the property columns and their types are inferred from the first features of the input.
+
+static constexpr idx_t GEOJSON_BLOCK_SIZE = 8 * 1024 * 1024;
+static constexpr idx_t GEOJSON_MAX_CHUNKS_PER_BLOCK = 1 << 16;
+static constexpr int64_t GEOJSON_DEFAULT_SAMPLE_SIZE = 10240;
+static constexpr yyjson_read_flag GEOJSON_READ_FLAGS =
+    YYJSON_READ_ALLOW_TRAILING_COMMAS | YYJSON_READ_ALLOW_INF_AND_NAN;
+
+//------------------------------------------------------------------------------
+// Schema Inference
+//------------------------------------------------------------------------------
+
+enum class GeoJSONPropertyType : uint8_t { UNKNOWN, BOOLEAN, BIGINT, DOUBLE, VARCHAR };
+
+struct GeoJSONSchema {
+	vector<string> names;
+	vector<GeoJSONPropertyType> types;
+	case_insensitive_map_t<idx_t> column_map;
+
+	static GeoJSONPropertyType Combine(GeoJSONPropertyType current, yyjson_val *val) {
+		if (yyjson_is_null(val)) {
+			return current;
+		}
+		if (yyjson_is_bool(val)) {
+			return current == GeoJSONPropertyType::UNKNOWN || current == GeoJSONPropertyType::BOOLEAN
+			           ? GeoJSONPropertyType::BOOLEAN
+			           : GeoJSONPropertyType::VARCHAR;
+		}
+		auto is_bigint = yyjson_is_sint(val) ||
+		                 (yyjson_is_uint(val) && yyjson_get_uint(val) <= (uint64_t)NumericLimits<int64_t>::Maximum());
+		if (is_bigint) {
+			switch (current) {
+			case GeoJSONPropertyType::UNKNOWN:
+			case GeoJSONPropertyType::BIGINT:
+				return GeoJSONPropertyType::BIGINT;
+			case GeoJSONPropertyType::DOUBLE:
+				return GeoJSONPropertyType::DOUBLE;
+			default:
+				return GeoJSONPropertyType::VARCHAR;
+			}
+		}
+		if (yyjson_is_num(val)) {
+			switch (current) {
+			case GeoJSONPropertyType::UNKNOWN:
+			case GeoJSONPropertyType::BIGINT:
+			case GeoJSONPropertyType::DOUBLE:
+				return GeoJSONPropertyType::DOUBLE;
+			default:
+				return GeoJSONPropertyType::VARCHAR;
+			}
+		}
+		// Strings, objects and arrays
+		return GeoJSONPropertyType::VARCHAR;
+	}
+
+	void Sniff(yyjson_val *feature) {
+		auto properties = yyjson_obj_get(feature, "properties");
+		if (!yyjson_is_obj(properties)) {
+			return;
+		}
+		size_t idx, max;
+		yyjson_val *key, *val;
+		yyjson_obj_foreach(properties, idx, max, key, val) {
+			string name(yyjson_get_str(key), yyjson_get_len(key));
+			auto entry = column_map.find(name);
+			if (entry == column_map.end()) {
+				entry = column_map.emplace(name, names.size()).first;
+				names.push_back(name);
+				types.push_back(GeoJSONPropertyType::UNKNOWN);
+			}
+			types[entry->second] = Combine(types[entry->second], val);
+		}
+	}
+
+	static LogicalType GetLogicalType(GeoJSONPropertyType type) {
+		switch (type) {
+		case GeoJSONPropertyType::BOOLEAN:
+			return LogicalType::BOOLEAN;
+		case GeoJSONPropertyType::BIGINT:
+			return LogicalType::BIGINT;
+		case GeoJSONPropertyType::DOUBLE:
+			return LogicalType::DOUBLE;
+		default:
+			// Properties that are always null also become VARCHAR
+			return LogicalType::VARCHAR;
+		}
+	}
+};
+
+//------------------------------------------------------------------------------
+// Bind
+//------------------------------------------------------------------------------
+
+struct YYJSONDocDeleter {
+	void operator()(yyjson_doc *doc) {
+		yyjson_doc_free(doc);
+	}
+};
+
+struct GeoJSONBindData : public TableFunctionData {
+	string file_name;
+	bool is_sequence;
+	vector<LogicalType> property_types;
+	vector<string> property_names;
+	case_insensitive_map_t<idx_t> column_map;
+
+	// For ST_ReadGeoJSON, the parsed document and its features
+	shared_ptr<yyjson_doc> doc;
+	vector<yyjson_val *> features;
+
+	GeoJSONBindData(string file_name_p, bool is_sequence_p)
+	    : file_name(std::move(file_name_p)), is_sequence(is_sequence_p) {
+	}
+};
+
+static unique_ptr<FileHandle> OpenGeoJSONFile(ClientContext &context, const string &file_name) {
+	auto &fs = FileSystem::GetFileSystem(context);
+	return fs.OpenFile(file_name, FileFlags::FILE_FLAGS_READ, FileSystem::DEFAULT_LOCK,
+	                   FileCompressionType::AUTO_DETECT);
+}
+
+// Remove surrounding whitespace and the record separator GeoJSONSeq puts in front of each feature
+static void TrimLine(const char *&begin, const char *&end) {
+	while (begin < end && (*begin == 0x1E || StringUtil::CharacterIsSpace(*begin))) {
+		begin++;
+	}
+	while (end > begin && StringUtil::CharacterIsSpace(*(end - 1))) {
+		end--;
+	}
+}
+
+static int64_t GetSampleSize(TableFunctionBindInput &input) {
+	auto sample_size = GEOJSON_DEFAULT_SAMPLE_SIZE;
+	for (auto &kv : input.named_parameters) {
+		if (kv.first == "sample_size") {
+			sample_size = kv.second.GetValue<int64_t>();
+			if (sample_size == 0 || sample_size < -1) {
+				throw BinderException("sample_size must be positive, or -1 to sample the whole input");
+			}
+		}
+	}
+	return sample_size;
+}
+
+static void SetSchema(GeoJSONBindData &bind_data, GeoJSONSchema &schema, vector<LogicalType> &return_types,
+                      vector<string> &names) {
+	for (idx_t i = 0; i < schema.names.size(); i++) {
+		auto type = GeoJSONSchema::GetLogicalType(schema.types[i]);
+		bind_data.property_names.push_back(schema.names[i]);
+		bind_data.property_types.push_back(type);
+		names.push_back(schema.names[i]);
+		return_types.push_back(type);
+	}
+	bind_data.column_map = std::move(schema.column_map);
+
+	// The geometry is always last
+	names.push_back("geom");
+	return_types.push_back(GeoTypes::GEOMETRY());
+}
+
+static unique_ptr<FunctionData> BindSequence(ClientContext &context, TableFunctionBindInput &input,
+                                             vector<LogicalType> &return_types, vector<string> &names) {
+	auto file_name = StringValue::Get(input.inputs[0]);
+	auto result = make_uniq<GeoJSONBindData>(file_name, true);
+	auto sample_size = GetSampleSize(input);
+
+	// Sample the first features to find the properties
+	auto handle = OpenGeoJSONFile(context, file_name);
+	GeoJSONSchema schema;
+	ArenaAllocator arena(BufferAllocator::Get(context));
+	JSONAllocator json_allocator(arena);
+
+	string buffer;
+	idx_t offset = 0;
+	int64_t sampled = 0;
+	bool finished = false;
+	while (sample_size == -1 || sampled < sample_size) {
+		auto newline = buffer.find('\n', offset);
+		if (newline == string::npos && !finished) {
+			// Read some more
+			buffer.erase(0, offset);
+			offset = 0;
+			auto old_size = buffer.size();
+			buffer.resize(old_size + GEOJSON_BLOCK_SIZE / 8);
+			auto read = handle->Read(&buffer[old_size], GEOJSON_BLOCK_SIZE / 8);
+			buffer.resize(old_size + read);
+			finished = read == 0;
+			continue;
+		}
+		if (newline == string::npos) {
+			newline = buffer.size();
+		}
+		if (offset >= buffer.size()) {
+			break;
+		}
+
+		auto begin = buffer.c_str() + offset;
+		auto end = buffer.c_str() + newline;
+		offset = newline + 1;
+		TrimLine(begin, end);
+		if (begin == end) {
+			continue;
+		}
+
+		yyjson_read_err err;
+		auto doc = yyjson_read_opts(const_cast<char *>(begin), end - begin, GEOJSON_READ_FLAGS,
+		                            json_allocator.GetYYJSONAllocator(), &err);
+		if (!doc) {
+			throw InvalidInputException("Could not parse GeoJSON feature in '%s': %s", file_name, err.msg);
+		}
+		schema.Sniff(yyjson_doc_get_root(doc));
+		json_allocator.Reset();
+		sampled++;
+	}
+
+	SetSchema(*result, schema, return_types, names);
+	return std::move(result);
+}
+
+static unique_ptr<FunctionData> BindCollection(ClientContext &context, TableFunctionBindInput &input,
+                                               vector<LogicalType> &return_types, vector<string> &names) {
+	auto file_name = StringValue::Get(input.inputs[0]);
+	auto result = make_uniq<GeoJSONBindData>(file_name, false);
+	auto sample_size = GetSampleSize(input);
+
+	// Read the whole document
+	auto handle = OpenGeoJSONFile(context, file_name);
+	string buffer;
+	while (true) {
+		auto old_size = buffer.size();
+		buffer.resize(old_size + GEOJSON_BLOCK_SIZE);
+		auto read = handle->Read(&buffer[old_size], GEOJSON_BLOCK_SIZE);
+		buffer.resize(old_size + read);
+		if (read == 0) {
+			break;
+		}
+	}
+
+	yyjson_read_err err;
+	auto doc = yyjson_read_opts(&buffer[0], buffer.size(), GEOJSON_READ_FLAGS, nullptr, &err);
+	if (!doc) {
+		throw InvalidInputException("Could not parse GeoJSON file '%s': %s", file_name, err.msg);
+	}
+	result->doc = shared_ptr<yyjson_doc>(doc, YYJSONDocDeleter());
+
+	auto root = yyjson_doc_get_root(doc);
+	auto type = yyjson_get_str(yyjson_obj_get(root, "type"));
+	if (type && StringUtil::Equals(type, "FeatureCollection")) {
+		auto features = yyjson_obj_get(root, "features");
+		if (!yyjson_is_arr(features)) {
+			throw InvalidInputException("GeoJSON FeatureCollection in '%s' does not have a features array",
+			                            file_name);
+		}
+		size_t idx, max;
+		yyjson_val *feature;
+		yyjson_arr_foreach(features, idx, max, feature) {
+			result->features.push_back(feature);
+		}
+	} else if (type && StringUtil::Equals(type, "Feature")) {
+		result->features.push_back(root);
+	} else {
+		throw InvalidInputException("GeoJSON file '%s' does not contain a FeatureCollection or a Feature", file_name);
+	}
+
+	GeoJSONSchema schema;
+	for (idx_t i = 0; i < result->features.size() && (sample_size == -1 || (int64_t)i < sample_size); i++) {
+		schema.Sniff(result->features[i]);
+	}
+
+	SetSchema(*result, schema, return_types, names);
+	return std::move(result);
+}
+
+//------------------------------------------------------------------------------
+// Init
+//------------------------------------------------------------------------------
+
+struct GeoJSONGlobalState : public GlobalTableFunctionState {
+	mutex lock;
+	idx_t max_threads;
+	vector<column_t> column_ids;
+
+	// ST_ReadGeoJSONSeq: the file is handed out in blocks that end on a line boundary
+	unique_ptr<FileHandle> handle;
+	bool finished = false;
+	// The incomplete line at the end of the last block
+	string remainder;
+	idx_t next_block_idx = 0;
+	// The row id of the first feature in the next block, only counted if the row id is projected
+	bool has_row_id = false;
+	idx_t next_row_idx = 0;
+
+	// ST_ReadGeoJSON: the features are handed out in ranges of STANDARD_VECTOR_SIZE
+	idx_t next_feature_idx = 0;
+	atomic<idx_t> features_read;
+
+	GeoJSONGlobalState(idx_t max_threads_p, vector<column_t> column_ids_p)
+	    : max_threads(max_threads_p), column_ids(std::move(column_ids_p)), features_read(0) {
+	}
+
+	idx_t MaxThreads() const override {
+		return max_threads;
+	}
+};
+
+static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext &context, TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<GeoJSONBindData>();
+	auto threads = context.db->NumberOfThreads();
+
+	if (bind_data.is_sequence) {
+		auto result = make_uniq<GeoJSONGlobalState>(threads, input.column_ids);
+		result->handle = OpenGeoJSONFile(context, bind_data.file_name);
+		result->has_row_id = std::find(input.column_ids.begin(), input.column_ids.end(), COLUMN_IDENTIFIER_ROW_ID) !=
+		                     input.column_ids.end();
+		return std::move(result);
+	}
+
+	auto batch_count = (bind_data.features.size() + STANDARD_VECTOR_SIZE - 1) / STANDARD_VECTOR_SIZE;
+	return make_uniq<GeoJSONGlobalState>(MinValue<idx_t>(threads, MaxValue<idx_t>(batch_count, 1)),
+	                                     input.column_ids);
+}
+
+struct GeoJSONLocalState : public LocalTableFunctionState {
+	GeometryFactory factory;
+	JSONAllocator json_allocator;
+	idx_t batch_idx = 0;
+
+	// The current block of lines (ST_ReadGeoJSONSeq)
+	string block;
+	idx_t block_offset = 0;
+	idx_t block_idx = 0;
+	idx_t block_chunk_idx = 0;
+	// The row id of the next feature in the block
+	idx_t block_row_idx = 0;
+
+	explicit GeoJSONLocalState(ClientContext &context)
+	    : factory(BufferAllocator::Get(context)), json_allocator(factory.allocator) {
+	}
+};
+
+static unique_ptr<LocalTableFunctionState> InitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+                                                     GlobalTableFunctionState *global_state) {
+	return make_uniq<GeoJSONLocalState>(context.client);
+}
+
+//------------------------------------------------------------------------------
+// Conversion
+//------------------------------------------------------------------------------
+
+// Write a property value that doesnt match the type we inferred by casting its text
+static void SetMismatchedProperty(Vector &vec, idx_t row_idx, yyjson_val *val, const string &name,
+                                  JSONAllocator &json_allocator) {
+	string text;
+	if (yyjson_is_str(val)) {
+		text = string(yyjson_get_str(val), yyjson_get_len(val));
+	} else {
+		size_t len;
+		auto json = yyjson_val_write_opts(val, 0, json_allocator.GetYYJSONAllocator(), &len, nullptr);
+		text = string(json, len);
+	}
+	Value result;
+	string error;
+	if (!Value(text).DefaultTryCastAs(vec.GetType(), result, &error)) {
+		throw InvalidInputException("GeoJSON property \"%s\" has value '%s' which can not be converted to %s, the "
+		                            "type was inferred from the first features, try increasing the sample_size",
+		                            name, text, vec.GetType().ToString());
+	}
+	vec.SetValue(row_idx, result);
+}
+
+static void SetProperty(Vector &vec, idx_t row_idx, yyjson_val *val, const string &name,
+                        JSONAllocator &json_allocator) {
+	if (yyjson_is_null(val)) {
+		return;
+	}
+	FlatVector::Validity(vec).SetValid(row_idx);
+
+	switch (vec.GetType().id()) {
+	case LogicalTypeId::BOOLEAN:
+		if (yyjson_is_bool(val)) {
+			FlatVector::GetData<bool>(vec)[row_idx] = yyjson_get_bool(val);
+			return;
+		}
+		break;
+	case LogicalTypeId::BIGINT:
+		if (yyjson_is_sint(val)) {
+			FlatVector::GetData<int64_t>(vec)[row_idx] = yyjson_get_sint(val);
+			return;
+		}
+		if (yyjson_is_uint(val) && yyjson_get_uint(val) <= (uint64_t)NumericLimits<int64_t>::Maximum()) {
+			FlatVector::GetData<int64_t>(vec)[row_idx] = static_cast<int64_t>(yyjson_get_uint(val));
+			return;
+		}
+		break;
+	case LogicalTypeId::DOUBLE:
+		if (yyjson_is_num(val)) {
+			FlatVector::GetData<double>(vec)[row_idx] = yyjson_get_num(val);
+			return;
+		}
+		break;
+	case LogicalTypeId::VARCHAR:
+		if (yyjson_is_str(val)) {
+			FlatVector::GetData<string_t>(vec)[row_idx] =
+			    StringVector::AddString(vec, yyjson_get_str(val), yyjson_get_len(val));
+		} else {
+			// Keep nested values (and anything else) as JSON
+			size_t len;
+			auto json = yyjson_val_write_opts(val, 0, json_allocator.GetYYJSONAllocator(), &len, nullptr);
+			FlatVector::GetData<string_t>(vec)[row_idx] = StringVector::AddString(vec, json, len);
+		}
+		return;
+	default:
+		break;
+	}
+	SetMismatchedProperty(vec, row_idx, val, name, json_allocator);
+}
+
+struct GeoJSONOutput {
+	// The output vector of each property, or nullptr if the property is not projected
+	vector<optional_ptr<Vector>> property_vectors;
+	optional_ptr<Vector> geom_vector;
+	optional_ptr<Vector> row_id_vector;
+	bool has_properties = false;
+
+	GeoJSONOutput(const GeoJSONBindData &bind_data, const vector<column_t> &column_ids, DataChunk &output)
+	    : property_vectors(bind_data.property_types.size()) {
+		for (idx_t col_idx = 0; col_idx < column_ids.size(); col_idx++) {
+			auto column_id = column_ids[col_idx];
+			if (column_id == COLUMN_IDENTIFIER_ROW_ID) {
+				row_id_vector = output.data[col_idx];
+			} else if (column_id == bind_data.property_types.size()) {
+				geom_vector = output.data[col_idx];
+			} else {
+				property_vectors[column_id] = output.data[col_idx];
+				has_properties = true;
+			}
+		}
+	}
+};
+
+static void ConvertFeature(const GeoJSONBindData &bind_data, GeoJSONLocalState &lstate, GeoJSONOutput &output,
+                           yyjson_val *feature, const string_t &raw, idx_t row_idx) {
+	if (!yyjson_is_obj(feature)) {
+		throw InvalidInputException("GeoJSON feature is not an object: %s", raw.GetString());
+	}
+
+	if (output.has_properties) {
+		for (auto &vec : output.property_vectors) {
+			if (vec) {
+				FlatVector::SetNull(*vec, row_idx, true);
+			}
+		}
+		auto properties = yyjson_obj_get(feature, "properties");
+		if (yyjson_is_obj(properties)) {
+			size_t idx, max;
+			yyjson_val *key, *val;
+			yyjson_obj_foreach(properties, idx, max, key, val) {
+				// Properties that were not in the sample are skipped
+				auto entry = bind_data.column_map.find(string(yyjson_get_str(key), yyjson_get_len(key)));
+				if (entry == bind_data.column_map.end() || !output.property_vectors[entry->second]) {
+					continue;
+				}
+				SetProperty(*output.property_vectors[entry->second], row_idx, val,
+				            bind_data.property_names[entry->second], lstate.json_allocator);
+			}
+		}
+	}
+
+	if (output.geom_vector) {
+		auto geometry = yyjson_obj_get(feature, "geometry");
+		if (!geometry || yyjson_is_null(geometry)) {
+			FlatVector::SetNull(*output.geom_vector, row_idx, true);
+		} else {
+			if (!yyjson_is_obj(geometry)) {
+				throw InvalidInputException("GeoJSON feature geometry is not an object: %s", raw.GetString());
+			}
+			bool has_z = false;
+			auto geom = GeoJSON::FromGeoJSON(geometry, lstate.factory, raw, has_z);
+			if (has_z) {
+				// Ensure the geometries has consistent Z values
+				geom.SetVertexType(lstate.factory.allocator, has_z, false);
+			}
+			FlatVector::GetData<geometry_t>(*output.geom_vector)[row_idx] =
+			    lstate.factory.Serialize(*output.geom_vector, geom, has_z, false);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// Execute
+//------------------------------------------------------------------------------
+
+// Count the lines of a block that are not blank, i.e. the features in it
+static idx_t CountFeatures(const string &block) {
+	idx_t count = 0;
+	idx_t offset = 0;
+	while (offset < block.size()) {
+		auto newline = block.find('\n', offset);
+		if (newline == string::npos) {
+			newline = block.size();
+		}
+		auto begin = block.c_str() + offset;
+		auto end = block.c_str() + newline;
+		offset = newline + 1;
+		TrimLine(begin, end);
+		count += begin != end;
+	}
+	return count;
+}
+
+// Claim the next block of complete lines, returns false if the file is exhausted
+static bool ReadNextBlock(GeoJSONGlobalState &gstate, GeoJSONLocalState &lstate) {
+	lock_guard<mutex> glock(gstate.lock);
+
+	auto &block = lstate.block;
+	block.swap(gstate.remainder);
+	gstate.remainder.clear();
+
+	while (!gstate.finished) {
+		auto old_size = block.size();
+		block.resize(old_size + GEOJSON_BLOCK_SIZE);
+		auto read = gstate.handle->Read(&block[old_size], GEOJSON_BLOCK_SIZE);
+		block.resize(old_size + read);
+		if (read == 0) {
+			gstate.finished = true;
+			break;
+		}
+		// Cut the block after the last newline, if there is none keep reading
+		auto end = block.size();
+		while (end > old_size && block[end - 1] != '\n') {
+			end--;
+		}
+		if (end > old_size) {
+			gstate.remainder.assign(block, end, string::npos);
+			block.resize(end);
+			break;
+		}
+	}
+	if (block.empty()) {
+		return false;
+	}
+
+	lstate.block_offset = 0;
+	lstate.block_idx = gstate.next_block_idx++;
+	lstate.block_chunk_idx = 0;
+	if (gstate.has_row_id) {
+		// The blocks are claimed in file order, so the features before this one are all counted already
+		lstate.block_row_idx = gstate.next_row_idx;
+		gstate.next_row_idx += CountFeatures(block);
+	}
+	return true;
+}
+
+static void ExecuteSequence(const GeoJSONBindData &bind_data, GeoJSONGlobalState &gstate, GeoJSONLocalState &lstate,
+                            DataChunk &output) {
+	GeoJSONOutput out(bind_data, gstate.column_ids, output);
+
+	// Every output chunk comes from a single block, so that the batch indices follow the file order. The rest of a
+	// block can be blank lines, so keep claiming blocks until we have any features (or the file is exhausted)
+	auto &block = lstate.block;
+	idx_t count = 0;
+	while (count == 0) {
+		if (lstate.block_offset >= block.size() && !ReadNextBlock(gstate, lstate)) {
+			output.SetCardinality(0);
+			return;
+		}
+		while (count < STANDARD_VECTOR_SIZE && lstate.block_offset < block.size()) {
+			auto newline = block.find('\n', lstate.block_offset);
+			if (newline == string::npos) {
+				newline = block.size();
+			}
+			auto begin = block.c_str() + lstate.block_offset;
+			auto end = block.c_str() + newline;
+			lstate.block_offset = newline + 1;
+			TrimLine(begin, end);
+			if (begin == end) {
+				continue;
+			}
+
+			string_t raw(begin, (uint32_t)(end - begin));
+			yyjson_read_err err;
+			auto doc = yyjson_read_opts(const_cast<char *>(begin), end - begin, GEOJSON_READ_FLAGS,
+			                            lstate.json_allocator.GetYYJSONAllocator(), &err);
+			if (!doc) {
+				throw InvalidInputException("Could not parse GeoJSON feature: %s (%s)", err.msg, raw.GetString());
+			}
+			ConvertFeature(bind_data, lstate, out, yyjson_doc_get_root(doc), raw, count);
+			count++;
+		}
+	}
+
+	if (out.row_id_vector) {
+		out.row_id_vector->Sequence(static_cast<int64_t>(lstate.block_row_idx), 1, count);
+	}
+	lstate.block_row_idx += count;
+
+	lstate.batch_idx = lstate.block_idx * GEOJSON_MAX_CHUNKS_PER_BLOCK + lstate.block_chunk_idx++;
+	output.SetCardinality(count);
+}
+
+static void ExecuteCollection(const GeoJSONBindData &bind_data, GeoJSONGlobalState &gstate, GeoJSONLocalState &lstate,
+                              DataChunk &output) {
+	GeoJSONOutput out(bind_data, gstate.column_ids, output);
+
+	idx_t start;
+	idx_t count;
+	{
+		lock_guard<mutex> glock(gstate.lock);
+		start = gstate.next_feature_idx;
+		count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, bind_data.features.size() - start);
+		gstate.next_feature_idx += count;
+		lstate.batch_idx = start / STANDARD_VECTOR_SIZE;
+	}
+
+	string_t raw("GeoJSON feature");
+	for (idx_t i = 0; i < count; i++) {
+		ConvertFeature(bind_data, lstate, out, bind_data.features[start + i], raw, i);
+		if (out.row_id_vector) {
+			FlatVector::GetData<int64_t>(*out.row_id_vector)[i] = static_cast<int64_t>(start + i);
+		}
+	}
+	gstate.features_read += count;
+	output.SetCardinality(count);
+}
+
+static void Execute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	auto &bind_data = input.bind_data->Cast<GeoJSONBindData>();
+	auto &gstate = input.global_state->Cast<GeoJSONGlobalState>();
+	auto &lstate = input.local_state->Cast<GeoJSONLocalState>();
+
+	// The parsed documents and geometries only live until the chunk is emitted
+	lstate.factory.allocator.Reset();
+
+	if (bind_data.is_sequence) {
+		ExecuteSequence(bind_data, gstate, lstate, output);
+	} else {
+		ExecuteCollection(bind_data, gstate, lstate, output);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Progress, Batch Index and Cardinality
+//------------------------------------------------------------------------------
+
+static double GetProgress(ClientContext &context, const FunctionData *bind_data_p,
+                          const GlobalTableFunctionState *global_state) {
+	auto &bind_data = bind_data_p->Cast<GeoJSONBindData>();
+	auto &gstate = global_state->Cast<GeoJSONGlobalState>();
+	if (bind_data.is_sequence) {
+		// We dont know how many features there are
+		return -1;
+	}
+	if (bind_data.features.empty()) {
+		return 100;
+	}
+	return 100 * ((double)gstate.features_read / (double)bind_data.features.size());
+}
+
+static idx_t GetBatchIndex(ClientContext &context, const FunctionData *bind_data_p,
+                           LocalTableFunctionState *local_state, GlobalTableFunctionState *global_state) {
+	auto &lstate = local_state->Cast<GeoJSONLocalState>();
+	return lstate.batch_idx;
+}
+
+static unique_ptr<NodeStatistics> GetCardinality(ClientContext &context, const FunctionData *data) {
+	auto &bind_data = data->Cast<GeoJSONBindData>();
+	auto result = make_uniq<NodeStatistics>();
+	if (!bind_data.is_sequence) {
+		result->has_estimated_cardinality = true;
+		result->estimated_cardinality = bind_data.features.size();
+		result->has_max_cardinality = true;
+		result->max_cardinality = bind_data.features.size();
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------------
+// Register table functions
+//------------------------------------------------------------------------------
+void CoreTableFunctions::RegisterGeoJSONTableFunctions(DatabaseInstance &db) {
+	TableFunction read_seq("ST_ReadGeoJSONSeq", {LogicalType::VARCHAR}, Execute, BindSequence, InitGlobal, InitLocal);
+	read_seq.named_parameters["sample_size"] = LogicalType::BIGINT;
+	read_seq.table_scan_progress = GetProgress;
+	read_seq.get_batch_index = GetBatchIndex;
+	read_seq.cardinality = GetCardinality;
+	read_seq.projection_pushdown = true;
+	ExtensionUtil::RegisterFunction(db, read_seq);
+
+	TableFunction read_collection("ST_ReadGeoJSON", {LogicalType::VARCHAR}, Execute, BindCollection, InitGlobal,
+	                              InitLocal);
+	read_collection.named_parameters["sample_size"] = LogicalType::BIGINT;
+	read_collection.table_scan_progress = GetProgress;
+	read_collection.get_batch_index = GetBatchIndex;
+	read_collection.cardinality = GetCardinality;
+	read_collection.projection_pushdown = true;
+	ExtensionUtil::RegisterFunction(db, read_collection);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,281 @@
+#include "duckdb/common/file_system.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/io/geoparquet.hpp"
+
+#include "yyjson.h"
+
+namespace spatial {
+
+namespace core {
+
+using namespace duckdb_yyjson_spatial;
+
+//------------------------------------------------------------------------------
+// Thrift Compact Protocol
+//------------------------------------------------------------------------------
+// The parquet footer is a thrift struct in the compact protocol. We only need the key-value metadata from it, so
+// instead of pulling in the full parquet metadata definitions we walk the struct and skip everything else.
+
+enum class ThriftType : uint8_t {
+	STOP = 0,
+	BOOL_TRUE = 1,
+	BOOL_FALSE = 2,
+	BYTE = 3,
+	I16 = 4,
+	I32 = 5,
+	I64 = 6,
+	DOUBLE = 7,
+	BINARY = 8,
+	LIST = 9,
+	SET = 10,
+	MAP = 11,
+	STRUCT = 12
+};
+
+class ThriftCompactReader {
+public:
+	ThriftCompactReader(const_data_ptr_t data, idx_t size) : ptr(data), end(data + size) {
+	}
+
+	uint8_t ReadByte() {
+		if (ptr >= end) {
+			throw InvalidInputException("Unexpected end of parquet footer");
+		}
+		return *ptr++;
+	}
+
+	uint64_t ReadVarint() {
+		uint64_t result = 0;
+		for (idx_t shift = 0; shift < 64; shift += 7) {
+			auto byte = ReadByte();
+			result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80)) {
+				return result;
+			}
+		}
+		throw InvalidInputException("Invalid varint in parquet footer");
+	}
+
+	string ReadBinary() {
+		auto size = ReadVarint();
+		Skip(size);
+		return string(const_char_ptr_cast(ptr - size), size);
+	}
+
+	// Read the header of the next field of a struct, returns false at the end of the struct
+	bool ReadFieldHeader(int16_t &field_id, ThriftType &type) {
+		auto header = ReadByte();
+		type = static_cast<ThriftType>(header & 0x0F);
+		if (type == ThriftType::STOP) {
+			return false;
+		}
+		auto delta = header >> 4;
+		if (delta != 0) {
+			field_id = static_cast<int16_t>(field_id + delta);
+		} else {
+			auto value = ReadVarint();
+			field_id = static_cast<int16_t>((value >> 1) ^ (~(value & 1) + 1));
+		}
+		return true;
+	}
+
+	void ReadListHeader(ThriftType &element_type, idx_t &size) {
+		auto header = ReadByte();
+		element_type = static_cast<ThriftType>(header & 0x0F);
+		size = header >> 4;
+		if (size == 15) {
+			size = ReadVarint();
+		}
+	}
+
+	// Skip a value of the given type, booleans take up a byte when they are not a struct field
+	void SkipValue(ThriftType type, bool is_field, idx_t depth = 0) {
+		if (depth > MAX_DEPTH) {
+			throw InvalidInputException("Parquet footer is nested too deeply");
+		}
+		switch (type) {
+		case ThriftType::BOOL_TRUE:
+		case ThriftType::BOOL_FALSE:
+			if (!is_field) {
+				Skip(1);
+			}
+			break;
+		case ThriftType::BYTE:
+			Skip(1);
+			break;
+		case ThriftType::I16:
+		case ThriftType::I32:
+		case ThriftType::I64:
+			ReadVarint();
+			break;
+		case ThriftType::DOUBLE:
+			Skip(8);
+			break;
+		case ThriftType::BINARY:
+			Skip(ReadVarint());
+			break;
+		case ThriftType::LIST:
+		case ThriftType::SET: {
+			ThriftType element_type;
+			idx_t size;
+			ReadListHeader(element_type, size);
+			for (idx_t i = 0; i < size; i++) {
+				SkipValue(element_type, false, depth + 1);
+			}
+			break;
+		}
+		case ThriftType::MAP: {
+			auto size = ReadVarint();
+			if (size == 0) {
+				break;
+			}
+			auto types = ReadByte();
+			for (idx_t i = 0; i < size; i++) {
+				SkipValue(static_cast<ThriftType>(types >> 4), false, depth + 1);
+				SkipValue(static_cast<ThriftType>(types & 0x0F), false, depth + 1);
+			}
+			break;
+		}
+		case ThriftType::STRUCT: {
+			int16_t field_id = 0;
+			ThriftType field_type;
+			while (ReadFieldHeader(field_id, field_type)) {
+				SkipValue(field_type, true, depth + 1);
+			}
+			break;
+		}
+		default:
+			throw InvalidInputException("Invalid type in parquet footer");
+		}
+	}
+
+private:
+	static constexpr idx_t MAX_DEPTH = 64;
+
+	const_data_ptr_t ptr;
+	const_data_ptr_t end;
+
+	void Skip(uint64_t size) {
+		if (size > static_cast<uint64_t>(end - ptr)) {
+			throw InvalidInputException("Unexpected end of parquet footer");
+		}
+		ptr += size;
+	}
+};
+
+//------------------------------------------------------------------------------
+// GeoParquetMetadata
+//------------------------------------------------------------------------------
+// The field ids of FileMetaData.key_value_metadata, KeyValue.key and KeyValue.value in parquet.thrift
+static constexpr int16_t FILE_METADATA_KEY_VALUE_FIELD = 5;
+static constexpr int16_t KEY_VALUE_KEY_FIELD = 1;
+static constexpr int16_t KEY_VALUE_VALUE_FIELD = 2;
+
+static bool TryReadGeoMetadata(ThriftCompactReader &reader, string &result) {
+	int16_t field_id = 0;
+	ThriftType type;
+	while (reader.ReadFieldHeader(field_id, type)) {
+		if (field_id != FILE_METADATA_KEY_VALUE_FIELD || type != ThriftType::LIST) {
+			reader.SkipValue(type, true);
+			continue;
+		}
+		ThriftType element_type;
+		idx_t size;
+		reader.ReadListHeader(element_type, size);
+		if (element_type != ThriftType::STRUCT) {
+			return false;
+		}
+		for (idx_t i = 0; i < size; i++) {
+			string key;
+			string value;
+			int16_t kv_field_id = 0;
+			ThriftType kv_type;
+			while (reader.ReadFieldHeader(kv_field_id, kv_type)) {
+				if (kv_field_id == KEY_VALUE_KEY_FIELD && kv_type == ThriftType::BINARY) {
+					key = reader.ReadBinary();
+				} else if (kv_field_id == KEY_VALUE_VALUE_FIELD && kv_type == ThriftType::BINARY) {
+					value = reader.ReadBinary();
+				} else {
+					reader.SkipValue(kv_type, true);
+				}
+			}
+			if (key == "geo") {
+				result = std::move(value);
+				return true;
+			}
+		}
+		return false;
+	}
+	return false;
+}
+
+bool GeoParquetMetadata::TryRead(ClientContext &context, const string &file_name, string &result) {
+	// A parquet file ends with the footer, the size of the footer and "PAR1"
+	static constexpr idx_t FOOTER_TAIL_SIZE = 8;
+	try {
+		auto &fs = FileSystem::GetFileSystem(context);
+		auto handle = fs.OpenFile(file_name, FileFlags::FILE_FLAGS_READ);
+		auto file_size = handle->GetFileSize();
+		if (file_size < FOOTER_TAIL_SIZE + 4) {
+			return false;
+		}
+		data_t tail[FOOTER_TAIL_SIZE];
+		handle->Read(tail, FOOTER_TAIL_SIZE, file_size - FOOTER_TAIL_SIZE);
+		if (memcmp(tail + 4, "PAR1", 4) != 0) {
+			// Not a parquet file, or the footer is encrypted
+			return false;
+		}
+		auto footer_size = static_cast<idx_t>(Load<uint32_t>(tail));
+		if (footer_size > file_size - FOOTER_TAIL_SIZE - 4) {
+			return false;
+		}
+		auto footer = make_unsafe_uniq_array<data_t>(footer_size);
+		handle->Read(footer.get(), footer_size, file_size - FOOTER_TAIL_SIZE - footer_size);
+
+		ThriftCompactReader reader(footer.get(), footer_size);
+		return TryReadGeoMetadata(reader, result);
+	} catch (std::exception &ex) {
+		return false;
+	}
+}
+
+bool GeoParquetMetadata::TryGetBBoxCovering(const string &geo_metadata, const string &column_name,
+                                            GeoParquetBBoxCovering &result) {
+	static const char *const BBOX_FIELDS[] = {"xmin", "ymin", "xmax", "ymax"};
+
+	auto doc = yyjson_read(geo_metadata.c_str(), geo_metadata.size(), 0);
+	if (!doc) {
+		return false;
+	}
+	auto columns = yyjson_obj_get(yyjson_doc_get_root(doc), "columns");
+	auto column = yyjson_obj_get(columns, column_name.c_str());
+	auto covering = yyjson_obj_get(column, "covering");
+	auto bbox = yyjson_obj_get(covering, "bbox");
+
+	// Every field is a path of the struct column and the field in it, and they all have to be in the same column
+	auto found = bbox != nullptr;
+	for (idx_t field = 0; found && field < 4; field++) {
+		auto path = yyjson_obj_get(bbox, BBOX_FIELDS[field]);
+		auto path_column = yyjson_arr_get(path, 0);
+		auto path_field = yyjson_arr_get(path, 1);
+		if (yyjson_arr_size(path) != 2 || !yyjson_is_str(path_column) || !yyjson_is_str(path_field)) {
+			found = false;
+			break;
+		}
+		string path_column_name(yyjson_get_str(path_column), yyjson_get_len(path_column));
+		if (field == 0) {
+			result.column = path_column_name;
+		} else if (path_column_name != result.column) {
+			found = false;
+			break;
+		}
+		result.fields[field] = string(yyjson_get_str(path_field), yyjson_get_len(path_field));
+	}
+	yyjson_doc_free(doc);
+	return found;
+}
+
+} // namespace core
+
+} // namespace spatial
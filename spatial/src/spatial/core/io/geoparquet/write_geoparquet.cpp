@@ -0,0 +1,607 @@
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/copy_function_catalog_entry.hpp"
+#include "duckdb/common/sort/sort.hpp"
+#include "duckdb/common/types/column/column_data_collection.hpp"
+#include "duckdb/function/copy_function.hpp"
+#include "duckdb/main/client_config.hpp"
+#include "duckdb/main/extension_helper.hpp"
+#include "duckdb/parser/parsed_data/copy_info.hpp"
+#include "duckdb/parallel/thread_context.hpp"
+#include "duckdb/execution/execution_context.hpp"
+#include "duckdb/execution/physical_operator.hpp"
+#include "duckdb/planner/bound_result_modifier.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+
+#include "spatial/common.hpp"
+#include "spatial/core/functions/copy.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/hilbert.hpp"
+#include "spatial/core/geometry/wkb_writer.hpp"
+
+#include "yyjson.h"
+
+namespace spatial {
+
+namespace core {
+
+using namespace duckdb_yyjson_spatial;
+
+//------------------------------------------------------------------------------
+// GeoParquet Copy Function
+//------------------------------------------------------------------------------
+// COPY ... TO (FORMAT GEOPARQUET) wraps the parquet copy function. Every GEOMETRY column is written as WKB,
+// followed by a "<column>_bbox" struct column holding the bounding box of each row. The bbox columns are
+// registered as a "covering" in the GeoParquet "geo" metadata, so that readers can prune row groups based
+// on the min/max statistics of the bbox columns instead of having to decode the WKB.
+// All other options are passed through to the parquet writer.
+
+struct GeoParquetBindData : public TableFunctionData {
+	CopyFunction parquet_function;
+	unique_ptr<FunctionData> parquet_bind_data;
+	// The types we pass on to the parquet writer
+	vector<LogicalType> parquet_types;
+	// Whether each input column is a GEOMETRY column
+	vector<bool> is_geometry;
+	// The index of the first WKB column in the parquet output, its bbox column follows it
+	idx_t primary_column = 0;
+	bool hilbert_sort = false;
+
+	explicit GeoParquetBindData(CopyFunction parquet_function_p) : parquet_function(std::move(parquet_function_p)) {
+	}
+};
+
+// When sorting, the converted rows are buffered until the end, together with the extent of their bounding boxes.
+// The rows are kept in a buffer managed collection, so they are spilled to disk if they do not fit in memory.
+struct HilbertSortBuffer {
+	unique_ptr<ColumnDataCollection> rows;
+	BoundingBox extent;
+
+	HilbertSortBuffer(ClientContext &context, const vector<LogicalType> &types)
+	    : rows(make_uniq<ColumnDataCollection>(BufferManager::GetBufferManager(context), types)) {
+	}
+
+	void Append(DataChunk &converted, idx_t bbox_column);
+	void Combine(HilbertSortBuffer &other);
+};
+
+struct GeoParquetLocalState : public LocalFunctionData {
+	unique_ptr<LocalFunctionData> parquet_state;
+	DataChunk converted;
+	unique_ptr<HilbertSortBuffer> sort_buffer;
+};
+
+struct GeoParquetGlobalState : public GlobalFunctionData {
+	unique_ptr<GlobalFunctionData> parquet_state;
+	mutex lock;
+	unique_ptr<HilbertSortBuffer> sort_buffer;
+};
+
+// A batch that was prepared by the parquet writer, or nothing if the rows were buffered for sorting instead
+struct GeoParquetPreparedBatch : public PreparedBatchData {
+	unique_ptr<PreparedBatchData> parquet_batch;
+};
+
+static const char *const BBOX_FIELDS[] = {"xmin", "ymin", "xmax", "ymax"};
+
+static LogicalType GetBBoxType() {
+	child_list_t<LogicalType> children;
+	for (auto field : BBOX_FIELDS) {
+		children.emplace_back(field, LogicalType::FLOAT);
+	}
+	return LogicalType::STRUCT(std::move(children));
+}
+
+//------------------------------------------------------------------------------
+// Bind
+//------------------------------------------------------------------------------
+
+static CopyFunction GetParquetCopyFunction(ClientContext &context) {
+	auto &catalog = Catalog::GetSystemCatalog(context);
+	auto entry =
+	    catalog.GetEntry<CopyFunctionCatalogEntry>(context, DEFAULT_SCHEMA, "parquet", OnEntryNotFound::RETURN_NULL);
+	if (!entry && ExtensionHelper::TryAutoLoadExtension(context, "parquet")) {
+		entry = catalog.GetEntry<CopyFunctionCatalogEntry>(context, DEFAULT_SCHEMA, "parquet",
+		                                                   OnEntryNotFound::RETURN_NULL);
+	}
+	if (!entry) {
+		throw MissingExtensionException("Writing GeoParquet requires the parquet extension to be loaded");
+	}
+	return entry->function;
+}
+
+// Build the GeoParquet "geo" file metadata
+static string GetGeoMetadata(const vector<string> &names, const vector<bool> &is_geometry, const string &crs) {
+	auto doc = yyjson_mut_doc_new(nullptr);
+	auto root = yyjson_mut_obj(doc);
+	yyjson_mut_doc_set_root(doc, root);
+
+	// The CRS is passed as PROJJSON, without it readers will assume OGC:CRS84
+	yyjson_doc *crs_doc = nullptr;
+	if (!crs.empty()) {
+		crs_doc = yyjson_read(crs.c_str(), crs.size(), 0);
+		if (!crs_doc || !yyjson_is_obj(yyjson_doc_get_root(crs_doc))) {
+			yyjson_doc_free(crs_doc);
+			yyjson_mut_doc_free(doc);
+			throw BinderException("CRS must be a PROJJSON object");
+		}
+	}
+
+	yyjson_mut_obj_add_str(doc, root, "version", "1.1.0");
+	auto columns = yyjson_mut_obj(doc);
+	bool has_primary = false;
+	for (idx_t col_idx = 0; col_idx < names.size(); col_idx++) {
+		if (!is_geometry[col_idx]) {
+			continue;
+		}
+		auto &name = names[col_idx];
+		if (!has_primary) {
+			yyjson_mut_obj_add_strcpy(doc, root, "primary_column", name.c_str());
+			has_primary = true;
+		}
+
+		auto column = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_str(doc, column, "encoding", "WKB");
+		yyjson_mut_obj_add_val(doc, column, "geometry_types", yyjson_mut_arr(doc));
+
+		auto bbox_name = name + "_bbox";
+		auto bbox = yyjson_mut_obj(doc);
+		for (auto field : BBOX_FIELDS) {
+			auto path = yyjson_mut_arr(doc);
+			yyjson_mut_arr_add_strcpy(doc, path, bbox_name.c_str());
+			yyjson_mut_arr_add_str(doc, path, field);
+			yyjson_mut_obj_add_val(doc, bbox, field, path);
+		}
+		auto covering = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, covering, "bbox", bbox);
+		yyjson_mut_obj_add_val(doc, column, "covering", covering);
+
+		if (crs_doc) {
+			yyjson_mut_obj_add_val(doc, column, "crs", yyjson_val_mut_copy(doc, yyjson_doc_get_root(crs_doc)));
+		}
+		yyjson_mut_obj_add_val(doc, columns, yyjson_mut_strcpy(doc, name.c_str()), column);
+	}
+	yyjson_mut_obj_add_val(doc, root, "columns", columns);
+
+	size_t json_size;
+	auto json_data = yyjson_mut_write(doc, 0, &json_size);
+	string result(json_data, json_size);
+	free(json_data);
+	yyjson_doc_free(crs_doc);
+	yyjson_mut_doc_free(doc);
+	return result;
+}
+
+static unique_ptr<FunctionData> Bind(ClientContext &context, CopyFunctionBindInput &input, const vector<string> &names,
+                                     const vector<LogicalType> &sql_types) {
+
+	auto bind_data = make_uniq<GeoParquetBindData>(GetParquetCopyFunction(context));
+
+	// Pick out our own options, and pass the rest on to the parquet writer
+	auto parquet_info = input.info.Copy();
+	string crs;
+	Value kv_metadata;
+	for (auto &option : input.info.options) {
+		auto loption = StringUtil::Lower(option.first);
+		if (loption == "hilbert_sort") {
+			bind_data->hilbert_sort =
+			    option.second.empty() || option.second.front().DefaultCastAs(LogicalType::BOOLEAN).GetValue<bool>();
+			parquet_info->options.erase(option.first);
+		} else if (loption == "crs") {
+			auto &set = option.second.front();
+			if (set.type().id() != LogicalTypeId::VARCHAR) {
+				throw BinderException("CRS must be a PROJJSON string");
+			}
+			crs = set.GetValue<string>();
+			parquet_info->options.erase(option.first);
+		} else if (loption == "kv_metadata") {
+			kv_metadata = option.second.front();
+			parquet_info->options.erase(option.first);
+		}
+	}
+
+	// Every GEOMETRY column is written as WKB followed by its bounding box
+	vector<string> parquet_names;
+	auto bbox_type = GetBBoxType();
+	bool has_geometry = false;
+	for (idx_t col_idx = 0; col_idx < sql_types.size(); col_idx++) {
+		auto is_geometry = sql_types[col_idx] == GeoTypes::GEOMETRY();
+		bind_data->is_geometry.push_back(is_geometry);
+		if (!is_geometry) {
+			parquet_names.push_back(names[col_idx]);
+			bind_data->parquet_types.push_back(sql_types[col_idx]);
+			continue;
+		}
+		if (!has_geometry) {
+			bind_data->primary_column = bind_data->parquet_types.size();
+			has_geometry = true;
+		}
+		auto bbox_name = names[col_idx] + "_bbox";
+		for (auto &name : names) {
+			if (StringUtil::CIEquals(name, bbox_name)) {
+				throw BinderException("Cannot write the bounding box of column \"%s\" to GeoParquet: a column named "
+				                      "\"%s\" already exists",
+				                      names[col_idx], bbox_name);
+			}
+		}
+		parquet_names.push_back(names[col_idx]);
+		bind_data->parquet_types.push_back(LogicalType::BLOB);
+		parquet_names.push_back(bbox_name);
+		bind_data->parquet_types.push_back(bbox_type);
+	}
+	if (!has_geometry) {
+		throw BinderException("GeoParquet output requires at least one GEOMETRY column");
+	}
+
+	// Add the "geo" metadata to any user provided key-value metadata
+	child_list_t<Value> metadata;
+	if (!kv_metadata.IsNull()) {
+		if (kv_metadata.type().id() != LogicalTypeId::STRUCT) {
+			throw BinderException("KV_METADATA must be a STRUCT");
+		}
+		auto &children = StructValue::GetChildren(kv_metadata);
+		for (idx_t i = 0; i < children.size(); i++) {
+			auto &key = StructType::GetChildName(kv_metadata.type(), i);
+			if (StringUtil::CIEquals(key, "geo")) {
+				throw BinderException("KV_METADATA cannot contain a \"geo\" key when writing GeoParquet");
+			}
+			metadata.emplace_back(key, children[i]);
+		}
+	}
+	metadata.emplace_back("geo", Value(GetGeoMetadata(names, bind_data->is_geometry, crs)));
+	parquet_info->options["kv_metadata"] = {Value::STRUCT(std::move(metadata))};
+
+	CopyFunctionBindInput parquet_input(*parquet_info);
+	bind_data->parquet_bind_data = bind_data->parquet_function.copy_to_bind(context, parquet_input, parquet_names,
+	                                                                        bind_data->parquet_types);
+	return std::move(bind_data);
+}
+
+//------------------------------------------------------------------------------
+// Init
+//------------------------------------------------------------------------------
+
+static unique_ptr<LocalFunctionData> InitLocal(ExecutionContext &context, FunctionData &bind_data_p) {
+	auto &bind_data = bind_data_p.Cast<GeoParquetBindData>();
+	auto local_state = make_uniq<GeoParquetLocalState>();
+	if (bind_data.hilbert_sort) {
+		local_state->sort_buffer = make_uniq<HilbertSortBuffer>(context.client, bind_data.parquet_types);
+	} else {
+		local_state->parquet_state =
+		    bind_data.parquet_function.copy_to_initialize_local(context, *bind_data.parquet_bind_data);
+	}
+	local_state->converted.Initialize(BufferAllocator::Get(context.client), bind_data.parquet_types);
+	return std::move(local_state);
+}
+
+static unique_ptr<GlobalFunctionData> InitGlobal(ClientContext &context, FunctionData &bind_data_p,
+                                                 const string &file_path) {
+	auto &bind_data = bind_data_p.Cast<GeoParquetBindData>();
+	auto global_state = make_uniq<GeoParquetGlobalState>();
+	global_state->parquet_state =
+	    bind_data.parquet_function.copy_to_initialize_global(context, *bind_data.parquet_bind_data, file_path);
+	if (bind_data.hilbert_sort) {
+		global_state->sort_buffer = make_uniq<HilbertSortBuffer>(context, bind_data.parquet_types);
+	}
+	return std::move(global_state);
+}
+
+//------------------------------------------------------------------------------
+// Sink
+//------------------------------------------------------------------------------
+
+static void ConvertGeometryColumn(Vector &source, Vector &wkb_vec, Vector &bbox_vec, idx_t count) {
+	UnifiedVectorFormat format;
+	source.ToUnifiedFormat(count, format);
+	auto geoms = UnifiedVectorFormat::GetData<geometry_t>(format);
+
+	auto wkb_data = FlatVector::GetData<string_t>(wkb_vec);
+	auto &bbox_children = StructVector::GetEntries(bbox_vec);
+	auto min_x = FlatVector::GetData<float>(*bbox_children[0]);
+	auto min_y = FlatVector::GetData<float>(*bbox_children[1]);
+	auto max_x = FlatVector::GetData<float>(*bbox_children[2]);
+	auto max_y = FlatVector::GetData<float>(*bbox_children[3]);
+
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = format.sel->get_index(i);
+		if (!format.validity.RowIsValid(idx)) {
+			FlatVector::SetNull(wkb_vec, i, true);
+			FlatVector::SetNull(bbox_vec, i, true);
+			continue;
+		}
+		auto &geom = geoms[idx];
+		wkb_data[i] = WKBWriter::Write(geom, wkb_vec);
+
+		// Empty geometries have no bounding box
+		BoundingBox bbox;
+		if (!GeometryFactory::TryGetSerializedBoundingBox(geom, bbox)) {
+			FlatVector::SetNull(bbox_vec, i, true);
+			continue;
+		}
+		// Round outwards, the box has to cover the geometry
+		min_x[i] = Utils::DoubleToFloatDown(bbox.minx);
+		min_y[i] = Utils::DoubleToFloatDown(bbox.miny);
+		max_x[i] = Utils::DoubleToFloatUp(bbox.maxx);
+		max_y[i] = Utils::DoubleToFloatUp(bbox.maxy);
+	}
+}
+
+static void ConvertChunk(const GeoParquetBindData &bind_data, DataChunk &input, DataChunk &output) {
+	output.Reset();
+	idx_t out_idx = 0;
+	for (idx_t col_idx = 0; col_idx < input.ColumnCount(); col_idx++) {
+		if (!bind_data.is_geometry[col_idx]) {
+			output.data[out_idx++].Reference(input.data[col_idx]);
+			continue;
+		}
+		auto &wkb_vec = output.data[out_idx++];
+		auto &bbox_vec = output.data[out_idx++];
+		ConvertGeometryColumn(input.data[col_idx], wkb_vec, bbox_vec, input.size());
+	}
+	output.SetCardinality(input);
+}
+
+static void Sink(ExecutionContext &context, FunctionData &bind_data_p, GlobalFunctionData &gstate_p,
+                 LocalFunctionData &lstate_p, DataChunk &input) {
+	auto &bind_data = bind_data_p.Cast<GeoParquetBindData>();
+	auto &gstate = gstate_p.Cast<GeoParquetGlobalState>();
+	auto &lstate = lstate_p.Cast<GeoParquetLocalState>();
+
+	ConvertChunk(bind_data, input, lstate.converted);
+
+	if (bind_data.hilbert_sort) {
+		lstate.sort_buffer->Append(lstate.converted, bind_data.primary_column + 1);
+		return;
+	}
+
+	bind_data.parquet_function.copy_to_sink(context, *bind_data.parquet_bind_data, *gstate.parquet_state,
+	                                        *lstate.parquet_state, lstate.converted);
+}
+
+//------------------------------------------------------------------------------
+// Combine
+//------------------------------------------------------------------------------
+
+static void Combine(ExecutionContext &context, FunctionData &bind_data_p, GlobalFunctionData &gstate_p,
+                    LocalFunctionData &lstate_p) {
+	auto &bind_data = bind_data_p.Cast<GeoParquetBindData>();
+	auto &gstate = gstate_p.Cast<GeoParquetGlobalState>();
+	auto &lstate = lstate_p.Cast<GeoParquetLocalState>();
+
+	if (bind_data.hilbert_sort) {
+		lock_guard<mutex> glock(gstate.lock);
+		gstate.sort_buffer->Combine(*lstate.sort_buffer);
+		return;
+	}
+
+	bind_data.parquet_function.copy_to_combine(context, *bind_data.parquet_bind_data, *gstate.parquet_state,
+	                                           *lstate.parquet_state);
+}
+
+//------------------------------------------------------------------------------
+// Batch
+//------------------------------------------------------------------------------
+// When insertion order has to be preserved, the parquet writer collects the rows into batches and writes them
+// in order. We convert each batch and hand it over to the parquet writer, or buffer it when sorting.
+
+static unique_ptr<PreparedBatchData> PrepareBatch(ClientContext &context, FunctionData &bind_data_p,
+                                                  GlobalFunctionData &gstate_p,
+                                                  unique_ptr<ColumnDataCollection> collection) {
+	auto &bind_data = bind_data_p.Cast<GeoParquetBindData>();
+	auto &gstate = gstate_p.Cast<GeoParquetGlobalState>();
+
+	DataChunk converted;
+	converted.Initialize(BufferAllocator::Get(context), bind_data.parquet_types);
+	auto result = make_uniq<GeoParquetPreparedBatch>();
+
+	if (bind_data.hilbert_sort) {
+		HilbertSortBuffer buffer(context, bind_data.parquet_types);
+		for (auto &chunk : collection->Chunks()) {
+			ConvertChunk(bind_data, chunk, converted);
+			buffer.Append(converted, bind_data.primary_column + 1);
+		}
+		lock_guard<mutex> glock(gstate.lock);
+		gstate.sort_buffer->Combine(buffer);
+		return std::move(result);
+	}
+
+	auto parquet_collection =
+	    make_uniq<ColumnDataCollection>(BufferManager::GetBufferManager(context), bind_data.parquet_types);
+	for (auto &chunk : collection->Chunks()) {
+		ConvertChunk(bind_data, chunk, converted);
+		parquet_collection->Append(converted);
+	}
+	collection.reset();
+	result->parquet_batch = bind_data.parquet_function.prepare_batch(
+	    context, *bind_data.parquet_bind_data, *gstate.parquet_state, std::move(parquet_collection));
+	return std::move(result);
+}
+
+static void FlushBatch(ClientContext &context, FunctionData &bind_data_p, GlobalFunctionData &gstate_p,
+                       PreparedBatchData &batch_p) {
+	auto &bind_data = bind_data_p.Cast<GeoParquetBindData>();
+	auto &gstate = gstate_p.Cast<GeoParquetGlobalState>();
+	auto &batch = batch_p.Cast<GeoParquetPreparedBatch>();
+	if (!batch.parquet_batch) {
+		// Buffered for sorting, written in Finalize
+		return;
+	}
+	bind_data.parquet_function.flush_batch(context, *bind_data.parquet_bind_data, *gstate.parquet_state,
+	                                       *batch.parquet_batch);
+}
+
+static idx_t DesiredBatchSize(ClientContext &context, FunctionData &bind_data_p) {
+	auto &bind_data = bind_data_p.Cast<GeoParquetBindData>();
+	return bind_data.parquet_function.desired_batch_size(context, *bind_data.parquet_bind_data);
+}
+
+//------------------------------------------------------------------------------
+// Hilbert Sort
+//------------------------------------------------------------------------------
+// Sorting the rows along a hilbert curve before writing them keeps the rows of each row group close together,
+// which makes the row group bounding boxes small and therefore useful for pruning. The curve is laid over the
+// extent of all the rows, so we can only compute the sort keys once all rows have been buffered. The rows are then
+// sorted with the same (external) sort that ORDER BY uses.
+
+void HilbertSortBuffer::Append(DataChunk &converted, idx_t bbox_column) {
+	auto &bbox_vec = converted.data[bbox_column];
+	auto &bbox_children = StructVector::GetEntries(bbox_vec);
+	auto min_x = FlatVector::GetData<float>(*bbox_children[0]);
+	auto min_y = FlatVector::GetData<float>(*bbox_children[1]);
+	auto max_x = FlatVector::GetData<float>(*bbox_children[2]);
+	auto max_y = FlatVector::GetData<float>(*bbox_children[3]);
+	for (idx_t i = 0; i < converted.size(); i++) {
+		if (FlatVector::IsNull(bbox_vec, i)) {
+			continue;
+		}
+		extent.minx = MinValue<double>(extent.minx, min_x[i]);
+		extent.miny = MinValue<double>(extent.miny, min_y[i]);
+		extent.maxx = MaxValue<double>(extent.maxx, max_x[i]);
+		extent.maxy = MaxValue<double>(extent.maxy, max_y[i]);
+	}
+	rows->Append(converted);
+}
+
+void HilbertSortBuffer::Combine(HilbertSortBuffer &other) {
+	extent.minx = MinValue(extent.minx, other.extent.minx);
+	extent.miny = MinValue(extent.miny, other.extent.miny);
+	extent.maxx = MaxValue(extent.maxx, other.extent.maxx);
+	extent.maxy = MaxValue(extent.maxy, other.extent.maxy);
+	rows->Combine(*other.rows);
+}
+
+static void WriteHilbertSorted(ClientContext &context, const GeoParquetBindData &bind_data,
+                               GeoParquetGlobalState &gstate) {
+	auto &buffer = *gstate.sort_buffer;
+	if (buffer.rows->Count() == 0) {
+		return;
+	}
+	auto &extent = buffer.extent;
+	auto bbox_column = bind_data.primary_column + 1;
+
+	// Sort by the hilbert value of the center of each row, rows without a bounding box go last.
+	// Ties are broken by the position of the row in the buffer, so that the output does not depend on the sort.
+	auto &buffer_manager = BufferManager::GetBufferManager(context);
+	vector<BoundOrderByNode> orders;
+	orders.emplace_back(OrderType::ASCENDING, OrderByNullType::NULLS_LAST,
+	                    make_uniq<BoundReferenceExpression>(LogicalType::UINTEGER, 0));
+	orders.emplace_back(OrderType::ASCENDING, OrderByNullType::NULLS_LAST,
+	                    make_uniq<BoundReferenceExpression>(LogicalType::UBIGINT, 1));
+	RowLayout payload_layout;
+	payload_layout.Initialize(bind_data.parquet_types);
+	GlobalSortState global_sort(buffer_manager, orders, payload_layout);
+	auto memory_limit = PhysicalOperator::GetMaxThreadMemory(context);
+	global_sort.external = ClientConfig::GetConfig(context).force_external || buffer.rows->SizeInBytes() > memory_limit;
+	LocalSortState local_sort;
+	local_sort.Initialize(global_sort, buffer_manager);
+
+	DataChunk keys;
+	keys.Initialize(Allocator::Get(context), {LogicalType::UINTEGER, LogicalType::UBIGINT});
+	uint64_t row_number = 0;
+	for (auto &chunk : buffer.rows->Chunks()) {
+		keys.Reset();
+		auto key_data = FlatVector::GetData<uint32_t>(keys.data[0]);
+		auto row_data = FlatVector::GetData<uint64_t>(keys.data[1]);
+		auto &bbox_vec = chunk.data[bbox_column];
+		auto &bbox_children = StructVector::GetEntries(bbox_vec);
+		auto min_x = FlatVector::GetData<float>(*bbox_children[0]);
+		auto min_y = FlatVector::GetData<float>(*bbox_children[1]);
+		auto max_x = FlatVector::GetData<float>(*bbox_children[2]);
+		auto max_y = FlatVector::GetData<float>(*bbox_children[3]);
+		for (idx_t i = 0; i < chunk.size(); i++) {
+			row_data[i] = row_number++;
+			if (FlatVector::IsNull(bbox_vec, i)) {
+				FlatVector::SetNull(keys.data[0], i, true);
+				continue;
+			}
+			auto center_x = (static_cast<double>(min_x[i]) + static_cast<double>(max_x[i])) / 2;
+			auto center_y = (static_cast<double>(min_y[i]) + static_cast<double>(max_y[i])) / 2;
+			key_data[i] = HilbertEncode(center_x, center_y, extent.minx, extent.miny, extent.maxx, extent.maxy);
+		}
+		keys.SetCardinality(chunk.size());
+		local_sort.SinkChunk(keys, chunk);
+		if (local_sort.SizeInBytes() >= memory_limit) {
+			local_sort.Sort(global_sort, true);
+		}
+	}
+	global_sort.AddLocalState(local_sort);
+	buffer.rows.reset();
+
+	global_sort.PrepareMergePhase();
+	while (global_sort.sorted_blocks.size() > 1) {
+		global_sort.InitializeMergeRound();
+		MergeSorter merge_sorter(global_sort, buffer_manager);
+		merge_sorter.PerformInMergeRound();
+		global_sort.CompleteMergeRound(false);
+	}
+
+	// Now write the rows in order
+	auto &parquet = bind_data.parquet_function;
+	ThreadContext thread(context);
+	ExecutionContext exec_context(context, thread, nullptr);
+	auto parquet_local = parquet.copy_to_initialize_local(exec_context, *bind_data.parquet_bind_data);
+
+	DataChunk sorted;
+	sorted.Initialize(BufferAllocator::Get(context), bind_data.parquet_types);
+	PayloadScanner scanner(global_sort);
+	while (true) {
+		sorted.Reset();
+		scanner.Scan(sorted);
+		if (sorted.size() == 0) {
+			break;
+		}
+		parquet.copy_to_sink(exec_context, *bind_data.parquet_bind_data, *gstate.parquet_state, *parquet_local,
+		                     sorted);
+	}
+	parquet.copy_to_combine(exec_context, *bind_data.parquet_bind_data, *gstate.parquet_state, *parquet_local);
+}
+
+//------------------------------------------------------------------------------
+// Finalize
+//------------------------------------------------------------------------------
+
+static void Finalize(ClientContext &context, FunctionData &bind_data_p, GlobalFunctionData &gstate_p) {
+	auto &bind_data = bind_data_p.Cast<GeoParquetBindData>();
+	auto &gstate = gstate_p.Cast<GeoParquetGlobalState>();
+
+	if (bind_data.hilbert_sort) {
+		WriteHilbertSorted(context, bind_data, gstate);
+	}
+	bind_data.parquet_function.copy_to_finalize(context, *bind_data.parquet_bind_data, *gstate.parquet_state);
+}
+
+// The same as the parquet writer
+static CopyFunctionExecutionMode ExecutionMode(bool preserve_insertion_order, bool supports_batch_index) {
+	if (!preserve_insertion_order) {
+		return CopyFunctionExecutionMode::PARALLEL_COPY_TO_FILE;
+	}
+	if (supports_batch_index) {
+		return CopyFunctionExecutionMode::BATCH_COPY_TO_FILE;
+	}
+	return CopyFunctionExecutionMode::REGULAR_COPY_TO_FILE;
+}
+
+//------------------------------------------------------------------------------
+// Register copy function
+//------------------------------------------------------------------------------
+void CoreCopyFunctions::RegisterGeoParquetCopyFunction(DatabaseInstance &db) {
+	CopyFunction info("GEOPARQUET");
+	info.copy_to_bind = Bind;
+	info.copy_to_initialize_local = InitLocal;
+	info.copy_to_initialize_global = InitGlobal;
+	info.copy_to_sink = Sink;
+	info.copy_to_combine = Combine;
+	info.copy_to_finalize = Finalize;
+	info.execution_mode = ExecutionMode;
+	info.prepare_batch = PrepareBatch;
+	info.flush_batch = FlushBatch;
+	info.desired_batch_size = DesiredBatchSize;
+
+	ExtensionUtil::RegisterFunction(db, info);
+}
+
+} // namespace core
+
+} // namespace spatial
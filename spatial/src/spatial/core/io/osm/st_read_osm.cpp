@@ -29,10 +29,16 @@ static int32_t ReadInt32BigEndian(data_ptr_t ptr) {
 // OSM Table Function
 //------------------------------------------------------------------------------
 
+// A rough number of bytes per entity in a PBF file, used to estimate the number of rows from the file size.
+// Most of a PBF file is dense nodes, which compress to a couple of bytes each, while ways and relations take up
+// considerably more space. The planet file averages somewhere around 8 bytes per entity.
+static constexpr idx_t OSM_PBF_BYTES_PER_ENTITY = 8;
+
 struct BindData : TableFunctionData {
 	string file_name;
+	idx_t file_size;
 
-	BindData(string file_name) : file_name(file_name) {
+	BindData(string file_name, idx_t file_size) : file_name(file_name), file_size(file_size) {
 	}
 };
 
@@ -90,7 +96,11 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindIn
 	}
 
 	auto file_name = StringValue::Get(input.inputs[0]);
-	auto result = make_uniq<BindData>(file_name);
+
+	// Only the file size is needed to estimate the cardinality
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto handle = fs.OpenFile(file_name, FileFlags::FILE_FLAGS_READ, FileLockType::READ_LOCK);
+	auto result = make_uniq<BindData>(file_name, handle->GetFileSize());
 	return std::move(result);
 }
 
@@ -839,6 +849,14 @@ static idx_t GetBatchIndex(ClientContext &context, const FunctionData *bind_data
 	return state.block->block_idx;
 }
 
+static unique_ptr<NodeStatistics> GetCardinality(ClientContext &context, const FunctionData *data) {
+	auto &bind_data = data->Cast<BindData>();
+	auto result = make_uniq<NodeStatistics>();
+	result->has_estimated_cardinality = true;
+	result->estimated_cardinality = bind_data.file_size / OSM_PBF_BYTES_PER_ENTITY;
+	return result;
+}
+
 static unique_ptr<TableRef> ReadOsmPBFReplacementScan(ClientContext &context, const string &table_name,
                                                       ReplacementScanData *data) {
 	// Check if the table name ends with .osm.pbf
@@ -861,6 +879,7 @@ void CoreTableFunctions::RegisterOsmTableFunction(DatabaseInstance &db) {
 
 	read.get_batch_index = GetBatchIndex;
 	read.table_scan_progress = Progress;
+	read.cardinality = GetCardinality;
 
 	ExtensionUtil::RegisterFunction(db, read);
 
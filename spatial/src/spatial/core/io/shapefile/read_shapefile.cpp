@@ -9,12 +9,17 @@
 #include "duckdb/function/copy_function.hpp"
 #include "duckdb/parser/parsed_data/copy_info.hpp"
 #include "duckdb/parser/parsed_data/create_copy_function_info.hpp"
+#include "duckdb/planner/filter/conjunction_filter.hpp"
+#include "duckdb/planner/filter/constant_filter.hpp"
+#include "duckdb/planner/table_filter.hpp"
+#include "duckdb/common/operator/comparison_operators.hpp"
 
 #include "spatial/common.hpp"
 #include "spatial/core/io/shapefile.hpp"
 #include "spatial/core/functions/table.hpp"
 #include "spatial/core/types.hpp"
-#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/cursor.hpp"
+#include "spatial/core/geometry/geometry.hpp"
 
 #include "shapefil.h"
 #include "utf8proc_wrapper.hpp"
@@ -36,9 +41,21 @@ struct ShapefileBindData : TableFunctionData {
 	AttributeEncoding attribute_encoding;
 	vector<LogicalType> attribute_types;
 
+	// The layout of the DBF records, so that we can decode attributes straight from the raw record bytes
+	idx_t dbf_record_count;
+	idx_t dbf_header_length;
+	idx_t dbf_record_length;
+	vector<idx_t> field_offsets;
+	vector<idx_t> field_widths;
+
+	// The location of each record in the SHP file, as read from the SHX index
+	vector<uint32_t> record_offsets;
+	vector<uint32_t> record_sizes;
+
 	explicit ShapefileBindData(string file_name_p)
-	    : file_name(std::move(file_name_p)), shape_count(0),
-	      shape_type(0), min_bound {0, 0, 0, 0}, max_bound {0, 0, 0, 0}, attribute_encoding(AttributeEncoding::LATIN1) {
+	    : file_name(std::move(file_name_p)), shape_count(0), shape_type(0), min_bound {0, 0, 0, 0},
+	      max_bound {0, 0, 0, 0}, attribute_encoding(AttributeEncoding::LATIN1), dbf_record_count(0),
+	      dbf_header_length(0), dbf_record_length(0) {
 	}
 };
 
@@ -67,6 +84,10 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindIn
 		throw InvalidInputException("Invalid shape type %d", result->shape_type);
 	}
 
+	// Keep the record index around, so that we can read the raw records directly
+	result->record_offsets.assign(shp_handle->panRecOffset, shp_handle->panRecOffset + result->shape_count);
+	result->record_sizes.assign(shp_handle->panRecSize, shp_handle->panRecSize + result->shape_count);
+
 	auto base_name = file_name.substr(0, file_name.find_last_of('.'));
 
 	// A standards compliant shapefile should use ISO-8859-1 encoding for attributes, but it can be overridden
@@ -114,6 +135,10 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindIn
 	// auto code_page = DBFGetCodePage(dbf_handle.get());
 	// if(!has_cpg_file && code_page != 0) { }
 
+	result->dbf_record_count = DBFGetRecordCount(dbf_handle.get());
+	result->dbf_header_length = dbf_handle->nHeaderLength;
+	result->dbf_record_length = dbf_handle->nRecordLength;
+
 	// Then return the attributes
 	auto field_count = DBFGetFieldCount(dbf_handle.get());
 	char field_name[12]; // Max field name length is 11 + null terminator
@@ -153,6 +178,8 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindIn
 		names.emplace_back(field_name);
 		return_types.push_back(type);
 		result->attribute_types.push_back(type);
+		result->field_offsets.push_back(dbf_handle->panFieldOffset[i]);
+		result->field_widths.push_back(dbf_handle->panFieldSize[i]);
 	}
 
 	// Always return geometry last
@@ -177,178 +204,492 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindIn
 //------------------------------------------------------------------------------
 
 struct ShapefileGlobalState : public GlobalTableFunctionState {
+	mutex lock;
+	int shape_count;
 	int shape_idx;
-	SHPHandlePtr shp_handle;
-	DBFHandlePtr dbf_handle;
-	GeometryFactory factory;
+	idx_t batch_idx;
+	atomic<idx_t> shapes_read;
+	idx_t max_threads;
 	vector<idx_t> column_ids;
+	optional_ptr<TableFilterSet> filters;
+
+	explicit ShapefileGlobalState(int shape_count_p, idx_t max_threads_p, vector<idx_t> column_ids_p,
+	                              optional_ptr<TableFilterSet> filters_p)
+	    : shape_count(shape_count_p), shape_idx(0), batch_idx(0), shapes_read(0), max_threads(max_threads_p),
+	      column_ids(std::move(column_ids_p)), filters(filters_p) {
+	}
+
+	idx_t MaxThreads() const override {
+		return max_threads;
+	}
+
+	// Claim the next batch of (at most STANDARD_VECTOR_SIZE) records, returns false if there are no records left
+	bool GetNextBatch(int &record_start, int &record_count, idx_t &record_batch_idx) {
+		lock_guard<mutex> glock(lock);
+		if (shape_idx >= shape_count) {
+			return false;
+		}
+		record_start = shape_idx;
+		record_count = std::min<int>(STANDARD_VECTOR_SIZE, shape_count - shape_idx);
+		record_batch_idx = batch_idx++;
+		shape_idx += record_count;
+		return true;
+	}
+};
+
+static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext &context, TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<ShapefileBindData>();
+
+	// Every batch is a full vector of records, so there is no point in having more threads than batches
+	auto batch_count = (bind_data.shape_count + STANDARD_VECTOR_SIZE - 1) / STANDARD_VECTOR_SIZE;
+	auto max_threads = std::min<idx_t>(context.db->NumberOfThreads(), MaxValue<idx_t>(batch_count, 1));
+
+	auto result =
+	    make_uniq<ShapefileGlobalState>(bind_data.shape_count, max_threads, input.column_ids, input.filters);
+	return std::move(result);
+}
+
+//------------------------------------------------------------------------------
+// Init Local
+//------------------------------------------------------------------------------
+
+// Every thread reads the raw SHP and DBF records of its batches through its own file handles
+struct ShapefileLocalState : public LocalTableFunctionState {
+	Allocator &allocator;
+	unique_ptr<FileHandle> shp_file;
+	unique_ptr<FileHandle> dbf_file;
+	AllocatedData shp_buffer;
+	AllocatedData dbf_buffer;
+	idx_t batch_idx;
+	// The offset of each selected record in the shp buffer
+	uint32_t shape_records[STANDARD_VECTOR_SIZE];
+	// Scratch space, reused between records to avoid allocations
+	vector<uint32_t> polygon_part_starts;
+	vector<data_t> conversion_buffer;
 
-	explicit ShapefileGlobalState(ClientContext &context, const string &file_name, vector<idx_t> column_ids_p)
-	    : shape_idx(0), factory(BufferAllocator::Get(context)), column_ids(std::move(column_ids_p)) {
+	explicit ShapefileLocalState(ClientContext &context, const ShapefileBindData &bind_data)
+	    : allocator(BufferAllocator::Get(context)), batch_idx(0) {
 		auto &fs = FileSystem::GetFileSystem(context);
+		auto &file_name = bind_data.file_name;
 
-		shp_handle = OpenSHPFile(fs, file_name);
+		shp_file = fs.OpenFile(file_name, FileFlags::FILE_FLAGS_READ);
 
 		// Remove file extension and replace with .dbf
 		auto dot_idx = file_name.find_last_of('.');
 		auto base_name = file_name.substr(0, dot_idx);
-		dbf_handle = OpenDBFFile(fs, base_name + ".dbf");
+		dbf_file = fs.OpenFile(base_name + ".dbf", FileFlags::FILE_FLAGS_READ);
+		dbf_buffer = allocator.Allocate(bind_data.dbf_record_length * STANDARD_VECTOR_SIZE);
+	}
+
+	void ReserveShapeBuffer(idx_t size) {
+		if (shp_buffer.GetSize() < size) {
+			shp_buffer = allocator.Allocate(MaxValue<idx_t>(size, shp_buffer.GetSize() * 2));
+		}
 	}
 };
 
-static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext &context, TableFunctionInitInput &input) {
+static unique_ptr<LocalTableFunctionState> InitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+                                                     GlobalTableFunctionState *global_state) {
 	auto &bind_data = input.bind_data->Cast<ShapefileBindData>();
-	auto result = make_uniq<ShapefileGlobalState>(context, bind_data.file_name, input.column_ids);
+	auto result = make_uniq<ShapefileLocalState>(context.client, bind_data);
 	return std::move(result);
 }
 
 //------------------------------------------------------------------------------
 // Geometry Conversion
 //------------------------------------------------------------------------------
+// We dont go through shapelib (or the geometry factory) to read the shapes. Instead we read the raw records of a batch
+// into a buffer, and write the vertices straight into the serialized GEOMETRY blobs, as the shapefile XY vertex layout
+// is the same as ours.
+
+// The size of the header (+ padding) of a serialized geometry
+static constexpr uint32_t SERIALIZED_HEADER_SIZE = 8;
+// The size of the (float) 2D bounding box of a serialized geometry
+static constexpr uint32_t SERIALIZED_BBOX_SIZE = 16;
+
+struct ShapeRecord {
+	const_data_ptr_t data;
+	uint32_t size;
+
+	void Check(idx_t required_size, idx_t record_idx) const {
+		if (required_size > size) {
+			throw InvalidInputException("Shapefile record %llu is truncated (expected at least %llu bytes, got %u)",
+			                            record_idx, required_size, size);
+		}
+	}
+};
+
+static void WriteHeader(Cursor &cursor, GeometryType type, bool has_bbox) {
+	GeometryProperties properties;
+	properties.SetBBox(has_bbox);
+	cursor.Write<GeometryType>(type);
+	cursor.Write<GeometryProperties>(properties);
+	cursor.Write<uint16_t>(0);
+	// Pad with 4 bytes
+	cursor.Write<uint32_t>(0);
+}
+
+static void WriteBBox(Cursor &cursor, const BoundingBox &bbox) {
+	cursor.Write<float>(Utils::DoubleToFloatDown(bbox.minx));
+	cursor.Write<float>(Utils::DoubleToFloatDown(bbox.miny));
+	cursor.Write<float>(Utils::DoubleToFloatUp(bbox.maxx));
+	cursor.Write<float>(Utils::DoubleToFloatUp(bbox.maxy));
+}
+
+// Copy raw XY vertices into the blob, optionally extending the bounding box
+static void WriteVertices(Cursor &cursor, const_data_ptr_t vertices, uint32_t count, bool update_bounds,
+                          BoundingBox &bbox) {
+	auto byte_size = count * 2 * sizeof(double);
+	memcpy(cursor.GetPtr(), vertices, byte_size);
+	cursor.Skip(byte_size);
+	if (update_bounds) {
+		for (uint32_t i = 0; i < count; i++) {
+			auto x = Load<double>(vertices + i * 2 * sizeof(double));
+			auto y = Load<double>(vertices + i * 2 * sizeof(double) + sizeof(double));
+			bbox.minx = std::min(bbox.minx, x);
+			bbox.miny = std::min(bbox.miny, y);
+			bbox.maxx = std::max(bbox.maxx, x);
+			bbox.maxy = std::max(bbox.maxy, y);
+		}
+	}
+}
+
+// Layout of the parts of a multi-part (polyline/polygon) record
+struct ShapeParts {
+	uint32_t part_count;
+	uint32_t vertex_count;
+	const_data_ptr_t part_starts;
+	const_data_ptr_t vertices;
+
+	ShapeParts(const ShapeRecord &record, idx_t record_idx) {
+		// type (4) + bbox (32) + part count (4) + vertex count (4)
+		record.Check(44, record_idx);
+		part_count = Load<uint32_t>(record.data + 36);
+		vertex_count = Load<uint32_t>(record.data + 40);
+		record.Check(44 + idx_t(part_count) * 4 + idx_t(vertex_count) * 16, record_idx);
+		part_starts = record.data + 44;
+		vertices = part_starts + part_count * 4;
+		for (uint32_t i = 0; i < part_count; i++) {
+			if (PartStart(i) > PartEnd(i) || PartEnd(i) > vertex_count) {
+				throw InvalidInputException("Shapefile record %llu has invalid part offsets", record_idx);
+			}
+		}
+	}
+
+	uint32_t PartStart(uint32_t part_idx) const {
+		return Load<uint32_t>(part_starts + part_idx * 4);
+	}
+
+	uint32_t PartEnd(uint32_t part_idx) const {
+		return part_idx == part_count - 1 ? vertex_count : PartStart(part_idx + 1);
+	}
+
+	uint32_t PartSize(uint32_t part_idx) const {
+		return PartEnd(part_idx) - PartStart(part_idx);
+	}
+
+	const_data_ptr_t PartVertices(uint32_t part_idx) const {
+		return vertices + PartStart(part_idx) * 16;
+	}
+
+	double X(uint32_t vertex_idx) const {
+		return Load<double>(vertices + vertex_idx * 16);
+	}
+
+	double Y(uint32_t vertex_idx) const {
+		return Load<double>(vertices + vertex_idx * 16 + 8);
+	}
+};
 
 struct ConvertPoint {
-	static Geometry Convert(SHPObjectPtr &shape, GeometryFactory &factory) {
-		return Point(factory.allocator, shape->padfX[0], shape->padfY[0]);
+	static string_t Convert(Vector &result, const ShapeRecord &record, idx_t record_idx, vector<uint32_t> &) {
+		record.Check(20, record_idx);
+		auto blob = StringVector::EmptyString(result, SERIALIZED_HEADER_SIZE + 8 + 16);
+		Cursor cursor(blob);
+		BoundingBox bbox;
+		WriteHeader(cursor, GeometryType::POINT, false);
+		cursor.Write(SerializedGeometryType::POINT);
+		cursor.Write<uint32_t>(1);
+		WriteVertices(cursor, record.data + 4, 1, false, bbox);
+		blob.Finalize();
+		return blob;
 	}
 };
 
 struct ConvertLineString {
-	static Geometry Convert(SHPObjectPtr &shape, GeometryFactory &factory) {
-		if (shape->nParts == 1) {
+	static string_t Convert(Vector &result, const ShapeRecord &record, idx_t record_idx, vector<uint32_t> &) {
+		ShapeParts parts(record, record_idx);
+		auto has_bbox = parts.vertex_count > 0;
+		BoundingBox bbox;
+
+		if (parts.part_count == 1) {
 			// Single LineString
-			auto vertices = VertexArray::Create(factory.allocator, shape->nVertices, false, false);
-			for (int i = 0; i < shape->nVertices; i++) {
-				vertices.Set(i, shape->padfX[i], shape->padfY[i]);
-			}
-			return LineString(vertices);
-		} else {
-			// MultiLineString
-			MultiLineString multi_line_string(factory.allocator, shape->nParts, false, false);
-			auto start = shape->panPartStart[0];
-			for (int i = 0; i < shape->nParts; i++) {
-				auto end = i == shape->nParts - 1 ? shape->nVertices : shape->panPartStart[i + 1];
-				auto line_size = end - start;
-				auto vertices = VertexArray::Create(factory.allocator, line_size, false, false);
-				for (int j = 0; j < line_size; j++) {
-					auto offset = start + j;
-					vertices.Set(j, shape->padfX[offset], shape->padfY[offset]);
-				}
-				multi_line_string[i] = LineString(vertices);
-				start = end;
+			auto size = SERIALIZED_HEADER_SIZE + (has_bbox ? SERIALIZED_BBOX_SIZE : 0) + 8 + parts.vertex_count * 16;
+			auto blob = StringVector::EmptyString(result, size);
+			Cursor cursor(blob);
+			WriteHeader(cursor, GeometryType::LINESTRING, has_bbox);
+			auto bbox_ptr = cursor.GetPtr();
+			cursor.Skip(has_bbox ? SERIALIZED_BBOX_SIZE : 0);
+			cursor.Write(SerializedGeometryType::LINESTRING);
+			cursor.Write<uint32_t>(parts.vertex_count);
+			WriteVertices(cursor, parts.vertices, parts.vertex_count, true, bbox);
+			if (has_bbox) {
+				cursor.SetPtr(bbox_ptr);
+				WriteBBox(cursor, bbox);
 			}
-			return multi_line_string;
+			blob.Finalize();
+			return blob;
 		}
+
+		// MultiLineString
+		auto size = SERIALIZED_HEADER_SIZE + (has_bbox ? SERIALIZED_BBOX_SIZE : 0) + 8 + parts.part_count * 8 +
+		            parts.vertex_count * 16;
+		auto blob = StringVector::EmptyString(result, size);
+		Cursor cursor(blob);
+		WriteHeader(cursor, GeometryType::MULTILINESTRING, has_bbox);
+		auto bbox_ptr = cursor.GetPtr();
+		cursor.Skip(has_bbox ? SERIALIZED_BBOX_SIZE : 0);
+		cursor.Write(SerializedGeometryType::MULTILINESTRING);
+		cursor.Write<uint32_t>(parts.part_count);
+		for (uint32_t part_idx = 0; part_idx < parts.part_count; part_idx++) {
+			cursor.Write(SerializedGeometryType::LINESTRING);
+			cursor.Write<uint32_t>(parts.PartSize(part_idx));
+			WriteVertices(cursor, parts.PartVertices(part_idx), parts.PartSize(part_idx), true, bbox);
+		}
+		if (has_bbox) {
+			cursor.SetPtr(bbox_ptr);
+			WriteBBox(cursor, bbox);
+		}
+		blob.Finalize();
+		return blob;
 	}
 };
 
 struct ConvertPolygon {
-	static Geometry Convert(SHPObjectPtr &shape, GeometryFactory &factory) {
+	// The size of a serialized polygon made up of the parts in [part_start, part_end)
+	static uint32_t GetPolygonSize(const ShapeParts &parts, uint32_t part_start, uint32_t part_end) {
+		auto ring_count = part_end - part_start;
+		uint32_t size = 8 + ring_count * 4 + (ring_count % 2 == 1 ? 4 : 0);
+		for (auto ring_idx = part_start; ring_idx < part_end; ring_idx++) {
+			size += parts.PartSize(ring_idx) * 16;
+		}
+		return size;
+	}
+
+	static void WritePolygon(Cursor &cursor, const ShapeParts &parts, uint32_t part_start, uint32_t part_end,
+	                         BoundingBox &bbox) {
+		auto ring_count = part_end - part_start;
+		cursor.Write(SerializedGeometryType::POLYGON);
+		cursor.Write<uint32_t>(ring_count);
+		for (auto ring_idx = part_start; ring_idx < part_end; ring_idx++) {
+			cursor.Write<uint32_t>(parts.PartSize(ring_idx));
+		}
+		if (ring_count % 2 == 1) {
+			// Write padding (4 bytes)
+			cursor.Write<uint32_t>(0);
+		}
+		for (auto ring_idx = part_start; ring_idx < part_end; ring_idx++) {
+			// Only the shell contributes to the bounding box
+			WriteVertices(cursor, parts.PartVertices(ring_idx), parts.PartSize(ring_idx), ring_idx == part_start,
+			              bbox);
+		}
+	}
+
+	static string_t Convert(Vector &result, const ShapeRecord &record, idx_t record_idx,
+	                        vector<uint32_t> &polygon_part_starts) {
+		ShapeParts parts(record, record_idx);
+
 		// First off, check if there are more than one polygon.
 		// Each polygon is identified by a part with clockwise winding order
 		// we calculate the winding order by checking the sign of the area
-		vector<int> polygon_part_starts;
-		for (int i = 0; i < shape->nParts; i++) {
-			auto start = shape->panPartStart[i];
-			auto end = i == shape->nParts - 1 ? shape->nVertices : shape->panPartStart[i + 1];
+		polygon_part_starts.clear();
+		for (uint32_t i = 0; i < parts.part_count; i++) {
+			auto start = parts.PartStart(i);
+			auto end = parts.PartEnd(i);
 			double area = 0;
-			for (int j = start; j < end - 1; j++) {
-				area += (shape->padfX[j] * shape->padfY[j + 1]) - (shape->padfX[j + 1] * shape->padfY[j]);
+			for (uint32_t j = start; j + 1 < end; j++) {
+				area += (parts.X(j) * parts.Y(j + 1)) - (parts.X(j + 1) * parts.Y(j));
 			}
 			if (area < 0) {
 				polygon_part_starts.push_back(i);
 			}
 		}
+
 		if (polygon_part_starts.size() < 2) {
 			// Single polygon, every part is an interior ring
 			// Even if the polygon is counter-clockwise (which should not happen for shapefiles).
 			// we still fall back and convert it to a single polygon.
-			Polygon polygon(factory.allocator, shape->nParts, false, false);
-			auto start = shape->panPartStart[0];
-			for (int i = 0; i < shape->nParts; i++) {
-				auto end = i == shape->nParts - 1 ? shape->nVertices : shape->panPartStart[i + 1];
-				auto &ring = polygon[i];
-				auto ring_size = end - start;
-				ring.Resize(factory.allocator, ring_size);
-				for (int j = 0; j < ring_size; j++) {
-					auto offset = start + j;
-					ring.Set(j, shape->padfX[offset], shape->padfY[offset]);
-				}
-				start = end;
+			auto has_bbox = parts.vertex_count > 0;
+			auto size = SERIALIZED_HEADER_SIZE + (has_bbox ? SERIALIZED_BBOX_SIZE : 0) +
+			            GetPolygonSize(parts, 0, parts.part_count);
+			auto blob = StringVector::EmptyString(result, size);
+			Cursor cursor(blob);
+			BoundingBox bbox;
+			WriteHeader(cursor, GeometryType::POLYGON, has_bbox);
+			auto bbox_ptr = cursor.GetPtr();
+			cursor.Skip(has_bbox ? SERIALIZED_BBOX_SIZE : 0);
+			WritePolygon(cursor, parts, 0, parts.part_count, bbox);
+			if (has_bbox) {
+				cursor.SetPtr(bbox_ptr);
+				WriteBBox(cursor, bbox);
 			}
-			return polygon;
-		} else {
-			// MultiPolygon
-			MultiPolygon multi_polygon(factory.allocator, polygon_part_starts.size(), false, false);
-			for (size_t polygon_idx = 0; polygon_idx < polygon_part_starts.size(); polygon_idx++) {
-				auto part_start = polygon_part_starts[polygon_idx];
-				auto part_end = polygon_idx == polygon_part_starts.size() - 1 ? shape->nParts
-				                                                              : polygon_part_starts[polygon_idx + 1];
-
-				Polygon polygon(factory.allocator, part_end - part_start, false, false);
-
-				for (auto ring_idx = part_start; ring_idx < part_end; ring_idx++) {
-					auto start = shape->panPartStart[ring_idx];
-					auto end = ring_idx == shape->nParts - 1 ? shape->nVertices : shape->panPartStart[ring_idx + 1];
-					auto &ring = polygon[ring_idx - part_start];
-					auto ring_size = end - start;
-					ring.Resize(factory.allocator, ring_size);
-					for (int j = 0; j < ring_size; j++) {
-						auto offset = start + j;
-						ring.Set(j, shape->padfX[offset], shape->padfY[offset]);
-					}
-				}
-				multi_polygon[polygon_idx] = polygon;
+			blob.Finalize();
+			return blob;
+		}
+
+		// MultiPolygon
+		uint32_t size = SERIALIZED_HEADER_SIZE + SERIALIZED_BBOX_SIZE + 8;
+		uint32_t vertex_count = 0;
+		for (idx_t polygon_idx = 0; polygon_idx < polygon_part_starts.size(); polygon_idx++) {
+			auto part_start = polygon_part_starts[polygon_idx];
+			auto part_end = polygon_idx == polygon_part_starts.size() - 1 ? parts.part_count
+			                                                              : polygon_part_starts[polygon_idx + 1];
+			size += GetPolygonSize(parts, part_start, part_end);
+			for (auto ring_idx = part_start; ring_idx < part_end; ring_idx++) {
+				vertex_count += parts.PartSize(ring_idx);
 			}
-			return multi_polygon;
 		}
+		auto has_bbox = vertex_count > 0;
+		if (!has_bbox) {
+			size -= SERIALIZED_BBOX_SIZE;
+		}
+		auto blob = StringVector::EmptyString(result, size);
+		Cursor cursor(blob);
+		BoundingBox bbox;
+		WriteHeader(cursor, GeometryType::MULTIPOLYGON, has_bbox);
+		auto bbox_ptr = cursor.GetPtr();
+		cursor.Skip(has_bbox ? SERIALIZED_BBOX_SIZE : 0);
+		cursor.Write(SerializedGeometryType::MULTIPOLYGON);
+		cursor.Write<uint32_t>(polygon_part_starts.size());
+		for (idx_t polygon_idx = 0; polygon_idx < polygon_part_starts.size(); polygon_idx++) {
+			auto part_start = polygon_part_starts[polygon_idx];
+			auto part_end = polygon_idx == polygon_part_starts.size() - 1 ? parts.part_count
+			                                                              : polygon_part_starts[polygon_idx + 1];
+			WritePolygon(cursor, parts, part_start, part_end, bbox);
+		}
+		if (has_bbox) {
+			cursor.SetPtr(bbox_ptr);
+			WriteBBox(cursor, bbox);
+		}
+		blob.Finalize();
+		return blob;
 	}
 };
 
 struct ConvertMultiPoint {
-	static Geometry Convert(SHPObjectPtr &shape, GeometryFactory &factory) {
-		MultiPoint multi_point(factory.allocator, shape->nVertices, false, false);
-		for (int i = 0; i < shape->nVertices; i++) {
-			multi_point[i] = Point(factory.allocator, shape->padfX[i], shape->padfY[i]);
+	static string_t Convert(Vector &result, const ShapeRecord &record, idx_t record_idx, vector<uint32_t> &) {
+		// type (4) + bbox (32) + vertex count (4)
+		record.Check(40, record_idx);
+		auto vertex_count = Load<uint32_t>(record.data + 36);
+		record.Check(40 + idx_t(vertex_count) * 16, record_idx);
+		auto vertices = record.data + 40;
+
+		auto has_bbox = vertex_count > 0;
+		auto size = SERIALIZED_HEADER_SIZE + (has_bbox ? SERIALIZED_BBOX_SIZE : 0) + 8 + vertex_count * (8 + 16);
+		auto blob = StringVector::EmptyString(result, size);
+		Cursor cursor(blob);
+		BoundingBox bbox;
+		WriteHeader(cursor, GeometryType::MULTIPOINT, has_bbox);
+		auto bbox_ptr = cursor.GetPtr();
+		cursor.Skip(has_bbox ? SERIALIZED_BBOX_SIZE : 0);
+		cursor.Write(SerializedGeometryType::MULTIPOINT);
+		cursor.Write<uint32_t>(vertex_count);
+		for (uint32_t i = 0; i < vertex_count; i++) {
+			cursor.Write(SerializedGeometryType::POINT);
+			cursor.Write<uint32_t>(1);
+			WriteVertices(cursor, vertices + i * 16, 1, true, bbox);
 		}
-		return multi_point;
+		if (has_bbox) {
+			cursor.SetPtr(bbox_ptr);
+			WriteBBox(cursor, bbox);
+		}
+		blob.Finalize();
+		return blob;
 	}
 };
 
-template <class OP>
-static void ConvertGeomLoop(Vector &result, int record_start, idx_t count, SHPHandle &shp_handle,
-                            GeometryFactory &factory) {
-	for (idx_t result_idx = 0; result_idx < count; result_idx++) {
-		auto shape = SHPObjectPtr(SHPReadObject(shp_handle, record_start++));
-		if (shape->nSHPType == SHPT_NULL) {
-			FlatVector::SetNull(result, result_idx, true);
-		} else {
-			// TODO: Handle Z and M
-			FlatVector::GetData<string_t>(result)[result_idx] =
-			    factory.Serialize(result, OP::Convert(shape, factory), false, false);
+// Read the raw records needed for the selected rows of a batch into the local buffer
+static void ReadShapeRecords(const ShapefileBindData &bind_data, ShapefileLocalState &lstate, int record_start,
+                             const SelectionVector &sel, idx_t count) {
+	auto first_record = record_start + sel.get_index(0);
+	auto last_record = record_start + sel.get_index(count - 1);
+
+	// Usually the records are stored back to back, in which case we can read them all in one go
+	bool is_sequential = true;
+	idx_t total_size = 0;
+	idx_t prev_offset = 0;
+	for (idx_t i = 0; i < count; i++) {
+		auto record_idx = record_start + sel.get_index(i);
+		total_size += bind_data.record_sizes[record_idx] + 8;
+		if (bind_data.record_offsets[record_idx] < prev_offset) {
+			is_sequential = false;
+		}
+		prev_offset = bind_data.record_offsets[record_idx];
+	}
+	auto span_start = bind_data.record_offsets[first_record];
+	auto span_end = bind_data.record_offsets[last_record] + bind_data.record_sizes[last_record] + 8;
+
+	// If the records are sparse (e.g. because of a selective filter), read them one by one instead
+	if (is_sequential && span_end > span_start && span_end - span_start <= 2 * total_size) {
+		lstate.ReserveShapeBuffer(span_end - span_start);
+		lstate.shp_file->Read(lstate.shp_buffer.get(), span_end - span_start, span_start);
+		for (idx_t i = 0; i < count; i++) {
+			auto record_idx = record_start + sel.get_index(i);
+			lstate.shape_records[i] = bind_data.record_offsets[record_idx] - span_start + 8;
+		}
+	} else {
+		lstate.ReserveShapeBuffer(total_size);
+		idx_t buffer_offset = 0;
+		for (idx_t i = 0; i < count; i++) {
+			auto record_idx = record_start + sel.get_index(i);
+			auto record_size = bind_data.record_sizes[record_idx] + 8;
+			lstate.shp_file->Read(lstate.shp_buffer.get() + buffer_offset, record_size,
+			                      bind_data.record_offsets[record_idx]);
+			lstate.shape_records[i] = buffer_offset + 8;
+			buffer_offset += record_size;
 		}
 	}
 }
 
-static void ConvertGeometryVector(Vector &result, int record_start, idx_t count, SHPHandle shp_handle,
-                                  GeometryFactory &factory, int geom_type) {
-	switch (geom_type) {
-	case SHPT_NULL:
+static void ConvertGeometryVector(Vector &result, const ShapefileBindData &bind_data, ShapefileLocalState &lstate,
+                                  int record_start, const SelectionVector &sel, idx_t count) {
+	if (bind_data.shape_type == SHPT_NULL) {
 		FlatVector::Validity(result).SetAllInvalid(count);
-		break;
-	case SHPT_POINT:
-		ConvertGeomLoop<ConvertPoint>(result, record_start, count, shp_handle, factory);
-		break;
-	case SHPT_ARC:
-		ConvertGeomLoop<ConvertLineString>(result, record_start, count, shp_handle, factory);
-		break;
-	case SHPT_POLYGON:
-		ConvertGeomLoop<ConvertPolygon>(result, record_start, count, shp_handle, factory);
-		break;
-	case SHPT_MULTIPOINT:
-		ConvertGeomLoop<ConvertMultiPoint>(result, record_start, count, shp_handle, factory);
-		break;
-	default:
-		throw InvalidInputException("Shape type %d not supported", geom_type);
+		return;
+	}
+
+	ReadShapeRecords(bind_data, lstate, record_start, sel, count);
+
+	auto result_data = FlatVector::GetData<string_t>(result);
+	for (idx_t result_idx = 0; result_idx < count; result_idx++) {
+		auto record_idx = record_start + sel.get_index(result_idx);
+		ShapeRecord record {lstate.shp_buffer.get() + lstate.shape_records[result_idx],
+		                    bind_data.record_sizes[record_idx]};
+		record.Check(4, record_idx);
+
+		// Every record has its own shape type, which is either the same as the file or null
+		auto shape_type = Load<int32_t>(record.data);
+		switch (shape_type) {
+		case SHPT_NULL:
+			FlatVector::SetNull(result, result_idx, true);
+			break;
+		case SHPT_POINT:
+			result_data[result_idx] = ConvertPoint::Convert(result, record, record_idx, lstate.polygon_part_starts);
+			break;
+		case SHPT_ARC:
+			result_data[result_idx] =
+			    ConvertLineString::Convert(result, record, record_idx, lstate.polygon_part_starts);
+			break;
+		case SHPT_POLYGON:
+			result_data[result_idx] = ConvertPolygon::Convert(result, record, record_idx, lstate.polygon_part_starts);
+			break;
+		case SHPT_MULTIPOINT:
+			result_data[result_idx] =
+			    ConvertMultiPoint::Convert(result, record, record_idx, lstate.polygon_part_starts);
+			break;
+		default:
+			throw InvalidInputException("Shape type %d not supported", shape_type);
+		}
 	}
 }
 
@@ -356,165 +697,430 @@ static void ConvertGeometryVector(Vector &result, int record_start, idx_t count,
 // Attribute Conversion
 //------------------------------------------------------------------------------
 
+// A batch of raw DBF records, read in a single I/O request
+struct DBFRecordBatch {
+	const_data_ptr_t records;
+	idx_t record_count;
+	idx_t record_length;
+	const vector<idx_t> &field_offsets;
+	const vector<idx_t> &field_widths;
+
+	// Get the value of a field with the leading and trailing whitespace trimmed (as shapelib does)
+	// Returns false if the record is missing from the DBF file
+	bool GetField(idx_t record_idx, idx_t field_idx, const char *&value, idx_t &len) const {
+		if (record_idx >= record_count) {
+			return false;
+		}
+		auto ptr = const_char_ptr_cast(records + record_idx * record_length + field_offsets[field_idx]);
+		auto end = ptr + field_widths[field_idx];
+		// Values are padded with spaces, but may also be terminated early with a null byte
+		auto nul = static_cast<const char *>(memchr(ptr, '\0', end - ptr));
+		if (nul) {
+			end = nul;
+		}
+		while (ptr < end && *ptr == ' ') {
+			ptr++;
+		}
+		while (end > ptr && *(end - 1) == ' ') {
+			end--;
+		}
+		value = ptr;
+		len = end - ptr;
+		return true;
+	}
+};
+
+// Numeric fields are null if they are blank or filled with asterisks
+static bool IsNumericFieldNull(const char *value, idx_t len) {
+	return len == 0 || value[0] == '*';
+}
+
+// Copy a field into a null-terminated buffer so that we can use the C parsing functions
+static const char *TerminateField(const char *value, idx_t len, char (&buffer)[256]) {
+	len = MinValue<idx_t>(len, sizeof(buffer) - 1);
+	memcpy(buffer, value, len);
+	buffer[len] = '\0';
+	return buffer;
+}
+
 struct ConvertBlobAttribute {
 	using TYPE = string_t;
-	static string_t Convert(Vector &result, DBFHandle dbf_handle, int record_idx, int field_idx) {
-		auto value = DBFReadStringAttribute(dbf_handle, record_idx, field_idx);
-		return StringVector::AddString(result, const_char_ptr_cast(value));
+	static bool IsNull(const char *, idx_t len) {
+		return len == 0;
+	}
+	static string_t Convert(Vector &result, const char *value, idx_t len) {
+		return StringVector::AddStringOrBlob(result, value, len);
 	}
 };
 
 struct ConvertIntegerAttribute {
 	using TYPE = int32_t;
-	static int32_t Convert(Vector &, DBFHandle dbf_handle, int record_idx, int field_idx) {
-		return DBFReadIntegerAttribute(dbf_handle, record_idx, field_idx);
+	static bool IsNull(const char *value, idx_t len) {
+		return IsNumericFieldNull(value, len);
+	}
+	static int32_t Convert(Vector &, const char *value, idx_t len) {
+		char buffer[256];
+		return static_cast<int32_t>(std::strtol(TerminateField(value, len, buffer), nullptr, 10));
 	}
 };
 
 struct ConvertBigIntAttribute {
 	using TYPE = int64_t;
-	static int64_t Convert(Vector &, DBFHandle dbf_handle, int record_idx, int field_idx) {
-		return static_cast<int64_t>(DBFReadDoubleAttribute(dbf_handle, record_idx, field_idx));
+	static bool IsNull(const char *value, idx_t len) {
+		return IsNumericFieldNull(value, len);
+	}
+	static int64_t Convert(Vector &, const char *value, idx_t len) {
+		char buffer[256];
+		auto str = TerminateField(value, len, buffer);
+		char *end = nullptr;
+		auto result = static_cast<int64_t>(std::strtoll(str, &end, 10));
+		if (*end == '.' || *end == 'e' || *end == 'E') {
+			// Not an integer after all, go through double like shapelib would
+			return static_cast<int64_t>(std::strtod(str, nullptr));
+		}
+		return result;
 	}
 };
 
 struct ConvertDoubleAttribute {
 	using TYPE = double;
-	static double Convert(Vector &, DBFHandle dbf_handle, int record_idx, int field_idx) {
-		return DBFReadDoubleAttribute(dbf_handle, record_idx, field_idx);
+	static bool IsNull(const char *value, idx_t len) {
+		return IsNumericFieldNull(value, len);
+	}
+	static double Convert(Vector &, const char *value, idx_t len) {
+		char buffer[256];
+		return std::strtod(TerminateField(value, len, buffer), nullptr);
 	}
 };
 
 struct ConvertDateAttribute {
 	using TYPE = date_t;
-	static date_t Convert(Vector &, DBFHandle dbf_handle, int record_idx, int field_idx) {
+	static bool IsNull(const char *value, idx_t len) {
+		// Null dates are stored as "00000000"
+		return len == 0 || (len >= 8 && strncmp(value, "00000000", 8) == 0);
+	}
+	static date_t Convert(Vector &, const char *value, idx_t len) {
 		// XBase stores dates as 8-char strings (without separators)
-		// but DuckDB expects a date string with separators.
-		auto value = DBFReadStringAttribute(dbf_handle, record_idx, field_idx);
-		char date_with_separator[11];
-		memcpy(date_with_separator, value, 4);
-		date_with_separator[4] = '-';
-		memcpy(date_with_separator + 5, value + 4, 2);
-		date_with_separator[7] = '-';
-		memcpy(date_with_separator + 8, value + 6, 2);
-		date_with_separator[10] = '\0';
-		return Date::FromString(date_with_separator);
+		int32_t parts[3] = {0, 0, 0};
+		int32_t part_widths[3] = {4, 2, 2};
+		idx_t pos = 0;
+		for (idx_t part_idx = 0; part_idx < 3; part_idx++) {
+			for (int32_t i = 0; i < part_widths[part_idx]; i++, pos++) {
+				if (pos >= len || !StringUtil::CharacterIsDigit(value[pos])) {
+					throw InvalidInputException("Invalid date value '%s' in DBF file", string(value, len));
+				}
+				parts[part_idx] = parts[part_idx] * 10 + (value[pos] - '0');
+			}
+		}
+		if (!Date::IsValid(parts[0], parts[1], parts[2])) {
+			throw InvalidInputException("Invalid date value '%s' in DBF file", string(value, len));
+		}
+		return Date::FromDate(parts[0], parts[1], parts[2]);
 	}
 };
 
 struct ConvertBooleanAttribute {
 	using TYPE = bool;
-	static bool Convert(Vector &result, DBFHandle dbf_handle, int record_idx, int field_idx) {
-		return *DBFReadLogicalAttribute(dbf_handle, record_idx, field_idx) == 'T';
+	static bool IsNull(const char *value, idx_t len) {
+		// Null booleans are stored as "?"
+		return len > 0 && value[0] == '?';
+	}
+	static bool Convert(Vector &, const char *value, idx_t len) {
+		return len > 0 && (value[0] == 'T' || value[0] == 't' || value[0] == 'Y' || value[0] == 'y');
 	}
 };
 
 template <class OP>
-static void ConvertAttributeLoop(Vector &result, int record_start, idx_t count, DBFHandle dbf_handle, int field_idx) {
-	int record_idx = record_start;
+static void ConvertAttributeLoop(Vector &result, const DBFRecordBatch &batch, idx_t field_idx,
+                                 const SelectionVector &sel, idx_t count) {
+	auto result_data = FlatVector::GetData<typename OP::TYPE>(result);
+	const char *value;
+	idx_t len;
 	for (idx_t row_idx = 0; row_idx < count; row_idx++) {
-		if (DBFIsAttributeNULL(dbf_handle, record_idx, field_idx)) {
+		if (!batch.GetField(sel.get_index(row_idx), field_idx, value, len) || OP::IsNull(value, len)) {
 			FlatVector::SetNull(result, row_idx, true);
 		} else {
-			FlatVector::GetData<typename OP::TYPE>(result)[row_idx] =
-			    OP::Convert(result, dbf_handle, record_idx, field_idx);
+			result_data[row_idx] = OP::Convert(result, value, len);
 		}
-		record_idx++;
 	}
 }
 
-static void ConvertStringAttributeLoop(Vector &result, int record_start, idx_t count, DBFHandle dbf_handle,
-                                       int field_idx, AttributeEncoding attribute_encoding) {
-	int record_idx = record_start;
-	vector<data_t> conversion_buffer;
+static void ConvertStringAttributeLoop(Vector &result, const DBFRecordBatch &batch, idx_t field_idx,
+                                       const SelectionVector &sel, idx_t count, AttributeEncoding attribute_encoding,
+                                       vector<data_t> &conversion_buffer) {
+	auto result_data = FlatVector::GetData<string_t>(result);
+	const char *value;
+	idx_t len;
 	for (idx_t row_idx = 0; row_idx < count; row_idx++) {
-		if (DBFIsAttributeNULL(dbf_handle, record_idx, field_idx)) {
+		// Empty strings are considered NULL
+		if (!batch.GetField(sel.get_index(row_idx), field_idx, value, len) || len == 0) {
 			FlatVector::SetNull(result, row_idx, true);
+			continue;
+		}
+		string_t result_str;
+		if (attribute_encoding == AttributeEncoding::LATIN1) {
+			conversion_buffer.resize(len * 2); // worst case (all non-ascii chars)
+			auto out_len = EncodingUtil::LatinToUTF8Buffer(const_data_ptr_cast(value), len, conversion_buffer.data());
+			result_str = StringVector::AddString(result, const_char_ptr_cast(conversion_buffer.data()), out_len);
 		} else {
-			auto string_bytes = DBFReadStringAttribute(dbf_handle, record_idx, field_idx);
-			string_t result_str;
-			if (attribute_encoding == AttributeEncoding::LATIN1) {
-				conversion_buffer.reserve(strlen(string_bytes) * 2 + 1); // worst case (all non-ascii chars)
-				auto out_len =
-				    EncodingUtil::LatinToUTF8Buffer(const_data_ptr_cast(string_bytes), conversion_buffer.data());
-				result_str = StringVector::AddString(result, const_char_ptr_cast(conversion_buffer.data()), out_len);
-			} else {
-				result_str = StringVector::AddString(result, const_char_ptr_cast(string_bytes));
-			}
-			if (!Utf8Proc::IsValid(result_str.GetDataUnsafe(), result_str.GetSize())) {
-				throw InvalidInputException("Could not decode VARCHAR field as valid UTF-8, try passing "
-				                            "encoding='blob' to skip decoding of string attributes");
-			}
-			FlatVector::GetData<string_t>(result)[row_idx] = result_str;
+			result_str = StringVector::AddString(result, value, len);
+		}
+		if (!Utf8Proc::IsValid(result_str.GetDataUnsafe(), result_str.GetSize())) {
+			throw InvalidInputException("Could not decode VARCHAR field as valid UTF-8, try passing "
+			                            "encoding='blob' to skip decoding of string attributes");
 		}
-		record_idx++;
+		result_data[row_idx] = result_str;
 	}
 }
 
-static void ConvertAttributeVector(Vector &result, int record_start, idx_t count, DBFHandle dbf_handle, int field_idx,
-                                   AttributeEncoding attribute_encoding) {
+static void ConvertAttributeVector(Vector &result, const DBFRecordBatch &batch, idx_t field_idx,
+                                   const SelectionVector &sel, idx_t count, AttributeEncoding attribute_encoding,
+                                   vector<data_t> &conversion_buffer) {
 	switch (result.GetType().id()) {
 	case LogicalTypeId::BLOB:
-		ConvertAttributeLoop<ConvertBlobAttribute>(result, record_start, count, dbf_handle, field_idx);
+		ConvertAttributeLoop<ConvertBlobAttribute>(result, batch, field_idx, sel, count);
 		break;
 	case LogicalTypeId::VARCHAR:
-		ConvertStringAttributeLoop(result, record_start, count, dbf_handle, field_idx, attribute_encoding);
+		ConvertStringAttributeLoop(result, batch, field_idx, sel, count, attribute_encoding, conversion_buffer);
 		break;
 	case LogicalTypeId::INTEGER:
-		ConvertAttributeLoop<ConvertIntegerAttribute>(result, record_start, count, dbf_handle, field_idx);
+		ConvertAttributeLoop<ConvertIntegerAttribute>(result, batch, field_idx, sel, count);
 		break;
 	case LogicalTypeId::BIGINT:
-		ConvertAttributeLoop<ConvertBigIntAttribute>(result, record_start, count, dbf_handle, field_idx);
+		ConvertAttributeLoop<ConvertBigIntAttribute>(result, batch, field_idx, sel, count);
 		break;
 	case LogicalTypeId::DOUBLE:
-		ConvertAttributeLoop<ConvertDoubleAttribute>(result, record_start, count, dbf_handle, field_idx);
+		ConvertAttributeLoop<ConvertDoubleAttribute>(result, batch, field_idx, sel, count);
 		break;
 	case LogicalTypeId::DATE:
-		ConvertAttributeLoop<ConvertDateAttribute>(result, record_start, count, dbf_handle, field_idx);
+		ConvertAttributeLoop<ConvertDateAttribute>(result, batch, field_idx, sel, count);
 		break;
 	case LogicalTypeId::BOOLEAN:
-		ConvertAttributeLoop<ConvertBooleanAttribute>(result, record_start, count, dbf_handle, field_idx);
+		ConvertAttributeLoop<ConvertBooleanAttribute>(result, batch, field_idx, sel, count);
 		break;
 	default:
 		throw InvalidInputException("Attribute type %s not supported", result.GetType().ToString());
 	}
 }
 
+static void ConvertRowIdVector(Vector &result, int record_start, const SelectionVector &sel, idx_t count) {
+	auto result_data = FlatVector::GetData<int64_t>(result);
+	for (idx_t row_idx = 0; row_idx < count; row_idx++) {
+		result_data[row_idx] = record_start + static_cast<int64_t>(sel.get_index(row_idx));
+	}
+}
+
+//------------------------------------------------------------------------------
+// Filter Pushdown
+//------------------------------------------------------------------------------
+// Filters are evaluated on the decoded (flat) vectors. Each function takes the currently selected rows
+// and narrows the selection down in place, returning the new number of selected rows.
+
+template <class T, class OP>
+static idx_t TemplatedFilterSelection(Vector &vec, const T &constant, SelectionVector &sel, idx_t count) {
+	auto data = FlatVector::GetData<T>(vec);
+	auto &validity = FlatVector::Validity(vec);
+	idx_t result_count = 0;
+	for (idx_t i = 0; i < count; i++) {
+		auto row_idx = sel.get_index(i);
+		if (validity.RowIsValid(row_idx) && OP::Operation(data[row_idx], constant)) {
+			sel.set_index(result_count++, row_idx);
+		}
+	}
+	return result_count;
+}
+
+template <class T>
+static idx_t TemplatedFilterSelection(Vector &vec, const T &constant, ExpressionType comparison_type,
+                                      SelectionVector &sel, idx_t count) {
+	switch (comparison_type) {
+	case ExpressionType::COMPARE_EQUAL:
+		return TemplatedFilterSelection<T, Equals>(vec, constant, sel, count);
+	case ExpressionType::COMPARE_NOTEQUAL:
+		return TemplatedFilterSelection<T, NotEquals>(vec, constant, sel, count);
+	case ExpressionType::COMPARE_LESSTHAN:
+		return TemplatedFilterSelection<T, LessThan>(vec, constant, sel, count);
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		return TemplatedFilterSelection<T, LessThanEquals>(vec, constant, sel, count);
+	case ExpressionType::COMPARE_GREATERTHAN:
+		return TemplatedFilterSelection<T, GreaterThan>(vec, constant, sel, count);
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		return TemplatedFilterSelection<T, GreaterThanEquals>(vec, constant, sel, count);
+	default:
+		throw InternalException("Unsupported comparison type in ST_ReadSHP filter pushdown");
+	}
+}
+
+static idx_t ConstantFilterSelection(Vector &vec, const ConstantFilter &filter, SelectionVector &sel, idx_t count) {
+	auto &constant = filter.constant;
+	switch (vec.GetType().InternalType()) {
+	case PhysicalType::BOOL:
+		return TemplatedFilterSelection<bool>(vec, constant.GetValueUnsafe<bool>(), filter.comparison_type, sel,
+		                                      count);
+	case PhysicalType::INT32:
+		return TemplatedFilterSelection<int32_t>(vec, constant.GetValueUnsafe<int32_t>(), filter.comparison_type,
+		                                         sel, count);
+	case PhysicalType::INT64:
+		return TemplatedFilterSelection<int64_t>(vec, constant.GetValueUnsafe<int64_t>(), filter.comparison_type,
+		                                         sel, count);
+	case PhysicalType::DOUBLE:
+		return TemplatedFilterSelection<double>(vec, constant.GetValueUnsafe<double>(), filter.comparison_type, sel,
+		                                        count);
+	case PhysicalType::VARCHAR: {
+		auto &str = StringValue::Get(constant);
+		return TemplatedFilterSelection<string_t>(vec, string_t(str.c_str(), str.size()), filter.comparison_type,
+		                                          sel, count);
+	}
+	default:
+		throw InternalException("Unsupported type in ST_ReadSHP filter pushdown: %s", vec.GetType().ToString());
+	}
+}
+
+static idx_t FilterSelection(Vector &vec, const TableFilter &filter, SelectionVector &sel, idx_t count) {
+	switch (filter.filter_type) {
+	case TableFilterType::CONSTANT_COMPARISON:
+		return ConstantFilterSelection(vec, filter.Cast<ConstantFilter>(), sel, count);
+	case TableFilterType::IS_NULL:
+	case TableFilterType::IS_NOT_NULL: {
+		auto &validity = FlatVector::Validity(vec);
+		auto keep_valid = filter.filter_type == TableFilterType::IS_NOT_NULL;
+		idx_t result_count = 0;
+		for (idx_t i = 0; i < count; i++) {
+			auto row_idx = sel.get_index(i);
+			if (validity.RowIsValid(row_idx) == keep_valid) {
+				sel.set_index(result_count++, row_idx);
+			}
+		}
+		return result_count;
+	}
+	case TableFilterType::CONJUNCTION_AND: {
+		auto &and_filter = filter.Cast<ConjunctionAndFilter>();
+		for (auto &child_filter : and_filter.child_filters) {
+			count = FilterSelection(vec, *child_filter, sel, count);
+		}
+		return count;
+	}
+	case TableFilterType::CONJUNCTION_OR: {
+		auto &or_filter = filter.Cast<ConjunctionOrFilter>();
+		// Evaluate every branch on the input selection, and keep the rows that match any of them
+		bool matches[STANDARD_VECTOR_SIZE] = {false};
+		SelectionVector child_sel(STANDARD_VECTOR_SIZE);
+		for (auto &child_filter : or_filter.child_filters) {
+			for (idx_t i = 0; i < count; i++) {
+				child_sel.set_index(i, sel.get_index(i));
+			}
+			auto child_count = FilterSelection(vec, *child_filter, child_sel, count);
+			for (idx_t i = 0; i < child_count; i++) {
+				matches[child_sel.get_index(i)] = true;
+			}
+		}
+		idx_t result_count = 0;
+		for (idx_t i = 0; i < count; i++) {
+			auto row_idx = sel.get_index(i);
+			if (matches[row_idx]) {
+				sel.set_index(result_count++, row_idx);
+			}
+		}
+		return result_count;
+	}
+	default:
+		throw InternalException("Unsupported filter type in ST_ReadSHP filter pushdown");
+	}
+}
+
 //------------------------------------------------------------------------------
 // Execute
 //------------------------------------------------------------------------------
 
+static void ConvertColumn(const ShapefileBindData &bind_data, ShapefileLocalState &lstate, const DBFRecordBatch &batch,
+                          Vector &col_vec, idx_t column_id, int record_start, const SelectionVector &sel,
+                          idx_t count) {
+	if (column_id == COLUMN_IDENTIFIER_ROW_ID) {
+		ConvertRowIdVector(col_vec, record_start, sel, count);
+	} else if (column_id == bind_data.attribute_types.size()) {
+		// The geometry is always last
+		ConvertGeometryVector(col_vec, bind_data, lstate, record_start, sel, count);
+	} else {
+		ConvertAttributeVector(col_vec, batch, column_id, sel, count, bind_data.attribute_encoding,
+		                       lstate.conversion_buffer);
+	}
+}
+
 static void Execute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
 	auto &bind_data = input.bind_data->Cast<ShapefileBindData>();
 	auto &gstate = input.global_state->Cast<ShapefileGlobalState>();
+	auto &lstate = input.local_state->Cast<ShapefileLocalState>();
 
-	// Reset the buffer allocator
-	gstate.factory.allocator.Reset();
+	// Do we need to read any attributes at all?
+	bool has_attributes = false;
+	for (auto &column_id : gstate.column_ids) {
+		if (column_id != COLUMN_IDENTIFIER_ROW_ID && column_id < bind_data.attribute_types.size()) {
+			has_attributes = true;
+		}
+	}
 
-	// Calculate how many record we can fit in the output
-	auto output_size = std::min<int>(STANDARD_VECTOR_SIZE, bind_data.shape_count - gstate.shape_idx);
-	int record_start = gstate.shape_idx;
-	for (auto col_idx = 0; col_idx < output.ColumnCount(); col_idx++) {
+	while (true) {
+		// Claim the next batch of records
+		int record_start = 0;
+		int batch_size = 0;
+		if (!gstate.GetNextBatch(record_start, batch_size, lstate.batch_idx)) {
+			output.SetCardinality(0);
+			return;
+		}
 
-		// Projected column indices
-		auto projected_col_idx = gstate.column_ids[col_idx];
+		// Read all the DBF records in the batch in one go
+		idx_t dbf_record_count = 0;
+		if (has_attributes && static_cast<idx_t>(record_start) < bind_data.dbf_record_count) {
+			dbf_record_count = MinValue<idx_t>(batch_size, bind_data.dbf_record_count - record_start);
+			lstate.dbf_file->Read(lstate.dbf_buffer.get(), dbf_record_count * bind_data.dbf_record_length,
+			                      bind_data.dbf_header_length + record_start * bind_data.dbf_record_length);
+		}
+		DBFRecordBatch batch {lstate.dbf_buffer.get(), dbf_record_count,
+		                      bind_data.dbf_record_length, bind_data.field_offsets, bind_data.field_widths};
 
-		auto &col_vec = output.data[col_idx];
-		if (col_vec.GetType() == GeoTypes::GEOMETRY()) {
-			ConvertGeometryVector(col_vec, record_start, output_size, gstate.shp_handle.get(), gstate.factory,
-			                      bind_data.shape_type);
-		} else {
-			// The geometry is always last, so we can use the projected column index directly
-			auto field_idx = projected_col_idx;
-			ConvertAttributeVector(col_vec, record_start, output_size, gstate.dbf_handle.get(), (int)field_idx,
-			                       bind_data.attribute_encoding);
+		// Decode the filtered columns first, and use them to narrow down the selection
+		SelectionVector sel(STANDARD_VECTOR_SIZE);
+		for (idx_t i = 0; i < static_cast<idx_t>(batch_size); i++) {
+			sel.set_index(i, i);
+		}
+		idx_t count = batch_size;
+		if (gstate.filters) {
+			for (auto &entry : gstate.filters->filters) {
+				auto &col_vec = output.data[entry.first];
+				ConvertColumn(bind_data, lstate, batch, col_vec, gstate.column_ids[entry.first], record_start,
+				              *FlatVector::IncrementalSelectionVector(), batch_size);
+				count = FilterSelection(col_vec, *entry.second, sel, count);
+				if (count == 0) {
+					break;
+				}
+			}
+		}
+
+		// Update the progress
+		gstate.shapes_read += batch_size;
+
+		if (count == 0) {
+			// Nothing in this batch passed the filters, move on to the next one
+			output.Reset();
+			continue;
+		}
+
+		// Now decode the remaining columns, but only for the selected records
+		for (idx_t col_idx = 0; col_idx < output.ColumnCount(); col_idx++) {
+			auto &col_vec = output.data[col_idx];
+			if (gstate.filters && gstate.filters->filters.find(col_idx) != gstate.filters->filters.end()) {
+				if (count != static_cast<idx_t>(batch_size)) {
+					col_vec.Slice(sel, count);
+				}
+				continue;
+			}
+			ConvertColumn(bind_data, lstate, batch, col_vec, gstate.column_ids[col_idx], record_start, sel, count);
 		}
-	}
-	// Update the shape index
-	gstate.shape_idx += output_size;
 
-	// Set the cardinality of the output
-	output.SetCardinality(output_size);
+		// Set the cardinality of the output
+		output.SetCardinality(count);
+		return;
+	}
 }
 
 //------------------------------------------------------------------------------
@@ -527,16 +1133,27 @@ static double GetProgress(ClientContext &context, const FunctionData *bind_data_
 	auto &gstate = global_state->Cast<ShapefileGlobalState>();
 	auto &bind_data = bind_data_p->Cast<ShapefileBindData>();
 
-	return (double)gstate.shape_idx / (double)bind_data.shape_count;
+	if (bind_data.shape_count == 0) {
+		return 100;
+	}
+	return 100 * ((double)gstate.shapes_read / (double)bind_data.shape_count);
+}
+
+static idx_t GetBatchIndex(ClientContext &context, const FunctionData *bind_data_p,
+                           LocalTableFunctionState *local_state, GlobalTableFunctionState *global_state) {
+	auto &lstate = local_state->Cast<ShapefileLocalState>();
+	return lstate.batch_idx;
 }
 
 static unique_ptr<NodeStatistics> GetCardinality(ClientContext &context, const FunctionData *data) {
 	auto &bind_data = data->Cast<ShapefileBindData>();
 	auto result = make_uniq<NodeStatistics>();
 
-	// This is the maximum number of shapes in a single file
+	// The header tells us exactly how many shapes there are
 	result->has_max_cardinality = true;
 	result->max_cardinality = bind_data.shape_count;
+	result->has_estimated_cardinality = true;
+	result->estimated_cardinality = bind_data.shape_count;
 
 	return result;
 }
@@ -559,12 +1176,14 @@ static unique_ptr<TableRef> GetReplacementScan(ClientContext &context, const str
 // Register table function
 //------------------------------------------------------------------------------
 void CoreTableFunctions::RegisterShapefileTableFunction(DatabaseInstance &db) {
-	TableFunction read_func("ST_ReadSHP", {LogicalType::VARCHAR}, Execute, Bind, InitGlobal);
+	TableFunction read_func("ST_ReadSHP", {LogicalType::VARCHAR}, Execute, Bind, InitGlobal, InitLocal);
 
 	read_func.named_parameters["encoding"] = LogicalType::VARCHAR;
 	read_func.table_scan_progress = GetProgress;
+	read_func.get_batch_index = GetBatchIndex;
 	read_func.cardinality = GetCardinality;
 	read_func.projection_pushdown = true;
+	read_func.filter_pushdown = true;
 	ExtensionUtil::RegisterFunction(db, read_func);
 
 	// Replacement scan
@@ -4,6 +4,7 @@
 #include "spatial/common.hpp"
 #include "spatial/core/functions/aggregate.hpp"
 #include "spatial/core/functions/cast.hpp"
+#include "spatial/core/functions/copy.hpp"
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/table.hpp"
 #include "spatial/core/functions/macros.hpp"
@@ -20,6 +21,7 @@ void CoreModule::Register(DatabaseInstance &db) {
 	CoreCastFunctions::Register(db);
 	CoreTableFunctions::Register(db);
 	CoreAggregateFunctions::Register(db);
+	CoreCopyFunctions::Register(db);
 	CoreOptimizerRules::Register(db);
     CoreScalarMacros::Register(db);
 }
@@ -1,17 +1,33 @@
 #include "duckdb/catalog/catalog_entry/scalar_function_catalog_entry.hpp"
 #include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/common/multi_file_reader.hpp"
 #include "duckdb/optimizer/optimizer_extension.hpp"
+#include "duckdb/planner/expression/bound_cast_expression.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
 #include "duckdb/planner/expression/bound_comparison_expression.hpp"
 #include "duckdb/planner/expression/bound_conjunction_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
 #include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression/bound_unnest_expression.hpp"
 #include "duckdb/planner/logical_operator.hpp"
 #include "duckdb/planner/operator/logical_any_join.hpp"
 #include "duckdb/planner/operator/logical_comparison_join.hpp"
 #include "duckdb/planner/operator/logical_filter.hpp"
 #include "duckdb/planner/operator/logical_get.hpp"
 #include "duckdb/planner/operator/logical_join.hpp"
+#include "duckdb/planner/operator/logical_unnest.hpp"
+#include "duckdb/planner/filter/conjunction_filter.hpp"
+#include "duckdb/planner/filter/constant_filter.hpp"
+#include "duckdb/planner/filter/struct_filter.hpp"
 #include "spatial/common.hpp"
 #include "spatial/core/optimizer_rules.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/io/geoparquet.hpp"
+
+#include <algorithm>
+#include <cmath>
 
 namespace spatial {
 
@@ -29,6 +45,21 @@ namespace core {
 //	All spatial predicates (except st_disjoint) imply an intersection of the
 //  bounding boxes of the two geometries.
 //
+//  When the "spatial_join_grid_size" setting is set, joins between two GEOMETRY
+//  columns are instead partitioned over a uniform grid with cells of that size
+//  (PBSM, "partition based spatial-merge join"). Each row is unnested into the
+//  grid cells its bounding box overlaps, the two sides are hash joined on the
+//  cell, and every pair is only kept in the cell that contains its reference
+//  point, so pairs that share multiple cells are not reported twice:
+//
+//		SELECT * FROM
+//			(SELECT *, UNNEST(ST_GridCells(a.geom, <size>)) AS cell FROM a) AS a JOIN
+//			(SELECT *, UNNEST(ST_GridCells(b.geom, <size>)) AS cell FROM b) AS b ON a.cell = b.cell
+//		WHERE ST_GridReferenceCell(a.geom, b.geom, <size>) = a.cell AND <predicate>
+//
+//  Unlike the range join, the hash join partitions both sides and spills them
+//  to disk when they don't fit in memory, and joins the partitions in parallel.
+//
 class RangeJoinSpatialPredicateRewriter : public OptimizerExtension {
 public:
 	RangeJoinSpatialPredicateRewriter() {
@@ -78,7 +109,121 @@ public:
 		return true;
 	}
 
-	static void TryOptimize(ClientContext &context, OptimizerExtensionInfo *info, unique_ptr<LogicalOperator> &plan) {
+	static ScalarFunction GetFunction(ClientContext &context, const string &name, const vector<LogicalType> &args) {
+		auto &catalog = Catalog::GetSystemCatalog(context);
+		auto &func_set = catalog.GetEntry(context, CatalogType::SCALAR_FUNCTION_ENTRY, DEFAULT_SCHEMA, name)
+		                     .Cast<ScalarFunctionCatalogEntry>();
+		return func_set.functions.GetFunctionByArguments(context, args);
+	}
+
+	// Returns false if joins should not be partitioned
+	static bool TryGetGridSize(ClientContext &context, double &grid_size) {
+		Value value;
+		if (!context.TryGetCurrentSetting("spatial_join_grid_size", value) || value.IsNull()) {
+			return false;
+		}
+		grid_size = value.GetValue<double>();
+		return grid_size > 0 && std::isfinite(grid_size);
+	}
+
+	// We run after the binder is done, so new table indexes have to come from above the highest one in the plan
+	static void GetMaxTableIndex(LogicalOperator &op, idx_t &max_index) {
+		for (auto index : op.GetTableIndex()) {
+			max_index = MaxValue(max_index, index);
+		}
+		if (op.type == LogicalOperatorType::LOGICAL_ANY_JOIN ||
+		    op.type == LogicalOperatorType::LOGICAL_COMPARISON_JOIN ||
+		    op.type == LogicalOperatorType::LOGICAL_DELIM_JOIN || op.type == LogicalOperatorType::LOGICAL_ASOF_JOIN) {
+			auto &join = op.Cast<LogicalJoin>();
+			if (join.join_type == JoinType::MARK) {
+				max_index = MaxValue(max_index, join.mark_index);
+			}
+		}
+		for (auto &child : op.children) {
+			GetMaxTableIndex(*child, max_index);
+		}
+	}
+
+	// Unnest the grid cells of the geometry next to the other columns of the child
+	static unique_ptr<LogicalOperator> CreateGridCellUnnest(ClientContext &context, unique_ptr<LogicalOperator> child,
+	                                                        unique_ptr<Expression> geom, double grid_size,
+	                                                        idx_t table_index) {
+		vector<unique_ptr<Expression>> cells_args;
+		cells_args.push_back(std::move(geom));
+		cells_args.push_back(make_uniq<BoundConstantExpression>(Value::DOUBLE(grid_size)));
+		auto cells_func = GetFunction(context, "st_gridcells", {GeoTypes::GEOMETRY(), LogicalType::DOUBLE});
+		auto cells = make_uniq<BoundFunctionExpression>(LogicalType::LIST(LogicalType::UBIGINT),
+		                                                std::move(cells_func), std::move(cells_args), nullptr);
+
+		auto unnest_expr = make_uniq<BoundUnnestExpression>(LogicalType::UBIGINT);
+		unnest_expr->child = std::move(cells);
+
+		auto unnest = make_uniq<LogicalUnnest>(table_index);
+		unnest->expressions.push_back(std::move(unnest_expr));
+		unnest->children.push_back(std::move(child));
+		return std::move(unnest);
+	}
+
+	static unique_ptr<LogicalOperator> CreatePartitionedJoin(ClientContext &context, LogicalAnyJoin &any_join,
+	                                                         unique_ptr<Expression> left_pred_expr,
+	                                                         unique_ptr<Expression> right_pred_expr, double grid_size,
+	                                                         idx_t &next_table_index) {
+		auto left_column_count = any_join.children[0]->GetColumnBindings().size();
+		auto right_column_count = any_join.children[1]->GetColumnBindings().size();
+
+		auto left_cell_index = next_table_index++;
+		auto right_cell_index = next_table_index++;
+		auto left = CreateGridCellUnnest(context, std::move(any_join.children[0]), left_pred_expr->Copy(), grid_size,
+		                                 left_cell_index);
+		auto right = CreateGridCellUnnest(context, std::move(any_join.children[1]), right_pred_expr->Copy(),
+		                                  grid_size, right_cell_index);
+
+		// Join the two sides on their cells
+		auto left_cell = make_uniq<BoundColumnRefExpression>(LogicalType::UBIGINT, ColumnBinding(left_cell_index, 0));
+		auto right_cell = make_uniq<BoundColumnRefExpression>(LogicalType::UBIGINT, ColumnBinding(right_cell_index, 0));
+
+		JoinCondition cmp;
+		cmp.comparison = ExpressionType::COMPARE_EQUAL;
+		cmp.left = left_cell->Copy();
+		cmp.right = std::move(right_cell);
+
+		auto new_join = make_uniq<LogicalComparisonJoin>(JoinType::INNER);
+		new_join->conditions.push_back(std::move(cmp));
+		new_join->children.push_back(std::move(left));
+		new_join->children.push_back(std::move(right));
+		if (any_join.has_estimated_cardinality) {
+			new_join->estimated_cardinality = any_join.estimated_cardinality;
+			new_join->has_estimated_cardinality = true;
+		}
+
+		// Only keep each pair in its reference cell, this also drops the pairs whose bounding boxes dont intersect
+		vector<unique_ptr<Expression>> reference_args;
+		reference_args.push_back(std::move(left_pred_expr));
+		reference_args.push_back(std::move(right_pred_expr));
+		reference_args.push_back(make_uniq<BoundConstantExpression>(Value::DOUBLE(grid_size)));
+		auto reference_func = GetFunction(context, "st_gridreferencecell",
+		                                  {GeoTypes::GEOMETRY(), GeoTypes::GEOMETRY(), LogicalType::DOUBLE});
+		auto reference_cell = make_uniq<BoundFunctionExpression>(LogicalType::UBIGINT, std::move(reference_func),
+		                                                         std::move(reference_args), nullptr);
+
+		// The cheap reference cell check goes first, so the spatial predicate only runs on the remaining pairs
+		auto filter = make_uniq<LogicalFilter>();
+		filter->expressions.push_back(make_uniq<BoundComparisonExpression>(
+		    ExpressionType::COMPARE_EQUAL, std::move(reference_cell), std::move(left_cell)));
+		filter->expressions.push_back(std::move(any_join.condition));
+		filter->children.push_back(std::move(new_join));
+
+		// Project the cell columns away again, so that the columns are the same as those of the original join
+		for (idx_t i = 0; i < left_column_count; i++) {
+			filter->projection_map.push_back(i);
+		}
+		for (idx_t i = 0; i < right_column_count; i++) {
+			filter->projection_map.push_back(left_column_count + 1 + i);
+		}
+		return std::move(filter);
+	}
+
+	static void TryOptimize(ClientContext &context, unique_ptr<LogicalOperator> &plan, idx_t &next_table_index) {
 
 		auto &op = *plan;
 
@@ -142,6 +287,15 @@ public:
 						std::swap(left_pred_expr, right_pred_expr);
 					}
 
+					// Partition the join over a grid if the user asked for it
+					double grid_size;
+					if (TryGetGridSize(context, grid_size) && left_pred_expr->return_type == GeoTypes::GEOMETRY() &&
+					    right_pred_expr->return_type == GeoTypes::GEOMETRY()) {
+						plan = CreatePartitionedJoin(context, any_join, std::move(left_pred_expr),
+						                             std::move(right_pred_expr), grid_size, next_table_index);
+						return;
+					}
+
 					// Lookup the st_xmin, st_xmax, st_ymin, st_ymax functions in the catalog
 					auto &catalog = Catalog::GetSystemCatalog(context);
 					auto &xmin_func_set =
@@ -240,9 +394,300 @@ public:
 		}
 	}
 
+	static void OptimizeRecursive(ClientContext &context, unique_ptr<LogicalOperator> &plan,
+	                              idx_t &next_table_index) {
+
+		TryOptimize(context, plan, next_table_index);
+
+		// Recursively optimize the children
+		for (auto &child : plan->children) {
+			OptimizeRecursive(context, child, next_table_index);
+		}
+	}
+
 	static void Optimize(ClientContext &context, OptimizerExtensionInfo *info, unique_ptr<LogicalOperator> &plan) {
+		idx_t max_table_index = 0;
+		GetMaxTableIndex(*plan, max_table_index);
+		auto next_table_index = max_table_index + 1;
+		OptimizeRecursive(context, plan, next_table_index);
+	}
+};
+
+//------------------------------------------------------------------------------
+// GeoParquet Spatial Filter Pushdown
+//------------------------------------------------------------------------------
+//
+//	Turns spatial predicates on WKB columns of a parquet scan, e.g.
+//
+//		SELECT * FROM 'file.parquet' WHERE ST_Intersects(ST_GeomFromWKB(geom), <constant>)
+//
+//  into range filters on the bbox covering column of the geometry column, which
+//  the parquet reader uses to skip row groups based on their min/max statistics
+//  before any WKB is parsed. The covering column is the one registered for the
+//  geometry column in the "geo" metadata of the file, without it nothing is pushed.
+//
+//  The predicate itself is kept above the scan, the bbox filter is only a
+//  (conservative) pre-filter.
+//
+class GeoParquetSpatialFilterPushdown : public OptimizerExtension {
+public:
+	GeoParquetSpatialFilterPushdown() {
+		optimize_function = GeoParquetSpatialFilterPushdown::Optimize;
+	}
 
-		TryOptimize(context, info, plan);
+	struct BBoxColumn {
+		idx_t column_idx;
+		// The child indices of the xmin, ymin, xmax and ymax fields
+		idx_t field_idx[4];
+		string field_name[4];
+		LogicalType field_type[4];
+	};
+
+	static bool TryGetConstantBounds(ClientContext &context, const Expression &expr, BoundingBox &bbox) {
+		if (!expr.IsFoldable() || expr.return_type != GeoTypes::GEOMETRY()) {
+			return false;
+		}
+		Value value;
+		if (!ExpressionExecutor::TryEvaluateScalar(context, expr, value) || value.IsNull()) {
+			return false;
+		}
+		auto &blob = StringValue::Get(value);
+		geometry_t geom(string_t(blob.c_str(), blob.size()));
+		return GeometryFactory::TryGetSerializedBoundingBox(geom, bbox);
+	}
+
+	// Returns the scan column index of the WKB column the expression converts to a GEOMETRY, if any
+	static bool TryGetWKBColumn(const Expression &expr, const LogicalGet &get, idx_t &column_idx) {
+		const Expression *child;
+		if (expr.type == ExpressionType::BOUND_FUNCTION) {
+			auto &func = expr.Cast<BoundFunctionExpression>();
+			if (!StringUtil::CIEquals(func.function.name, "st_geomfromwkb") || func.children.size() != 1) {
+				return false;
+			}
+			child = func.children[0].get();
+		} else if (expr.type == ExpressionType::OPERATOR_CAST) {
+			// Only the WKB_BLOB -> GEOMETRY cast parses WKB, a plain BLOB -> GEOMETRY cast does not
+			auto &cast = expr.Cast<BoundCastExpression>();
+			if (cast.return_type != GeoTypes::GEOMETRY() || cast.child->return_type != GeoTypes::WKB_BLOB()) {
+				return false;
+			}
+			child = cast.child.get();
+			if (child->type == ExpressionType::OPERATOR_CAST) {
+				child = child->Cast<BoundCastExpression>().child.get();
+			}
+		} else {
+			return false;
+		}
+
+		if (child->type != ExpressionType::BOUND_COLUMN_REF || child->return_type.id() != LogicalTypeId::BLOB) {
+			return false;
+		}
+		auto &colref = child->Cast<BoundColumnRefExpression>();
+		if (colref.depth != 0 || colref.binding.table_index != get.table_index ||
+		    colref.binding.column_index >= get.column_ids.size()) {
+			return false;
+		}
+		column_idx = get.column_ids[colref.binding.column_index];
+		return column_idx < get.names.size();
+	}
+
+	// Reads the bbox covering of the geometry column from the "geo" metadata of the files that are scanned. Every
+	// file has to name the same covering, otherwise the filter could refer to a column that is no bbox in some file.
+	static bool TryGetBBoxColumn(ClientContext &context, const LogicalGet &get, idx_t geom_column_idx,
+	                             BBoxColumn &result) {
+		if (get.parameters.empty()) {
+			return false;
+		}
+		vector<string> files;
+		try {
+			files = MultiFileReader::GetFileList(context, get.parameters[0], "Parquet", FileGlobOptions::ALLOW_EMPTY);
+		} catch (std::exception &ex) {
+			return false;
+		}
+		if (files.empty()) {
+			return false;
+		}
+		GeoParquetBBoxCovering covering;
+		for (idx_t file_idx = 0; file_idx < files.size(); file_idx++) {
+			string geo_metadata;
+			GeoParquetBBoxCovering file_covering;
+			if (!GeoParquetMetadata::TryRead(context, files[file_idx], geo_metadata) ||
+			    !GeoParquetMetadata::TryGetBBoxCovering(geo_metadata, get.names[geom_column_idx], file_covering)) {
+				return false;
+			}
+			if (file_idx == 0) {
+				covering = std::move(file_covering);
+			} else if (!covering.Equals(file_covering)) {
+				return false;
+			}
+		}
+
+		for (idx_t col_idx = 0; col_idx < get.names.size(); col_idx++) {
+			auto &type = get.returned_types[col_idx];
+			if (get.names[col_idx] != covering.column || type.id() != LogicalTypeId::STRUCT) {
+				continue;
+			}
+			auto &children = StructType::GetChildTypes(type);
+			idx_t found = 0;
+			for (idx_t field = 0; field < 4; field++) {
+				for (idx_t child_idx = 0; child_idx < children.size(); child_idx++) {
+					auto &child = children[child_idx];
+					if (child.first == covering.fields[field] &&
+					    (child.second.id() == LogicalTypeId::FLOAT || child.second.id() == LogicalTypeId::DOUBLE)) {
+						result.field_idx[field] = child_idx;
+						result.field_name[field] = child.first;
+						result.field_type[field] = child.second;
+						found++;
+						break;
+					}
+				}
+			}
+			if (found == 4) {
+				result.column_idx = col_idx;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static bool TryGetPredicateBounds(ClientContext &context, const Expression &expr, const LogicalGet &get,
+	                                  idx_t &geom_column_idx, BoundingBox &bbox) {
+		if (expr.type != ExpressionType::BOUND_FUNCTION) {
+			return false;
+		}
+		auto &func = expr.Cast<BoundFunctionExpression>();
+
+		static const case_insensitive_set_t predicates = {
+		    "st_equals",   "st_intersects", "st_touches",   "st_crosses",          "st_within",           "st_contains",
+		    "st_overlaps", "st_covers",     "st_coveredby", "st_containsproperly", "st_intersects_extent"};
+
+		auto is_dwithin = StringUtil::CIEquals(func.function.name, "st_dwithin");
+		if (!is_dwithin && predicates.find(func.function.name) == predicates.end()) {
+			return false;
+		}
+		if (func.children.size() != (is_dwithin ? 3 : 2)) {
+			return false;
+		}
+
+		// One side has to be a WKB column, the other a constant geometry
+		idx_t constant_idx;
+		if (TryGetWKBColumn(*func.children[0], get, geom_column_idx)) {
+			constant_idx = 1;
+		} else if (TryGetWKBColumn(*func.children[1], get, geom_column_idx)) {
+			constant_idx = 0;
+		} else {
+			return false;
+		}
+		if (!TryGetConstantBounds(context, *func.children[constant_idx], bbox)) {
+			return false;
+		}
+
+		if (is_dwithin) {
+			auto &distance_expr = *func.children[2];
+			Value distance;
+			if (!distance_expr.IsFoldable() ||
+			    !ExpressionExecutor::TryEvaluateScalar(context, distance_expr, distance) || distance.IsNull()) {
+				return false;
+			}
+			auto dist = DoubleValue::Get(distance.DefaultCastAs(LogicalType::DOUBLE));
+			if (dist < 0 || !std::isfinite(dist)) {
+				return false;
+			}
+			bbox.minx -= dist;
+			bbox.miny -= dist;
+			bbox.maxx += dist;
+			bbox.maxy += dist;
+		}
+		return true;
+	}
+
+	// Creates a filter on a field of the bbox struct, rounding the constant outwards if the field is a FLOAT
+	static unique_ptr<TableFilter> CreateFieldFilter(const BBoxColumn &bbox_column, idx_t field, double value,
+	                                                 ExpressionType comparison) {
+		Value constant;
+		if (bbox_column.field_type[field].id() == LogicalTypeId::FLOAT) {
+			auto rounded = comparison == ExpressionType::COMPARE_LESSTHANOREQUALTO ? Utils::DoubleToFloatUp(value)
+			                                                                          : Utils::DoubleToFloatDown(value);
+			constant = Value::FLOAT(rounded);
+		} else {
+			constant = Value::DOUBLE(value);
+		}
+		auto child_filter = make_uniq<ConstantFilter>(comparison, std::move(constant));
+		return make_uniq<StructFilter>(bbox_column.field_idx[field], bbox_column.field_name[field],
+		                               std::move(child_filter));
+	}
+
+	static void TryOptimize(ClientContext &context, unique_ptr<LogicalOperator> &plan) {
+		if (plan->type != LogicalOperatorType::LOGICAL_FILTER || plan->children.empty() ||
+		    plan->children[0]->type != LogicalOperatorType::LOGICAL_GET) {
+			return;
+		}
+		auto &filter = plan->Cast<LogicalFilter>();
+		auto &get = plan->children[0]->Cast<LogicalGet>();
+		if (!get.function.filter_pushdown || (!StringUtil::CIEquals(get.function.name, "parquet_scan") &&
+		                                      !StringUtil::CIEquals(get.function.name, "read_parquet"))) {
+			return;
+		}
+
+		// The filter expressions are AND'ed together, so we can intersect all the bounds we find per column
+		unordered_map<idx_t, BoundingBox> column_bounds;
+		for (auto &expr : filter.expressions) {
+			idx_t geom_column_idx;
+			BoundingBox bbox;
+			if (!TryGetPredicateBounds(context, *expr, get, geom_column_idx, bbox)) {
+				continue;
+			}
+			auto entry = column_bounds.find(geom_column_idx);
+			if (entry == column_bounds.end()) {
+				column_bounds.emplace(geom_column_idx, bbox);
+				continue;
+			}
+			auto &bounds = entry->second;
+			bounds.minx = MaxValue(bounds.minx, bbox.minx);
+			bounds.miny = MaxValue(bounds.miny, bbox.miny);
+			bounds.maxx = MinValue(bounds.maxx, bbox.maxx);
+			bounds.maxy = MinValue(bounds.maxy, bbox.maxy);
+		}
+
+		for (auto &entry : column_bounds) {
+			BBoxColumn bbox_column;
+			if (!TryGetBBoxColumn(context, get, entry.first, bbox_column)) {
+				continue;
+			}
+			auto &bounds = entry.second;
+
+			// Make sure the bbox column is scanned, but dont output it if it wasnt already
+			auto scan_idx = std::find(get.column_ids.begin(), get.column_ids.end(), bbox_column.column_idx) -
+			                get.column_ids.begin();
+			if (static_cast<idx_t>(scan_idx) == get.column_ids.size()) {
+				if (!get.function.filter_prune) {
+					continue;
+				}
+				if (get.projection_ids.empty()) {
+					for (idx_t i = 0; i < get.column_ids.size(); i++) {
+						get.projection_ids.push_back(i);
+					}
+				}
+				get.column_ids.push_back(bbox_column.column_idx);
+			}
+
+			// The boxes intersect if xmin <= max_x AND xmax >= min_x AND ymin <= max_y AND ymax >= min_y
+			auto conjunction = make_uniq<ConjunctionAndFilter>();
+			conjunction->child_filters.push_back(
+			    CreateFieldFilter(bbox_column, 0, bounds.maxx, ExpressionType::COMPARE_LESSTHANOREQUALTO));
+			conjunction->child_filters.push_back(
+			    CreateFieldFilter(bbox_column, 1, bounds.maxy, ExpressionType::COMPARE_LESSTHANOREQUALTO));
+			conjunction->child_filters.push_back(
+			    CreateFieldFilter(bbox_column, 2, bounds.minx, ExpressionType::COMPARE_GREATERTHANOREQUALTO));
+			conjunction->child_filters.push_back(
+			    CreateFieldFilter(bbox_column, 3, bounds.miny, ExpressionType::COMPARE_GREATERTHANOREQUALTO));
+			get.table_filters.PushFilter(static_cast<idx_t>(scan_idx), std::move(conjunction));
+		}
+	}
+
+	static void Optimize(ClientContext &context, OptimizerExtensionInfo *info, unique_ptr<LogicalOperator> &plan) {
+
+		TryOptimize(context, plan);
 
 		// Recursively optimize the children
 		for (auto &child : plan->children) {
@@ -261,8 +706,15 @@ void CoreOptimizerRules::Register(DatabaseInstance &db) {
 	con.BeginTransaction();
 	auto &config = DBConfig::GetConfig(context);
 
+	// Register the settings
+	config.AddExtensionOption("spatial_join_grid_size",
+	                          "The cell size of the grid that spatial joins between GEOMETRY columns are partitioned "
+	                          "over. Set to 0 to use range joins on the bounding boxes instead",
+	                          LogicalType::DOUBLE, Value::DOUBLE(0));
+
 	// Register the optimizer rules
 	config.optimizer_extensions.push_back(RangeJoinSpatialPredicateRewriter());
+	config.optimizer_extensions.push_back(GeoParquetSpatialFilterPushdown());
 
 	con.Commit();
 }
@@ -1,9 +1,12 @@
 #include "spatial/gdal/file_handler.hpp"
 
+#include "duckdb/common/atomic.hpp"
 #include "duckdb/common/mutex.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/common/types/uuid.hpp"
 
+#include <algorithm>
+
 #include "cpl_vsi.h"
 #include "cpl_vsi_virtual.h"
 #include "cpl_vsi_error.h"
@@ -21,14 +24,192 @@ class DuckDBFileHandle : public VSIVirtualHandle {
 private:
 	unique_ptr<FileHandle> file_handle;
 
+	// For seekable files opened for reading only we keep track of the position ourselves and only issue
+	// positional reads. This lets us serve the many small reads GDAL drivers make from a small block cache,
+	// and coalesce the ranges passed to ReadMultiRange/AdviseRead into a few larger reads.
+	bool is_positional;
+	idx_t position = 0;
+	idx_t file_size = 0;
+	// Bumped whenever the file is written to or truncated through any of its handles, so that readers know to drop
+	// their cached blocks and pick up the new file size
+	shared_ptr<atomic<idx_t>> file_version;
+	idx_t cached_version = 0;
+
+	static constexpr idx_t BLOCK_SIZE = 64 * 1024;
+	static constexpr idx_t MAX_CACHED_BLOCKS = 32;
+	// Ranges closer than this are read together, the bytes in between are thrown away
+	static constexpr idx_t MAX_COALESCE_GAP = 32 * 1024;
+	static constexpr idx_t MAX_COALESCED_READ = 8 * 1024 * 1024;
+
+	struct CachedBlock {
+		idx_t block_idx;
+		idx_t size;
+		idx_t last_used;
+		unsafe_unique_array<data_t> data;
+	};
+	vector<CachedBlock> cache;
+	idx_t cache_clock = 0;
+
+	CachedBlock *FindBlock(idx_t block_idx) {
+		for (auto &block : cache) {
+			if (block.block_idx == block_idx) {
+				block.last_used = ++cache_clock;
+				return &block;
+			}
+		}
+		return nullptr;
+	}
+
+	CachedBlock &AllocateBlock(idx_t block_idx) {
+		if (cache.size() < MAX_CACHED_BLOCKS) {
+			cache.push_back(CachedBlock {block_idx, 0, 0, make_unsafe_uniq_array<data_t>(BLOCK_SIZE)});
+			cache.back().last_used = ++cache_clock;
+			return cache.back();
+		}
+		// Evict the least recently used block
+		auto lru = std::min_element(cache.begin(), cache.end(), [](const CachedBlock &a, const CachedBlock &b) {
+			return a.last_used < b.last_used;
+		});
+		lru->block_idx = block_idx;
+		lru->size = 0;
+		lru->last_used = ++cache_clock;
+		return *lru;
+	}
+
+	// Load the blocks in [first_block, last_block] that are not cached yet, reading each run of missing blocks at once
+	void LoadBlocks(idx_t first_block, idx_t last_block) {
+		D_ASSERT(last_block - first_block < MAX_CACHED_BLOCKS);
+		auto block_idx = first_block;
+		while (block_idx <= last_block) {
+			if (FindBlock(block_idx)) {
+				block_idx++;
+				continue;
+			}
+			auto run_end = block_idx;
+			while (run_end + 1 <= last_block && !FindBlock(run_end + 1)) {
+				run_end++;
+			}
+			auto run_start_offset = block_idx * BLOCK_SIZE;
+			auto run_size = MinValue<idx_t>((run_end + 1) * BLOCK_SIZE, file_size) - run_start_offset;
+			if (block_idx == run_end) {
+				auto &block = AllocateBlock(block_idx);
+				file_handle->Read(block.data.get(), run_size, run_start_offset);
+				block.size = run_size;
+			} else {
+				auto buffer = make_unsafe_uniq_array<data_t>(run_size);
+				file_handle->Read(buffer.get(), run_size, run_start_offset);
+				for (auto idx = block_idx; idx <= run_end; idx++) {
+					auto &block = AllocateBlock(idx);
+					auto block_offset = (idx - block_idx) * BLOCK_SIZE;
+					block.size = MinValue<idx_t>(BLOCK_SIZE, run_size - block_offset);
+					memcpy(block.data.get(), buffer.get() + block_offset, block.size);
+				}
+			}
+			block_idx = run_end + 1;
+		}
+	}
+
+	// Read [offset, offset + size) through the block cache, the range has to be within the file
+	void ReadCached(data_ptr_t buffer, idx_t size, idx_t offset) {
+		auto first_block = offset / BLOCK_SIZE;
+		auto last_block = (offset + size - 1) / BLOCK_SIZE;
+		LoadBlocks(first_block, last_block);
+		while (size > 0) {
+			auto block = FindBlock(offset / BLOCK_SIZE);
+			D_ASSERT(block);
+			auto block_offset = offset % BLOCK_SIZE;
+			auto to_copy = MinValue<idx_t>(size, block->size - block_offset);
+			memcpy(buffer, block->data.get() + block_offset, to_copy);
+			buffer += to_copy;
+			offset += to_copy;
+			size -= to_copy;
+		}
+	}
+
+	void CheckFileVersion() {
+		auto version = file_version->load();
+		if (version == cached_version) {
+			return;
+		}
+		cache.clear();
+		file_size = file_handle->GetFileSize();
+		cached_version = version;
+	}
+
+	// Read [offset, offset + size), small reads go through the block cache
+	void ReadAt(data_ptr_t buffer, idx_t size, idx_t offset) {
+		if (size == 0) {
+			return;
+		}
+		if (size < BLOCK_SIZE) {
+			ReadCached(buffer, size, offset);
+		} else {
+			file_handle->Read(buffer, size, offset);
+		}
+	}
+
+	// Group ranges (in offset order) that are close enough to each other to be read with a single read
+	template <class FUNC>
+	static void CoalesceRanges(int n_ranges, const vsi_l_offset *offsets, const size_t *sizes, FUNC &&func) {
+		vector<idx_t> order(n_ranges);
+		for (idx_t i = 0; i < order.size(); i++) {
+			order[i] = i;
+		}
+		std::sort(order.begin(), order.end(), [&](idx_t a, idx_t b) { return offsets[a] < offsets[b]; });
+
+		idx_t group_start = 0;
+		while (group_start < order.size()) {
+			auto span_start = static_cast<idx_t>(offsets[order[group_start]]);
+			auto span_end = span_start + sizes[order[group_start]];
+			auto group_end = group_start + 1;
+			while (group_end < order.size()) {
+				auto next_start = static_cast<idx_t>(offsets[order[group_end]]);
+				auto next_end = MaxValue<idx_t>(span_end, next_start + sizes[order[group_end]]);
+				if (next_start > span_end + MAX_COALESCE_GAP || next_end - span_start > MAX_COALESCED_READ) {
+					break;
+				}
+				span_end = next_end;
+				group_end++;
+			}
+			func(order, group_start, group_end, span_start, span_end);
+			group_start = group_end;
+		}
+	}
+
 public:
-	explicit DuckDBFileHandle(unique_ptr<FileHandle> file_handle_p) : file_handle(std::move(file_handle_p)) {
+	DuckDBFileHandle(unique_ptr<FileHandle> file_handle_p, bool read_only, shared_ptr<atomic<idx_t>> file_version_p)
+	    : file_handle(std::move(file_handle_p)), file_version(std::move(file_version_p)) {
+		is_positional = read_only && file_handle->CanSeek();
+		if (is_positional) {
+			cached_version = file_version->load();
+			file_size = file_handle->GetFileSize();
+		}
 	}
 
 	vsi_l_offset Tell() override {
+		if (is_positional) {
+			return static_cast<vsi_l_offset>(position);
+		}
 		return static_cast<vsi_l_offset>(file_handle->SeekPosition());
 	}
 	int Seek(vsi_l_offset nOffset, int nWhence) override {
+		if (is_positional) {
+			switch (nWhence) {
+			case SEEK_SET:
+				position = nOffset;
+				break;
+			case SEEK_CUR:
+				position += nOffset;
+				break;
+			case SEEK_END:
+				CheckFileVersion();
+				position = file_size + nOffset;
+				break;
+			default:
+				throw InternalException("Unknown seek type");
+			}
+			return 0;
+		}
 		if (nWhence == SEEK_SET && nOffset == 0) {
 			// Use the reset function instead to allow compressed file handles to rewind
 			// even if they don't support seeking
@@ -52,6 +233,23 @@ public:
 	}
 
 	size_t Read(void *pBuffer, size_t nSize, size_t nCount) override {
+		if (nSize == 0 || nCount == 0) {
+			return 0;
+		}
+		if (is_positional) {
+			CheckFileVersion();
+			auto available = position < file_size ? file_size - position : 0;
+			// Only read whole items
+			auto read_bytes = MinValue<idx_t>(nSize * nCount, available - available % nSize);
+			try {
+				ReadAt(static_cast<data_ptr_t>(pBuffer), read_bytes, position);
+			} catch (...) {
+				return 0;
+			}
+			position += read_bytes;
+			return read_bytes / nSize;
+		}
+
 		auto remaining_bytes = nSize * nCount;
 		try {
 			while (remaining_bytes > 0) {
@@ -68,7 +266,68 @@ public:
 		return nCount - (remaining_bytes / nSize);
 	}
 
+	int ReadMultiRange(int nRanges, void **ppData, const vsi_l_offset *panOffsets, const size_t *panSizes) override {
+		if (!is_positional) {
+			return VSIVirtualHandle::ReadMultiRange(nRanges, ppData, panOffsets, panSizes);
+		}
+		CheckFileVersion();
+		for (int i = 0; i < nRanges; i++) {
+			if (panOffsets[i] + panSizes[i] > file_size) {
+				return -1;
+			}
+		}
+		try {
+			CoalesceRanges(nRanges, panOffsets, panSizes,
+			               [&](const vector<idx_t> &order, idx_t start, idx_t end, idx_t span_start, idx_t span_end) {
+				               if (end - start == 1) {
+					               // Nothing to coalesce, read straight into the output buffer
+					               auto idx = order[start];
+					               ReadAt(static_cast<data_ptr_t>(ppData[idx]), panSizes[idx], panOffsets[idx]);
+					               return;
+				               }
+				               auto span_size = span_end - span_start;
+				               auto buffer = make_unsafe_uniq_array<data_t>(span_size);
+				               ReadAt(buffer.get(), span_size, span_start);
+				               for (auto i = start; i < end; i++) {
+					               auto idx = order[i];
+					               memcpy(ppData[idx], buffer.get() + (panOffsets[idx] - span_start), panSizes[idx]);
+				               }
+			               });
+		} catch (...) {
+			return -1;
+		}
+		return 0;
+	}
+
+	void AdviseRead(int nRanges, const vsi_l_offset *panOffsets, const size_t *panSizes) override {
+		if (!is_positional) {
+			return;
+		}
+		CheckFileVersion();
+		try {
+			// Prefetch the ranges that fit in the block cache, anything larger is read on demand anyway
+			CoalesceRanges(nRanges, panOffsets, panSizes,
+			               [&](const vector<idx_t> &, idx_t, idx_t, idx_t span_start, idx_t span_end) {
+				               span_end = MinValue(span_end, file_size);
+				               if (span_start >= span_end) {
+					               return;
+				               }
+				               auto first_block = span_start / BLOCK_SIZE;
+				               auto last_block = (span_end - 1) / BLOCK_SIZE;
+				               if (last_block - first_block < MAX_CACHED_BLOCKS / 2) {
+					               LoadBlocks(first_block, last_block);
+				               }
+			               });
+		} catch (...) {
+			// This is only a hint, any errors will surface when actually reading
+		}
+	}
+
 	int Eof() override {
+		if (is_positional) {
+			CheckFileVersion();
+			return position >= file_size ? TRUE : FALSE;
+		}
 		return file_handle->SeekPosition() == file_handle->GetFileSize() ? TRUE : FALSE;
 	}
 
@@ -78,6 +337,7 @@ public:
 			written_bytes = file_handle->Write(const_cast<void *>(pBuffer), nSize * nCount);
 		} catch (...) {
 		}
+		(*file_version)++;
 		// Return the number of items written
 		return static_cast<size_t>(written_bytes / nSize);
 	}
@@ -88,6 +348,7 @@ public:
 	}
 	int Truncate(vsi_l_offset nNewSize) override {
 		file_handle->Truncate(static_cast<int64_t>(nNewSize));
+		(*file_version)++;
 		return 0;
 	}
 	int Close() override {
@@ -95,8 +356,6 @@ public:
 		return 0;
 	}
 
-	// int ReadMultiRange(int nRanges, void **ppData, const vsi_l_offset *panOffsets, const size_t *panSizes) override;
-	// void AdviseRead(int nRanges, const vsi_l_offset *panOffsets, const size_t *panSizes) override;
 	// VSIRangeStatus GetRangeStatus(vsi_l_offset nOffset, vsi_l_offset nLength) override;
 };
 
@@ -107,6 +366,36 @@ class DuckDBFileSystemHandler : public VSIFilesystemHandler {
 private:
 	string client_prefix;
 	ClientContext &context;
+	// The version of every file that has open handles, see DuckDBFileHandle. The entry of a file is removed when its
+	// last handle is closed, a handle that is opened after that reads the file size again anyway.
+	struct FileVersions {
+		mutex lock;
+		unordered_map<string, weak_ptr<atomic<idx_t>>> versions;
+	};
+	shared_ptr<FileVersions> file_versions = make_shared<FileVersions>();
+
+	shared_ptr<atomic<idx_t>> GetFileVersion(const string &file_name) {
+		lock_guard<mutex> guard(file_versions->lock);
+		auto &entry = file_versions->versions[file_name];
+		auto version = entry.lock();
+		if (!version) {
+			// The deleter keeps the map alive, in case a handle outlives this handler
+			auto versions = file_versions;
+			version = shared_ptr<atomic<idx_t>>(new atomic<idx_t>(0), [versions, file_name](atomic<idx_t> *ptr) {
+				{
+					lock_guard<mutex> guard(versions->lock);
+					auto entry = versions->versions.find(file_name);
+					// The entry might already have been replaced by a newer handle
+					if (entry != versions->versions.end() && entry->second.expired()) {
+						versions->versions.erase(entry);
+					}
+				}
+				delete ptr;
+			});
+			entry = version;
+		}
+		return version;
+	}
 
 public:
 	DuckDBFileSystemHandler(string client_prefix, ClientContext &context)
@@ -164,11 +453,11 @@ public:
 				// We can't open a directory for reading on windows without special flags
 				// so just open nul instead, gdal will reject it when it tries to read
 				auto file = fs.OpenFile("nul", flags);
-				return new DuckDBFileHandle(std::move(file));
+				return new DuckDBFileHandle(std::move(file), false, make_shared<atomic<idx_t>>(0));
 			}
 #endif
 			auto file = fs.OpenFile(file_name, flags, FileSystem::DEFAULT_LOCK, FileCompressionType::AUTO_DETECT);
-			return new DuckDBFileHandle(std::move(file));
+			return new DuckDBFileHandle(std::move(file), flags == FileFlags::FILE_FLAGS_READ, GetFileVersion(path));
 		} catch (std::exception &ex) {
 			// Failed to open file via DuckDB File System. If this doesnt have a VSI prefix we can return an error here.
 			if (strncmp(file_name, "/vsi", 4) != 0) {
@@ -298,8 +587,15 @@ public:
 		return files.StealList();
 	}
 
-	int HasOptimizedReadMultiRange(const char *pszPath) override {
-		return 0;
+	int HasOptimizedReadMultiRange(const char *prefixed_file_name) override {
+		// Ranges are coalesced by the file handles, but only for seekable files. GDAL asks this a lot, so we decide
+		// from the path instead of opening the file: only compressed files, which are detected by their extension,
+		// can not seek. Anything else that turns out not to be seekable falls back to separate reads.
+		auto file_name = StringUtil::Lower(StripPrefix(prefixed_file_name));
+		if (StringUtil::EndsWith(file_name, ".tmp")) {
+			file_name = file_name.substr(0, file_name.size() - 4);
+		}
+		return StringUtil::EndsWith(file_name, ".gz") || StringUtil::EndsWith(file_name, ".zst") ? FALSE : TRUE;
 	}
 
 	int Unlink(const char *prefixed_file_name) override {
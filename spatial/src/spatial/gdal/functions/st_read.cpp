@@ -7,6 +7,18 @@
 #include "duckdb/planner/table_filter.hpp"
 #include "duckdb/function/function.hpp"
 #include "duckdb/function/replacement_scan.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/optimizer/optimizer_extension.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_conjunction_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression/bound_operator_expression.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+#include "duckdb/planner/operator/logical_filter.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
 
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
@@ -97,8 +109,22 @@ static string FilterToGdal(const TableFilterSet &set, const vector<idx_t> &colum
 	return StringUtil::Join(filters, " AND ");
 }
 
+// The columns of a single layer, as returned by its arrow stream
+struct GdalLayerSchema {
+	// before they are renamed
+	vector<string> raw_names;
+	vector<string> names;
+	vector<LogicalType> types;
+	// the names OGR uses to refer to each column, used for projection pushdown
+	vector<string> ogr_field_names;
+	unordered_set<idx_t> geometry_column_ids;
+	ArrowTableType arrow_table;
+};
+
 struct GdalScanFunctionData : public TableFunctionData {
 	int layer_idx;
+	// If the layer was selected by name, it is looked up by name in every file
+	string layer_name;
 	bool sequential_layer_scan = false;
 	bool keep_wkb = false;
 	unordered_set<idx_t> geometry_column_ids;
@@ -107,38 +133,284 @@ struct GdalScanFunctionData : public TableFunctionData {
 	// before they are renamed
 	vector<string> all_names;
 	vector<LogicalType> all_types;
+	// the names OGR uses to refer to each column, used for projection pushdown
+	vector<string> ogr_field_names;
 	ArrowTableType arrow_table;
 
 	bool has_approximate_feature_count;
 	idx_t approximate_feature_count;
+	bool has_extent = false;
+	OGREnvelope extent;
 	string raw_file_name;
 	string prefixed_file_name;
+	// All files to scan, the first one is raw_file_name
+	vector<string> file_names;
+	string file_prefix;
+	bool union_by_name = false;
+	idx_t filename_column_idx = DConstants::INVALID_INDEX;
 	CPLStringList dataset_open_options;
 	CPLStringList dataset_allowed_drivers;
 	CPLStringList dataset_sibling_files;
 	CPLStringList layer_creation_options;
+
+	// Multiple files are scanned file by file, with each thread opening the files it scans itself
+	bool IsMultiFile() const {
+		return file_names.size() > 1 || filename_column_idx != DConstants::INVALID_INDEX;
+	}
 };
 
 struct GdalScanLocalState : ArrowScanLocalState {
 	core::GeometryFactory factory;
 	// We trust GDAL to produce valid WKB
 	core::WKBReader wkb_reader;
+	// The columns actually present in the arrow stream, in stream order
+	DataChunk stream_chunk;
+	// Only used when the scan is partitioned by feature id, or when scanning multiple files
+	GDALDatasetUniquePtr dataset;
+	OGRLayer *layer = nullptr;
+	unique_ptr<ArrowArrayStreamWrapper> range_stream;
+	idx_t range_idx = 0;
+	idx_t range_chunk_idx = 0;
+	// The row id of the first row in the current arrow chunk, and of the next chunk in the range or file
+	idx_t chunk_row_id = 0;
+	idx_t next_row_id = 0;
+	// Only used when scanning multiple files
+	idx_t file_idx = 0;
+	GdalLayerSchema file_schema;
+	vector<idx_t> file_output_stream_idx;
+	// The filters GDAL can not apply to the current file, evaluated on the output instead
+	unique_ptr<Expression> residual_filter;
+	unique_ptr<ExpressionExecutor> residual_executor;
 	explicit GdalScanLocalState(unique_ptr<ArrowArrayWrapper> current_chunk, ClientContext &context)
 	    : ArrowScanLocalState(std::move(current_chunk)), factory(BufferAllocator::Get(context)),
 	      wkb_reader(factory.allocator) {
 	}
+	~GdalScanLocalState() override {
+		// Release any arrow data before the dataset it was read from is closed
+		chunk.reset();
+		range_stream.reset();
+	}
+};
+
+// When scanning multiple files, the batch index of a chunk is the file index shifted by this, plus the chunk index
+static constexpr idx_t GDAL_FILE_BATCH_SHIFT = 24;
+// Likewise the row id of a feature is the file index shifted by this, plus the row number in the file
+static constexpr idx_t GDAL_FILE_ROW_ID_SHIFT = 40;
+
+// A range of feature ids [min_fid, max_fid] that is scanned by a single thread
+struct GdalFidRange {
+	int64_t min_fid;
+	int64_t max_fid;
 };
 
 struct GdalScanGlobalState : ArrowScanGlobalState {
 	GDALDatasetUniquePtr dataset;
 	atomic<idx_t> lines_read;
-	explicit GdalScanGlobalState(GDALDatasetUniquePtr dataset) : dataset(std::move(dataset)), lines_read(0) {
+	// The rows handed out from the shared arrow stream so far, protected by main_mutex
+	idx_t stream_rows_read = 0;
+	// The fields ignored by GDAL and the pushed down attribute filter, so that they can be re-applied per thread
+	CPLStringList ignored_fields;
+	string attribute_filter;
+	// If the layer can be partitioned by feature id, every thread opens its own dataset and scans whole ranges
+	bool is_partitioned = false;
+	string fid_column;
+	vector<GdalFidRange> fid_ranges;
+	atomic<idx_t> next_fid_range;
+	// The (sorted) column ids that are not ignored, i.e. the columns of the arrow stream
+	vector<idx_t> stream_column_ids;
+	// For each output column, the position of the column in the arrow stream (or INVALID_INDEX for the row id)
+	vector<idx_t> output_stream_idx;
+	// The column ids of the output columns
+	vector<idx_t> output_column_ids;
+	// Only used when scanning multiple files, the projection and filters are applied to each file separately
+	bool is_multi_file = false;
+	atomic<idx_t> next_file_idx;
+	vector<column_t> column_ids;
+	optional_ptr<TableFilterSet> filters;
+	explicit GdalScanGlobalState(GDALDatasetUniquePtr dataset)
+	    : dataset(std::move(dataset)), lines_read(0), next_fid_range(0), next_file_idx(0) {
 	}
 };
 
 //------------------------------------------------------------------------------
 // Bind
 //------------------------------------------------------------------------------
+
+// Expand the input path(s) into the list of files to scan
+static vector<string> GetFileList(ClientContext &context, const Value &input) {
+	vector<string> patterns;
+	if (input.type().id() == LogicalTypeId::LIST) {
+		for (auto &child : ListValue::GetChildren(input)) {
+			patterns.push_back(StringValue::Get(child));
+		}
+	} else {
+		patterns.push_back(StringValue::Get(input));
+	}
+
+	auto &fs = FileSystem::GetFileSystem(context);
+	vector<string> result;
+	for (auto &pattern : patterns) {
+		// GDAL virtual file systems and urls are passed through as-is, they may contain '?' and friends
+		auto is_passthrough = StringUtil::StartsWith(pattern, "/vsi") || StringUtil::StartsWith(pattern, "http://") ||
+		                      StringUtil::StartsWith(pattern, "https://");
+		if (is_passthrough || !FileSystem::HasGlob(pattern)) {
+			result.push_back(pattern);
+			continue;
+		}
+		auto files = fs.GlobFiles(pattern, context, FileGlobOptions::DISALLOW_EMPTY);
+		std::sort(files.begin(), files.end());
+		result.insert(result.end(), files.begin(), files.end());
+	}
+	if (result.empty()) {
+		throw BinderException("ST_Read requires at least one file to read");
+	}
+	return result;
+}
+
+static int FindLayerIndex(GDALDataset &dataset, const string &name) {
+	for (auto layer_idx = 0; layer_idx < dataset.GetLayerCount(); layer_idx++) {
+		if (strcmp(dataset.GetLayer(layer_idx)->GetName(), name.c_str()) == 0) {
+			return layer_idx;
+		}
+	}
+	return -1;
+}
+
+static GDALDatasetUniquePtr OpenDataset(const GdalScanFunctionData &data, const string &file_name) {
+	auto prefixed_file_name = data.file_prefix + file_name;
+	auto dataset = GDALDatasetUniquePtr(
+	    GDALDataset::Open(prefixed_file_name.c_str(), GDAL_OF_VECTOR | GDAL_OF_VERBOSE_ERROR,
+	                      data.dataset_allowed_drivers, data.dataset_open_options, data.dataset_sibling_files));
+	if (dataset == nullptr) {
+		auto error = string(CPLGetLastErrorMsg());
+		throw IOException("Could not open file: " + file_name + " (" + error + ")");
+	}
+	return dataset;
+}
+
+static GDALDatasetUniquePtr OpenDataset(const GdalScanFunctionData &data) {
+	return OpenDataset(data, data.raw_file_name);
+}
+
+// Get the layer to scan from a dataset, reading through the preceding layers if the driver requires it
+static OGRLayer *GetScanLayer(GDALDataset &dataset, const GdalScanFunctionData &data, const string &file_name) {
+	auto layer_idx = data.layer_idx;
+	if (!data.layer_name.empty()) {
+		layer_idx = FindLayerIndex(dataset, data.layer_name);
+		if (layer_idx < 0) {
+			throw IOException("Layer '%s' could not be found in file '%s'", data.layer_name, file_name);
+		}
+	}
+	if (layer_idx >= dataset.GetLayerCount()) {
+		throw IOException("File '%s' does not contain a layer with index %d", file_name, layer_idx);
+	}
+	if (!data.sequential_layer_scan) {
+		return dataset.GetLayer(layer_idx);
+	}
+	OGRLayer *layer = nullptr;
+	for (int i = 0; i <= layer_idx; i++) {
+		layer = dataset.GetLayer(i);
+		if (i == layer_idx) {
+			// desired layer found
+			break;
+		}
+		// else scan through and empty the layer
+		OGRFeature *feature;
+		while ((feature = layer->GetNextFeature()) != nullptr) {
+			OGRFeature::DestroyFeature(feature);
+		}
+	}
+	return layer;
+}
+
+// Get the columns of a layer from its arrow schema
+static void BindLayerSchema(OGRLayer *layer, const GdalScanFunctionData &data, GdalLayerSchema &result) {
+	struct ArrowArrayStream stream;
+	if (!layer->GetArrowStream(&stream, data.layer_creation_options)) {
+		// layer is owned by GDAL, we do not need to destory it
+		throw IOException("Could not get arrow stream from layer");
+	}
+
+	struct ArrowSchema schema;
+	if (stream.get_schema(&stream, &schema) != 0) {
+		if (stream.release) {
+			stream.release(&stream);
+		}
+		throw IOException("Could not get arrow schema from layer");
+	}
+
+	// The Arrow API will return attributes in this order
+	// 1. FID column
+	// 2. all ogr field attributes
+	// 3. all geometry columns
+
+	auto attribute_count = schema.n_children;
+	auto attributes = schema.children;
+	idx_t geometry_field_idx = 0;
+
+	result.raw_names.reserve(attribute_count + 1);
+	result.names.reserve(attribute_count + 1);
+
+	for (idx_t col_idx = 0; col_idx < (idx_t)attribute_count; col_idx++) {
+		auto &attribute = *attributes[col_idx];
+
+		const char ogc_flag[] = {'\x01', '\0', '\0', '\0', '\x14', '\0', '\0', '\0', 'A', 'R', 'R', 'O', 'W',
+		                         ':',    'e',  'x',  't',  'e',    'n',  's',  'i',  'o', 'n', ':', 'n', 'a',
+		                         'm',    'e',  '\a', '\0', '\0',   '\0', 'o',  'g',  'c', '.', 'w', 'k', 'b'};
+
+		auto arrow_type = GetArrowLogicalType(attribute);
+		auto column_name = string(attribute.name);
+		auto duckdb_type = arrow_type->GetDuckType();
+
+		if (duckdb_type.id() == LogicalTypeId::BLOB && attribute.metadata != nullptr &&
+		    strncmp(attribute.metadata, ogc_flag, sizeof(ogc_flag)) == 0) {
+			// This is a WKB geometry blob
+			result.arrow_table.AddColumn(col_idx, std::move(arrow_type));
+
+			if (data.keep_wkb) {
+				result.types.emplace_back(core::GeoTypes::WKB_BLOB());
+			} else {
+				result.types.emplace_back(core::GeoTypes::GEOMETRY());
+				if (column_name == "wkb_geometry") {
+					column_name = "geom";
+				}
+			}
+			result.geometry_column_ids.insert(col_idx);
+
+			// OGR refers to (unnamed) geometry fields differently than the arrow schema
+			auto geom_field_defn = layer->GetLayerDefn()->GetGeomFieldDefn(geometry_field_idx++);
+			auto geom_field_name = geom_field_defn ? string(geom_field_defn->GetNameRef()) : string();
+			result.ogr_field_names.push_back(geom_field_name.empty() ? "OGR_GEOMETRY" : geom_field_name);
+
+		} else if (attribute.dictionary) {
+			result.ogr_field_names.push_back(attribute.name);
+			auto dictionary_type = GetArrowLogicalType(attribute);
+			result.types.emplace_back(dictionary_type->GetDuckType());
+			arrow_type->SetDictionary(std::move(dictionary_type));
+			result.arrow_table.AddColumn(col_idx, std::move(arrow_type));
+		} else {
+			result.ogr_field_names.push_back(attribute.name);
+			result.types.emplace_back(arrow_type->GetDuckType());
+			result.arrow_table.AddColumn(col_idx, std::move(arrow_type));
+		}
+
+		// keep these around for projection/filter pushdown later
+		// does GDAL even allow duplicate/missing names?
+		result.raw_names.push_back(column_name);
+
+		if (column_name.empty()) {
+			result.names.push_back("v" + to_string(col_idx));
+		} else {
+			result.names.push_back(column_name);
+		}
+	}
+
+	schema.release(&schema);
+	stream.release(&stream);
+
+	GdalTableFunction::RenameColumns(result.names);
+}
+
 unique_ptr<FunctionData> GdalTableFunction::Bind(ClientContext &context, TableFunctionBindInput &input,
                                                  vector<LogicalType> &return_types, vector<string> &names) {
 
@@ -175,17 +447,12 @@ unique_ptr<FunctionData> GdalTableFunction::Bind(ClientContext &context, TableFu
 	// Now we can open the dataset
 	auto &ctx_state = GDALClientContextState::GetOrCreate(context);
 
-	result->raw_file_name = input.inputs[0].GetValue<string>();
-	result->prefixed_file_name = ctx_state.GetPrefix() + result->raw_file_name;
+	result->file_names = GetFileList(context, input.inputs[0]);
+	result->file_prefix = ctx_state.GetPrefix();
+	result->raw_file_name = result->file_names[0];
+	result->prefixed_file_name = result->file_prefix + result->raw_file_name;
 
-	auto dataset = GDALDatasetUniquePtr(GDALDataset::Open(
-	    result->prefixed_file_name.c_str(), GDAL_OF_VECTOR | GDAL_OF_VERBOSE_ERROR, result->dataset_allowed_drivers,
-	    result->dataset_open_options, result->dataset_sibling_files));
-
-	if (dataset == nullptr) {
-		auto error = string(CPLGetLastErrorMsg());
-		throw IOException("Could not open file: " + result->raw_file_name + " (" + error + ")");
-	}
+	auto dataset = OpenDataset(*result);
 
 	// Double check that the dataset have any layers
 	if (dataset->GetLayerCount() <= 0) {
@@ -194,6 +461,7 @@ unique_ptr<FunctionData> GdalTableFunction::Bind(ClientContext &context, TableFu
 
 	// Now we can bind the additonal options
 	bool max_batch_size_set = false;
+	bool filename = false;
 	for (auto &kv : input.named_parameters) {
 		auto loption = StringUtil::Lower(kv.first);
 		if (loption == "layer") {
@@ -213,21 +481,15 @@ unique_ptr<FunctionData> GdalTableFunction::Bind(ClientContext &context, TableFu
 
 			// Find layer by name
 			if (kv.second.type() == LogicalTypeId::VARCHAR) {
-				auto name = StringValue::Get(kv.second).c_str();
-				bool found = false;
-				for (auto layer_idx = 0; layer_idx < dataset->GetLayerCount(); layer_idx++) {
-					if (strcmp(dataset->GetLayer(layer_idx)->GetName(), name) == 0) {
-						result->layer_idx = layer_idx;
-						found = true;
-						break;
-					}
-				}
-				if (!found) {
+				auto name = StringValue::Get(kv.second);
+				auto layer_idx = FindLayerIndex(*dataset, name);
+				if (layer_idx < 0) {
 					throw BinderException(StringUtil::Format("Layer '%s' could not be found in dataset", name));
 				}
+				result->layer_idx = layer_idx;
+				result->layer_name = name;
 			}
 		}
-
 		if (loption == "spatial_filter_box" && kv.second.type() == core::GeoTypes::BOX_2D()) {
 			if (result->spatial_filter) {
 				throw BinderException("Only one spatial filter can be specified");
@@ -273,6 +535,14 @@ unique_ptr<FunctionData> GdalTableFunction::Bind(ClientContext &context, TableFu
 		if (loption == "keep_wkb") {
 			result->keep_wkb = BooleanValue::Get(kv.second);
 		}
+
+		if (loption == "union_by_name") {
+			result->union_by_name = BooleanValue::Get(kv.second);
+		}
+
+		if (loption == "filename") {
+			filename = BooleanValue::Get(kv.second);
+		}
 	}
 
 	// set default max_threads
@@ -291,94 +561,99 @@ unique_ptr<FunctionData> GdalTableFunction::Bind(ClientContext &context, TableFu
 	// Get the schema for the selected layer
 	auto layer = dataset->GetLayer(result->layer_idx);
 
-	// Check if we can get an approximate feature count
+	// Check if we can get an approximate feature count and extent. We dont force GDAL to compute them, as
+	// drivers without a cheap way to do so would have to scan the whole layer.
 	result->approximate_feature_count = 0;
 	result->has_approximate_feature_count = false;
 	if (!result->sequential_layer_scan) {
-		auto count = layer->GetFeatureCount();
+		auto count = layer->GetFeatureCount(FALSE);
 		if (count > -1) {
 			result->approximate_feature_count = count;
 			result->has_approximate_feature_count = true;
 		}
+		auto has_geometry = layer->GetLayerDefn()->GetGeomFieldCount() > 0;
+		result->has_extent = has_geometry && layer->GetExtent(&result->extent, FALSE) == OGRERR_NONE;
 	}
 
-	struct ArrowArrayStream stream;
-	if (!layer->GetArrowStream(&stream, result->layer_creation_options)) {
-		// layer is owned by GDAL, we do not need to destory it
-		throw IOException("Could not get arrow stream from layer");
-	}
+	GdalLayerSchema schema;
+	BindLayerSchema(layer, *result, schema);
 
-	struct ArrowSchema schema;
-	if (stream.get_schema(&stream, &schema) != 0) {
-		if (stream.release) {
-			stream.release(&stream);
-		}
-		throw IOException("Could not get arrow schema from layer");
+	if (filename) {
+		// The file name goes after all other columns, we set the actual index below
+		result->filename_column_idx = schema.names.size();
 	}
 
-	// The Arrow API will return attributes in this order
-	// 1. FID column
-	// 2. all ogr field attributes
-	// 3. all geometry columns
-
-	auto attribute_count = schema.n_children;
-	auto attributes = schema.children;
-
-	result->all_names.reserve(attribute_count + 1);
-	names.reserve(attribute_count + 1);
-
-	for (idx_t col_idx = 0; col_idx < (idx_t)attribute_count; col_idx++) {
-		auto &attribute = *attributes[col_idx];
-
-		const char ogc_flag[] = {'\x01', '\0', '\0', '\0', '\x14', '\0', '\0', '\0', 'A', 'R', 'R', 'O', 'W',
-		                         ':',    'e',  'x',  't',  'e',    'n',  's',  'i',  'o', 'n', ':', 'n', 'a',
-		                         'm',    'e',  '\a', '\0', '\0',   '\0', 'o',  'g',  'c', '.', 'w', 'k', 'b'};
-
-		auto arrow_type = GetArrowLogicalType(attribute);
-		auto column_name = string(attribute.name);
-		auto duckdb_type = arrow_type->GetDuckType();
-
-		if (duckdb_type.id() == LogicalTypeId::BLOB && attribute.metadata != nullptr &&
-		    strncmp(attribute.metadata, ogc_flag, sizeof(ogc_flag)) == 0) {
-			// This is a WKB geometry blob
-			result->arrow_table.AddColumn(col_idx, std::move(arrow_type));
+	if (!result->IsMultiFile()) {
+		names = std::move(schema.names);
+		return_types = std::move(schema.types);
+		result->all_names = std::move(schema.raw_names);
+		result->ogr_field_names = std::move(schema.ogr_field_names);
+		result->geometry_column_ids = std::move(schema.geometry_column_ids);
+		result->arrow_table = std::move(schema.arrow_table);
+		result->all_types = return_types;
+		return std::move(result);
+	}
 
-			if (result->keep_wkb) {
-				return_types.emplace_back(core::GeoTypes::WKB_BLOB());
-			} else {
-				return_types.emplace_back(core::GeoTypes::GEOMETRY());
-				if (column_name == "wkb_geometry") {
-					column_name = "geom";
+	// When scanning multiple files, assume they are all about the same size as the first one.
+	// The extent of the first file says nothing about the others though.
+	result->approximate_feature_count *= result->file_names.size();
+	result->has_extent = false;
+
+	// Without union_by_name, every file is expected to have the columns of the first file
+	names = schema.names;
+	return_types = schema.types;
+	result->geometry_column_ids = schema.geometry_column_ids;
+
+	if (result->union_by_name) {
+		// Combine the columns of all files by name, this means we have to open all of them up front
+		case_insensitive_map_t<idx_t> name_map;
+		for (idx_t col_idx = 0; col_idx < names.size(); col_idx++) {
+			name_map[names[col_idx]] = col_idx;
+		}
+		for (idx_t file_idx = 1; file_idx < result->file_names.size(); file_idx++) {
+			auto &file_name = result->file_names[file_idx];
+			auto file_dataset = OpenDataset(*result, file_name);
+			GdalLayerSchema file_schema;
+			BindLayerSchema(GetScanLayer(*file_dataset, *result, file_name), *result, file_schema);
+
+			for (idx_t col_idx = 0; col_idx < file_schema.names.size(); col_idx++) {
+				auto &column_name = file_schema.names[col_idx];
+				auto &column_type = file_schema.types[col_idx];
+				auto entry = name_map.find(column_name);
+				if (entry == name_map.end()) {
+					name_map[column_name] = names.size();
+					if (file_schema.geometry_column_ids.count(col_idx)) {
+						result->geometry_column_ids.insert(names.size());
+					}
+					names.push_back(column_name);
+					return_types.push_back(column_type);
+					continue;
+				}
+				auto &existing_type = return_types[entry->second];
+				if (existing_type == column_type) {
+					continue;
 				}
+				// Numbers are widened, anything else we can always represent as VARCHAR
+				if (existing_type.IsIntegral() && column_type.IsIntegral()) {
+					existing_type = LogicalType::BIGINT;
+				} else if (existing_type.IsNumeric() && column_type.IsNumeric()) {
+					existing_type = LogicalType::DOUBLE;
+				} else {
+					existing_type = LogicalType::VARCHAR;
+				}
+				result->geometry_column_ids.erase(entry->second);
 			}
-			result->geometry_column_ids.insert(col_idx);
-
-		} else if (attribute.dictionary) {
-			auto dictionary_type = GetArrowLogicalType(attribute);
-			return_types.emplace_back(dictionary_type->GetDuckType());
-			arrow_type->SetDictionary(std::move(dictionary_type));
-			result->arrow_table.AddColumn(col_idx, std::move(arrow_type));
-		} else {
-			return_types.emplace_back(arrow_type->GetDuckType());
-			result->arrow_table.AddColumn(col_idx, std::move(arrow_type));
-		}
-
-		// keep these around for projection/filter pushdown later
-		// does GDAL even allow duplicate/missing names?
-		result->all_names.push_back(column_name);
-
-		if (column_name.empty()) {
-			names.push_back("v" + to_string(col_idx));
-		} else {
-			names.push_back(column_name);
 		}
 	}
 
-	schema.release(&schema);
-	stream.release(&stream);
-
-	GdalTableFunction::RenameColumns(names);
+	if (result->filename_column_idx != DConstants::INVALID_INDEX) {
+		result->filename_column_idx = names.size();
+		names.push_back("filename");
+		return_types.push_back(LogicalType::VARCHAR);
+		GdalTableFunction::RenameColumns(names);
+	}
 
+	result->all_names = names;
 	result->all_types = return_types;
 
 	return std::move(result);
@@ -416,81 +691,185 @@ idx_t GdalTableFunction::MaxThreads(ClientContext &context, const FunctionData *
 //-----------------------------------------------------------------------------
 // Init global
 //-----------------------------------------------------------------------------
+static void ApplySpatialFilter(OGRLayer *layer, const GdalScanFunctionData &data) {
+	if (data.spatial_filter == nullptr) {
+		return;
+	}
+	if (data.spatial_filter->type == SpatialFilterType::Rectangle) {
+		auto &rect = (RectangleSpatialFilter &)*data.spatial_filter;
+		layer->SetSpatialFilterRect(rect.min_x, rect.min_y, rect.max_x, rect.max_y);
+	} else if (data.spatial_filter->type == SpatialFilterType::Wkb) {
+		auto &filter = (WKBSpatialFilter &)*data.spatial_filter;
+		layer->SetSpatialFilter(OGRGeometry::FromHandle(filter.geom));
+	}
+}
+
+// Drivers backed by SQLite pass attribute filters straight through to SQL, so a filter on the feature id
+// turns into an (indexed) rowid range scan. That makes it cheap to partition a layer into feature id ranges.
+static bool TryPartitionByFid(GdalScanGlobalState &gstate, OGRLayer *layer, const GdalScanFunctionData &data) {
+	if (data.sequential_layer_scan || data.max_threads <= 1 || !data.has_approximate_feature_count) {
+		return false;
+	}
+	auto driver = gstate.dataset->GetDriver();
+	if (!driver) {
+		return false;
+	}
+	auto driver_name = string(driver->GetDescription());
+	if (driver_name != "GPKG" && driver_name != "SQLite") {
+		return false;
+	}
+	gstate.fid_column = layer->GetFIDColumn();
+	if (gstate.fid_column.empty()) {
+		return false;
+	}
+
+	// Not worth it if there are only a few batches worth of features
+	auto min_features_per_range = (idx_t)STANDARD_VECTOR_SIZE * 4;
+	if (data.approximate_feature_count < min_features_per_range * 2) {
+		return false;
+	}
+
+	auto sql = StringUtil::Format("SELECT MIN(%s), MAX(%s) FROM %s", KeywordHelper::WriteQuoted(gstate.fid_column, '"'),
+	                              KeywordHelper::WriteQuoted(gstate.fid_column, '"'),
+	                              KeywordHelper::WriteQuoted(layer->GetName(), '"'));
+	auto result = gstate.dataset->ExecuteSQL(sql.c_str(), nullptr, nullptr);
+	if (!result) {
+		return false;
+	}
+	int64_t min_fid = 0;
+	int64_t max_fid = -1;
+	auto feature = result->GetNextFeature();
+	if (feature && feature->IsFieldSetAndNotNull(0) && feature->IsFieldSetAndNotNull(1)) {
+		min_fid = feature->GetFieldAsInteger64(0);
+		max_fid = feature->GetFieldAsInteger64(1);
+	}
+	OGRFeature::DestroyFeature(feature);
+	gstate.dataset->ReleaseResultSet(result);
+	if (max_fid < min_fid) {
+		return false;
+	}
+
+	// Split the id space in a couple of ranges per thread so that the work evens out
+	auto fid_span = static_cast<idx_t>(max_fid - min_fid) + 1;
+	auto range_count = MinValue<idx_t>(data.max_threads * 4, data.approximate_feature_count / min_features_per_range);
+	auto range_size = (fid_span + range_count - 1) / range_count;
+	for (auto range_min = min_fid; range_min <= max_fid; range_min += range_size) {
+		auto range_max = MinValue<int64_t>(max_fid, range_min + range_size - 1);
+		gstate.fid_ranges.push_back({range_min, range_max});
+		if (range_max == max_fid) {
+			break;
+		}
+	}
+	return true;
+}
+
 unique_ptr<GlobalTableFunctionState> GdalTableFunction::InitGlobal(ClientContext &context,
                                                                    TableFunctionInitInput &input) {
 	auto &data = input.bind_data->Cast<GdalScanFunctionData>();
 
-	auto dataset = GDALDatasetUniquePtr(
-	    GDALDataset::Open(data.prefixed_file_name.c_str(), GDAL_OF_VECTOR | GDAL_OF_VERBOSE_ERROR,
-	                      data.dataset_allowed_drivers, data.dataset_open_options, data.dataset_sibling_files));
-	if (dataset == nullptr) {
-		auto error = string(CPLGetLastErrorMsg());
-		throw IOException("Could not open file: " + data.raw_file_name + " (" + error + ")");
+	// The columns we have to output
+	vector<idx_t> output_column_ids;
+	if (input.CanRemoveFilterColumns()) {
+		for (auto &projection_id : input.projection_ids) {
+			output_column_ids.push_back(input.column_ids[projection_id]);
+		}
+	} else {
+		output_column_ids = input.column_ids;
 	}
 
+	if (data.IsMultiFile()) {
+		// Every thread opens the files it scans itself, so there is nothing to open yet
+		auto global_state = make_uniq<GdalScanGlobalState>(nullptr);
+		global_state->is_multi_file = true;
+		global_state->column_ids = input.column_ids;
+		global_state->output_column_ids = std::move(output_column_ids);
+		global_state->filters = input.filters;
+		global_state->max_threads =
+		    MinValue<idx_t>(GdalTableFunction::MaxThreads(context, input.bind_data.get()), data.file_names.size());
+		return std::move(global_state);
+	}
+
+	auto dataset = OpenDataset(data);
+
 	auto global_state = make_uniq<GdalScanGlobalState>(std::move(dataset));
 	auto &gstate = *global_state;
 
 	// Open the layer
-	OGRLayer *layer = nullptr;
-	if (data.sequential_layer_scan) {
-		// Get the layer from the dataset by scanning through the layers
-		for (int i = 0; i < gstate.dataset->GetLayerCount(); i++) {
-			layer = gstate.dataset->GetLayer(i);
-			if (i == data.layer_idx) {
-				// desired layer found
-				break;
-			}
-			// else scan through and empty the layer
-			OGRFeature *feature;
-			while ((feature = layer->GetNextFeature()) != nullptr) {
-				OGRFeature::DestroyFeature(feature);
-			}
-		}
-	} else {
-		// Otherwise get the layer directly
-		layer = gstate.dataset->GetLayer(data.layer_idx);
-	}
+	auto layer = GetScanLayer(*gstate.dataset, data, data.raw_file_name);
 
 	// Apply spatial filter (if we got one)
-	if (data.spatial_filter != nullptr) {
-		if (data.spatial_filter->type == SpatialFilterType::Rectangle) {
-			auto &rect = (RectangleSpatialFilter &)*data.spatial_filter;
-			layer->SetSpatialFilterRect(rect.min_x, rect.min_y, rect.max_x, rect.max_y);
-		} else if (data.spatial_filter->type == SpatialFilterType::Wkb) {
-			auto &filter = (WKBSpatialFilter &)*data.spatial_filter;
-			layer->SetSpatialFilter(OGRGeometry::FromHandle(filter.geom));
+	ApplySpatialFilter(layer, data);
+
+	// Apply projection pushdown
+	// Tell GDAL to ignore all the fields we dont need, so that they are neither read nor converted to arrow.
+	// The arrow stream will then only contain the projected columns, in their original order.
+	set<idx_t> projected_ids;
+	for (auto &col_idx : input.column_ids) {
+		if (col_idx != COLUMN_IDENTIFIER_ROW_ID) {
+			projected_ids.insert(col_idx);
 		}
 	}
-	// TODO: Apply projection pushdown
+	if (projected_ids.empty()) {
+		// We still need something to count the rows by (e.g. COUNT(*))
+		projected_ids.insert(0);
+	}
+	auto &ignored_fields = gstate.ignored_fields;
+	for (idx_t col_idx = 0; col_idx < data.ogr_field_names.size(); col_idx++) {
+		if (projected_ids.find(col_idx) != projected_ids.end()) {
+			continue;
+		}
+		// Keep the geometry around if we are filtering on it
+		if (data.spatial_filter && data.geometry_column_ids.find(col_idx) != data.geometry_column_ids.end()) {
+			projected_ids.insert(col_idx);
+			continue;
+		}
+		ignored_fields.AddString(data.ogr_field_names[col_idx].c_str());
+	}
+	if (layer->SetIgnoredFields(const_cast<const char **>(ignored_fields.List())) != OGRERR_NONE) {
+		// Not all drivers support ignoring fields, in that case just read everything
+		layer->SetIgnoredFields(nullptr);
+		ignored_fields.Clear();
+		for (idx_t col_idx = 0; col_idx < data.all_names.size(); col_idx++) {
+			projected_ids.insert(col_idx);
+		}
+	}
+	gstate.stream_column_ids.assign(projected_ids.begin(), projected_ids.end());
 
 	// Apply predicate pushdown
 	// We simply create a string out of the predicates and pass it to GDAL.
 	if (input.filters) {
-		auto filter_clause = FilterToGdal(*input.filters, input.column_ids, data.all_names);
-		layer->SetAttributeFilter(filter_clause.c_str());
+		gstate.attribute_filter = FilterToGdal(*input.filters, input.column_ids, data.all_names);
+		layer->SetAttributeFilter(gstate.attribute_filter.c_str());
 	}
 
-	// Create arrow stream from layer
+	gstate.max_threads = GdalTableFunction::MaxThreads(context, input.bind_data.get());
+	gstate.output_column_ids = output_column_ids;
 
-	gstate.stream = make_uniq<ArrowArrayStreamWrapper>();
+	// Check if we can scan the layer in parallel, otherwise all threads share a single arrow stream
+	gstate.is_partitioned = TryPartitionByFid(gstate, layer, data);
+	if (gstate.is_partitioned) {
+		gstate.max_threads = MinValue<idx_t>(gstate.max_threads, gstate.fid_ranges.size());
+	} else {
+		// Create arrow stream from layer
+		gstate.stream = make_uniq<ArrowArrayStreamWrapper>();
 
-	// set layer options
-	if (!layer->GetArrowStream(&gstate.stream->arrow_array_stream, data.layer_creation_options)) {
-		throw IOException("Could not get arrow stream");
+		// set layer options
+		if (!layer->GetArrowStream(&gstate.stream->arrow_array_stream, data.layer_creation_options)) {
+			throw IOException("Could not get arrow stream");
+		}
 	}
 
-	gstate.max_threads = GdalTableFunction::MaxThreads(context, input.bind_data.get());
-
-	if (input.CanRemoveFilterColumns()) {
-		gstate.projection_ids = input.projection_ids;
-		for (const auto &col_idx : input.column_ids) {
-			if (col_idx == COLUMN_IDENTIFIER_ROW_ID) {
-				gstate.scanned_types.emplace_back(LogicalType::ROW_TYPE);
-			} else {
-				gstate.scanned_types.push_back(data.all_types[col_idx]);
-			}
+	// Map every output column to its position in the arrow stream
+	for (auto &col_idx : output_column_ids) {
+		if (col_idx == COLUMN_IDENTIFIER_ROW_ID) {
+			gstate.output_stream_idx.push_back(DConstants::INVALID_INDEX);
+			continue;
 		}
+		auto it = std::lower_bound(gstate.stream_column_ids.begin(), gstate.stream_column_ids.end(), col_idx);
+		gstate.output_stream_idx.push_back(it - gstate.stream_column_ids.begin());
+	}
+	for (auto &col_idx : gstate.stream_column_ids) {
+		gstate.scanned_types.push_back(data.all_types[col_idx]);
 	}
 
 	return std::move(global_state);
@@ -499,20 +878,393 @@ unique_ptr<GlobalTableFunctionState> GdalTableFunction::InitGlobal(ClientContext
 //-----------------------------------------------------------------------------
 // Init Local
 //-----------------------------------------------------------------------------
+
+// Get the next arrow chunk for a partitioned scan, moving on to the next feature id range when the current is done
+static bool GdalPartitionedScanNext(const GdalScanFunctionData &data, GdalScanLocalState &state,
+                                    GdalScanGlobalState &gstate) {
+	while (true) {
+		if (state.range_stream) {
+			auto current_chunk = state.range_stream->GetNextChunk();
+			while (current_chunk->arrow_array.length == 0 && current_chunk->arrow_array.release) {
+				current_chunk = state.range_stream->GetNextChunk();
+			}
+			if (current_chunk->arrow_array.release) {
+				state.Reset();
+				state.chunk = std::move(current_chunk);
+				// Every chunk contains at least one feature, so offsetting by the feature id keeps batches ordered
+				auto &range = gstate.fid_ranges[state.range_idx];
+				auto range_offset = static_cast<idx_t>(range.min_fid - gstate.fid_ranges[0].min_fid);
+				state.batch_index = range_offset + state.range_chunk_idx++;
+				// A range has at most as many features as it has feature ids, so the same goes for the row ids
+				state.chunk_row_id = range_offset + state.next_row_id;
+				state.next_row_id += state.chunk->arrow_array.length;
+				return true;
+			}
+			// This range is exhausted
+			state.range_stream.reset();
+		}
+
+		state.range_idx = gstate.next_fid_range++;
+		if (state.range_idx >= gstate.fid_ranges.size()) {
+			return false;
+		}
+		state.range_chunk_idx = 0;
+		state.next_row_id = 0;
+
+		// Open our own dataset the first time around, GDAL datasets are not thread-safe
+		if (!state.dataset) {
+			state.dataset = OpenDataset(data);
+			state.layer = state.dataset->GetLayer(data.layer_idx);
+			ApplySpatialFilter(state.layer, data);
+			state.layer->SetIgnoredFields(const_cast<const char **>(gstate.ignored_fields.List()));
+		}
+
+		auto &range = gstate.fid_ranges[state.range_idx];
+		auto fid_column = KeywordHelper::WriteQuoted(gstate.fid_column, '"');
+		auto range_filter = fid_column + " >= " + std::to_string(range.min_fid) + " AND " + fid_column +
+		                    " <= " + std::to_string(range.max_fid);
+		if (!gstate.attribute_filter.empty()) {
+			range_filter = "(" + gstate.attribute_filter + ") AND " + range_filter;
+		}
+		if (state.layer->SetAttributeFilter(range_filter.c_str()) != OGRERR_NONE) {
+			throw IOException("Could not apply attribute filter to layer: %s", range_filter);
+		}
+
+		state.range_stream = make_uniq<ArrowArrayStreamWrapper>();
+		if (!state.layer->GetArrowStream(&state.range_stream->arrow_array_stream, data.layer_creation_options)) {
+			throw IOException("Could not get arrow stream");
+		}
+	}
+}
+
+// Check a filter against a value that is the same for a whole file, i.e. the file name or a missing column
+static bool FilterMatchesValue(const TableFilter &filter, const Value &value) {
+	switch (filter.filter_type) {
+	case TableFilterType::CONSTANT_COMPARISON: {
+		auto &constant_filter = filter.Cast<ConstantFilter>();
+		if (value.IsNull()) {
+			return false;
+		}
+		auto &constant = constant_filter.constant;
+		switch (constant_filter.comparison_type) {
+		case ExpressionType::COMPARE_EQUAL:
+			return value == constant;
+		case ExpressionType::COMPARE_NOTEQUAL:
+			return value != constant;
+		case ExpressionType::COMPARE_LESSTHAN:
+			return value < constant;
+		case ExpressionType::COMPARE_GREATERTHAN:
+			return value > constant;
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+			return value <= constant;
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			return value >= constant;
+		default:
+			throw NotImplementedException("FilterMatchesValue: comparison type not implemented");
+		}
+	}
+	case TableFilterType::CONJUNCTION_AND: {
+		auto &and_filter = filter.Cast<ConjunctionAndFilter>();
+		for (const auto &child_filter : and_filter.child_filters) {
+			if (!FilterMatchesValue(*child_filter, value)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	case TableFilterType::CONJUNCTION_OR: {
+		auto &or_filter = filter.Cast<ConjunctionOrFilter>();
+		for (const auto &child_filter : or_filter.child_filters) {
+			if (FilterMatchesValue(*child_filter, value)) {
+				return true;
+			}
+		}
+		return false;
+	}
+	case TableFilterType::IS_NOT_NULL:
+		return !value.IsNull();
+	case TableFilterType::IS_NULL:
+		return value.IsNull();
+	default:
+		throw NotImplementedException("FilterMatchesValue: filter type not implemented");
+	}
+}
+
+// Turn a filter on the output column col_idx into an expression
+static unique_ptr<Expression> FilterToExpression(const TableFilter &filter, const LogicalType &type, idx_t col_idx) {
+	switch (filter.filter_type) {
+	case TableFilterType::CONSTANT_COMPARISON: {
+		auto &constant_filter = filter.Cast<ConstantFilter>();
+		return make_uniq<BoundComparisonExpression>(constant_filter.comparison_type,
+		                                            make_uniq<BoundReferenceExpression>(type, col_idx),
+		                                            make_uniq<BoundConstantExpression>(constant_filter.constant));
+	}
+	case TableFilterType::CONJUNCTION_AND: {
+		auto &and_filter = filter.Cast<ConjunctionAndFilter>();
+		auto result = make_uniq<BoundConjunctionExpression>(ExpressionType::CONJUNCTION_AND);
+		for (const auto &child_filter : and_filter.child_filters) {
+			result->children.push_back(FilterToExpression(*child_filter, type, col_idx));
+		}
+		return std::move(result);
+	}
+	case TableFilterType::CONJUNCTION_OR: {
+		auto &or_filter = filter.Cast<ConjunctionOrFilter>();
+		auto result = make_uniq<BoundConjunctionExpression>(ExpressionType::CONJUNCTION_OR);
+		for (const auto &child_filter : or_filter.child_filters) {
+			result->children.push_back(FilterToExpression(*child_filter, type, col_idx));
+		}
+		return std::move(result);
+	}
+	case TableFilterType::IS_NOT_NULL:
+	case TableFilterType::IS_NULL: {
+		auto result = make_uniq<BoundOperatorExpression>(filter.filter_type == TableFilterType::IS_NULL
+		                                                     ? ExpressionType::OPERATOR_IS_NULL
+		                                                     : ExpressionType::OPERATOR_IS_NOT_NULL,
+		                                                 LogicalType::BOOLEAN);
+		result->children.push_back(make_uniq<BoundReferenceExpression>(type, col_idx));
+		return std::move(result);
+	}
+	default:
+		throw NotImplementedException("FilterToExpression: filter type not implemented");
+	}
+}
+
+// Set up the scan of the file state.file_idx, returns false if the filters rule out the whole file
+static bool GdalInitFileScan(ClientContext &context, const GdalScanFunctionData &data, GdalScanLocalState &state,
+                             const GdalScanGlobalState &gstate) {
+	auto &file_name = data.file_names[state.file_idx];
+
+	// Check the filters on the file name before opening the file
+	if (gstate.filters) {
+		for (auto &entry : gstate.filters->filters) {
+			auto col_idx = gstate.column_ids[entry.first];
+			if (col_idx == data.filename_column_idx && !FilterMatchesValue(*entry.second, Value(file_name))) {
+				return false;
+			}
+		}
+	}
+
+	state.dataset = OpenDataset(data, file_name);
+	state.layer = GetScanLayer(*state.dataset, data, file_name);
+	state.file_schema = GdalLayerSchema();
+	BindLayerSchema(state.layer, data, state.file_schema);
+	auto &schema = state.file_schema;
+
+	// Find the columns of this file by name
+	case_insensitive_map_t<idx_t> file_column_map;
+	for (idx_t col_idx = 0; col_idx < schema.names.size(); col_idx++) {
+		file_column_map[schema.names[col_idx]] = col_idx;
+	}
+	vector<idx_t> file_column_ids;
+	for (idx_t col_idx = 0; col_idx < data.all_names.size(); col_idx++) {
+		if (col_idx == data.filename_column_idx) {
+			file_column_ids.push_back(DConstants::INVALID_INDEX);
+			continue;
+		}
+		auto entry = file_column_map.find(data.all_names[col_idx]);
+		if (entry != file_column_map.end()) {
+			file_column_ids.push_back(entry->second);
+		} else if (data.union_by_name) {
+			file_column_ids.push_back(DConstants::INVALID_INDEX);
+		} else {
+			throw InvalidInputException("File '%s' does not have a column named \"%s\", set union_by_name = true to "
+			                            "read files with different columns",
+			                            file_name, data.all_names[col_idx]);
+		}
+	}
+
+	// Translate the filters to this file, columns missing from the file are all NULL. A column with a different type
+	// than in the combined schema is cast after the scan, so its filters are applied to the cast values instead
+	vector<string> attribute_filters;
+	vector<unique_ptr<Expression>> residual_filters;
+	if (gstate.filters) {
+		for (auto &entry : gstate.filters->filters) {
+			auto col_idx = gstate.column_ids[entry.first];
+			if (col_idx == COLUMN_IDENTIFIER_ROW_ID || col_idx == data.filename_column_idx) {
+				continue;
+			}
+			auto file_col_idx = file_column_ids[col_idx];
+			if (file_col_idx == DConstants::INVALID_INDEX) {
+				if (!FilterMatchesValue(*entry.second, Value(data.all_types[col_idx]))) {
+					return false;
+				}
+				continue;
+			}
+			if (schema.types[file_col_idx] != data.all_types[col_idx]) {
+				residual_filters.push_back(FilterToExpression(*entry.second, data.all_types[col_idx], entry.first));
+				continue;
+			}
+			attribute_filters.push_back(FilterToGdal(*entry.second, schema.raw_names[file_col_idx]));
+		}
+	}
+	state.residual_executor.reset();
+	state.residual_filter.reset();
+	if (residual_filters.size() == 1) {
+		state.residual_filter = std::move(residual_filters[0]);
+	} else if (!residual_filters.empty()) {
+		auto conjunction = make_uniq<BoundConjunctionExpression>(ExpressionType::CONJUNCTION_AND);
+		conjunction->children = std::move(residual_filters);
+		state.residual_filter = std::move(conjunction);
+	}
+	if (state.residual_filter) {
+		state.residual_executor = make_uniq<ExpressionExecutor>(context, *state.residual_filter);
+	}
+
+	ApplySpatialFilter(state.layer, data);
+
+	// Only read the columns we need from this file, see GdalTableFunction::InitGlobal
+	set<idx_t> projected_ids;
+	for (auto &col_idx : gstate.column_ids) {
+		if (col_idx != COLUMN_IDENTIFIER_ROW_ID && file_column_ids[col_idx] != DConstants::INVALID_INDEX) {
+			projected_ids.insert(file_column_ids[col_idx]);
+		}
+	}
+	if (projected_ids.empty()) {
+		projected_ids.insert(0);
+	}
+	CPLStringList ignored_fields;
+	for (idx_t col_idx = 0; col_idx < schema.ogr_field_names.size(); col_idx++) {
+		if (projected_ids.find(col_idx) != projected_ids.end()) {
+			continue;
+		}
+		if (data.spatial_filter && schema.geometry_column_ids.find(col_idx) != schema.geometry_column_ids.end()) {
+			projected_ids.insert(col_idx);
+			continue;
+		}
+		ignored_fields.AddString(schema.ogr_field_names[col_idx].c_str());
+	}
+	if (state.layer->SetIgnoredFields(const_cast<const char **>(ignored_fields.List())) != OGRERR_NONE) {
+		state.layer->SetIgnoredFields(nullptr);
+		for (idx_t col_idx = 0; col_idx < schema.names.size(); col_idx++) {
+			projected_ids.insert(col_idx);
+		}
+	}
+	state.column_ids.assign(projected_ids.begin(), projected_ids.end());
+
+	if (!attribute_filters.empty()) {
+		auto attribute_filter = StringUtil::Join(attribute_filters, " AND ");
+		if (state.layer->SetAttributeFilter(attribute_filter.c_str()) != OGRERR_NONE) {
+			throw IOException("Could not apply attribute filter to layer: %s", attribute_filter);
+		}
+	}
+
+	state.range_stream = make_uniq<ArrowArrayStreamWrapper>();
+	if (!state.layer->GetArrowStream(&state.range_stream->arrow_array_stream, data.layer_creation_options)) {
+		throw IOException("Could not get arrow stream");
+	}
+
+	// Map every output column to its position in the arrow stream of this file
+	state.file_output_stream_idx.clear();
+	for (auto &col_idx : gstate.output_column_ids) {
+		if (col_idx == COLUMN_IDENTIFIER_ROW_ID || file_column_ids[col_idx] == DConstants::INVALID_INDEX) {
+			state.file_output_stream_idx.push_back(DConstants::INVALID_INDEX);
+			continue;
+		}
+		auto it = std::lower_bound(state.column_ids.begin(), state.column_ids.end(), file_column_ids[col_idx]);
+		state.file_output_stream_idx.push_back(it - state.column_ids.begin());
+	}
+
+	vector<LogicalType> scanned_types;
+	for (auto &col_idx : state.column_ids) {
+		scanned_types.push_back(schema.types[col_idx]);
+	}
+	state.stream_chunk.Destroy();
+	state.stream_chunk.Initialize(context, scanned_types);
+	return true;
+}
+
+// Get the next arrow chunk when scanning multiple files, moving on to the next file when the current is done
+static bool GdalMultiFileScanNext(ClientContext &context, const GdalScanFunctionData &data, GdalScanLocalState &state,
+                                  GdalScanGlobalState &gstate) {
+	while (true) {
+		if (state.range_stream) {
+			auto current_chunk = state.range_stream->GetNextChunk();
+			while (current_chunk->arrow_array.length == 0 && current_chunk->arrow_array.release) {
+				current_chunk = state.range_stream->GetNextChunk();
+			}
+			if (current_chunk->arrow_array.release) {
+				state.Reset();
+				state.chunk = std::move(current_chunk);
+				state.batch_index = (state.file_idx << GDAL_FILE_BATCH_SHIFT) + state.range_chunk_idx++;
+				// Row ids are numbered per file and offset by the file index, so they are unique across files
+				state.chunk_row_id = (state.file_idx << GDAL_FILE_ROW_ID_SHIFT) + state.next_row_id;
+				state.next_row_id += state.chunk->arrow_array.length;
+				return true;
+			}
+			// This file is exhausted, release all arrow data before closing it
+			state.Reset();
+			state.chunk.reset();
+			state.range_stream.reset();
+			state.layer = nullptr;
+			state.dataset.reset();
+		}
+
+		state.file_idx = gstate.next_file_idx++;
+		if (state.file_idx >= data.file_names.size()) {
+			return false;
+		}
+		state.range_chunk_idx = 0;
+		state.next_row_id = 0;
+		if (!GdalInitFileScan(context, data, state, gstate)) {
+			// The filters rule out the whole file
+			state.layer = nullptr;
+			state.dataset.reset();
+		}
+	}
+}
+
+// Get the next arrow chunk from the arrow stream shared by all threads
+static bool GdalSharedScanNext(GdalScanLocalState &state, GdalScanGlobalState &gstate) {
+	lock_guard<mutex> parallel_lock(gstate.main_mutex);
+	if (gstate.done) {
+		return false;
+	}
+	state.Reset();
+	state.batch_index = ++gstate.batch_index;
+
+	auto current_chunk = gstate.stream->GetNextChunk();
+	while (current_chunk->arrow_array.length == 0 && current_chunk->arrow_array.release) {
+		current_chunk = gstate.stream->GetNextChunk();
+	}
+	state.chunk = std::move(current_chunk);
+	if (!state.chunk->arrow_array.release) {
+		gstate.done = true;
+		return false;
+	}
+	// Chunks are handed out in stream order, so this numbers the features in the order GDAL returns them
+	state.chunk_row_id = gstate.stream_rows_read;
+	gstate.stream_rows_read += state.chunk->arrow_array.length;
+	return true;
+}
+
+static bool GdalScanNext(ClientContext &context, const GdalScanFunctionData &data, GdalScanLocalState &state,
+                         GdalScanGlobalState &gstate) {
+	if (gstate.is_multi_file) {
+		return GdalMultiFileScanNext(context, data, state, gstate);
+	}
+	if (gstate.is_partitioned) {
+		return GdalPartitionedScanNext(data, state, gstate);
+	}
+	return GdalSharedScanNext(state, gstate);
+}
+
 unique_ptr<LocalTableFunctionState> GdalTableFunction::InitLocal(ExecutionContext &context,
                                                                  TableFunctionInitInput &input,
                                                                  GlobalTableFunctionState *global_state_p) {
 
-	auto &global_state = global_state_p->Cast<ArrowScanGlobalState>();
+	auto &global_state = global_state_p->Cast<GdalScanGlobalState>();
 	auto current_chunk = make_uniq<ArrowArrayWrapper>();
 	auto result = make_uniq<GdalScanLocalState>(std::move(current_chunk), context.client);
-	result->column_ids = input.column_ids;
+	// We convert the (projected) arrow stream as is, and reference the output columns from there
 	result->filters = input.filters.get();
-	if (input.CanRemoveFilterColumns()) {
-		result->all_columns.Initialize(context.client, global_state.scanned_types);
+	if (!global_state.is_multi_file) {
+		// When scanning multiple files, this is set up per file instead
+		result->column_ids = global_state.stream_column_ids;
+		result->stream_chunk.Initialize(context.client, global_state.scanned_types);
 	}
 
-	if (!ArrowScanParallelStateNext(context.client, input.bind_data.get(), *result, global_state)) {
+	auto &data = input.bind_data->Cast<GdalScanFunctionData>();
+	if (!GdalScanNext(context.client, data, *result, global_state)) {
 		return nullptr;
 	}
 
@@ -522,42 +1274,35 @@ unique_ptr<LocalTableFunctionState> GdalTableFunction::InitLocal(ExecutionContex
 //-----------------------------------------------------------------------------
 // Scan
 //-----------------------------------------------------------------------------
-void GdalTableFunction::Scan(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
-	if (!input.local_state) {
-		return;
-	}
-	auto &data = input.bind_data->Cast<GdalScanFunctionData>();
-	auto &state = input.local_state->Cast<GdalScanLocalState>();
-	auto &gstate = input.global_state->Cast<GdalScanGlobalState>();
-
+// Convert the next rows of the current arrow chunk, returns false if there is nothing left to scan
+static bool GdalScanChunk(ClientContext &context, const GdalScanFunctionData &data, GdalScanLocalState &state,
+                          GdalScanGlobalState &gstate, DataChunk &output) {
 	//! Out of tuples in this chunk
 	if (state.chunk_offset >= (idx_t)state.chunk->arrow_array.length) {
-		if (!ArrowScanParallelStateNext(context, input.bind_data.get(), state, gstate)) {
-			return;
+		if (!GdalScanNext(context, data, state, gstate)) {
+			return false;
 		}
 	}
 	auto output_size = MinValue<idx_t>(STANDARD_VECTOR_SIZE, state.chunk->arrow_array.length - state.chunk_offset);
 	gstate.lines_read += output_size;
 
-	if (gstate.CanRemoveFilterColumns()) {
-		state.all_columns.Reset();
-		state.all_columns.SetCardinality(output_size);
-		ArrowToDuckDB(state, data.arrow_table.GetColumns(), state.all_columns, gstate.lines_read - output_size, false);
-		output.ReferenceColumns(state.all_columns, gstate.projection_ids);
-	} else {
-		output.SetCardinality(output_size);
-		ArrowToDuckDB(state, data.arrow_table.GetColumns(), output, gstate.lines_read - output_size, false);
-	}
+	// The arrow stream only contains the columns we did not ignore, so it is already projected
+	state.stream_chunk.Reset();
+	state.stream_chunk.SetCardinality(output_size);
+	auto &arrow_table = gstate.is_multi_file ? state.file_schema.arrow_table : data.arrow_table;
+	ArrowToDuckDB(state, arrow_table.GetColumns(), state.stream_chunk, gstate.lines_read - output_size, true);
 
 	if (!data.keep_wkb) {
 		// Find the geometry columns
+		auto &geometry_column_ids =
+		    gstate.is_multi_file ? state.file_schema.geometry_column_ids : data.geometry_column_ids;
 		for (idx_t col_idx = 0; col_idx < state.column_ids.size(); col_idx++) {
 			auto mapped_idx = state.column_ids[col_idx];
-			if (data.geometry_column_ids.find(mapped_idx) != data.geometry_column_ids.end()) {
+			if (geometry_column_ids.find(mapped_idx) != geometry_column_ids.end()) {
 				// Found a geometry column
 				// Convert the WKB columns to a geometry column
 				state.factory.allocator.Reset();
-				auto &wkb_vec = output.data[col_idx];
+				auto &wkb_vec = state.stream_chunk.data[col_idx];
 				Vector geom_vec(core::GeoTypes::GEOMETRY(), output_size);
 				UnaryExecutor::Execute<string_t, core::geometry_t>(wkb_vec, geom_vec, output_size, [&](string_t input) {
 					auto geometry = state.wkb_reader.Deserialize(input);
@@ -565,22 +1310,109 @@ void GdalTableFunction::Scan(ClientContext &context, TableFunctionInput &input,
 					auto has_m = state.wkb_reader.GeomHasM();
 					return state.factory.Serialize(geom_vec, geometry, has_z, has_m);
 				});
-				output.data[col_idx].ReferenceAndSetType(geom_vec);
+				state.stream_chunk.data[col_idx].ReferenceAndSetType(geom_vec);
 			}
 		}
 	}
 
+	output.SetCardinality(output_size);
+	auto &output_stream_idx = gstate.is_multi_file ? state.file_output_stream_idx : gstate.output_stream_idx;
+	for (idx_t col_idx = 0; col_idx < output.ColumnCount(); col_idx++) {
+		auto output_col_idx = gstate.output_column_ids[col_idx];
+		if (output_col_idx == COLUMN_IDENTIFIER_ROW_ID) {
+			auto row_id = static_cast<int64_t>(state.chunk_row_id + state.chunk_offset);
+			output.data[col_idx].Sequence(row_id, 1, output_size);
+			continue;
+		}
+		if (gstate.is_multi_file && output_col_idx == data.filename_column_idx) {
+			output.data[col_idx].Reference(Value(data.file_names[state.file_idx]));
+			continue;
+		}
+		auto stream_idx = output_stream_idx[col_idx];
+		if (stream_idx == DConstants::INVALID_INDEX) {
+			// Columns missing from a file are NULL
+			output.data[col_idx].SetVectorType(VectorType::CONSTANT_VECTOR);
+			ConstantVector::SetNull(output.data[col_idx], true);
+			continue;
+		}
+		auto &stream_vec = state.stream_chunk.data[stream_idx];
+		if (stream_vec.GetType() == output.data[col_idx].GetType()) {
+			output.data[col_idx].Reference(stream_vec);
+		} else {
+			// The column has a different type in this file than in the combined schema
+			VectorOperations::Cast(context, stream_vec, output.data[col_idx], output_size);
+		}
+	}
+
+	state.chunk_offset += output_size;
+
+	if (state.residual_executor) {
+		SelectionVector sel(STANDARD_VECTOR_SIZE);
+		auto count = state.residual_executor->SelectExpression(output, sel);
+		if (count < output_size) {
+			output.Flatten();
+			output.Slice(sel, count);
+		}
+	}
 	output.Verify();
-	state.chunk_offset += output.size();
+	return true;
+}
+
+void GdalTableFunction::Scan(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+	if (!input.local_state) {
+		return;
+	}
+	auto &data = input.bind_data->Cast<GdalScanFunctionData>();
+	auto &state = input.local_state->Cast<GdalScanLocalState>();
+	auto &gstate = input.global_state->Cast<GdalScanGlobalState>();
+
+	// An empty chunk ends the scan, so skip over the chunks the residual filters remove entirely
+	while (GdalScanChunk(context, data, state, gstate, output) && output.size() == 0) {
+		output.Reset();
+	}
+}
+
+string GdalTableFunction::ToString(const FunctionData *bind_data_p) {
+	auto &data = bind_data_p->Cast<GdalScanFunctionData>();
+	if (!data.spatial_filter) {
+		return string();
+	}
+	if (data.spatial_filter->type != SpatialFilterType::Rectangle) {
+		return "Spatial Filter: Geometry";
+	}
+	auto &rect = (RectangleSpatialFilter &)*data.spatial_filter;
+	return StringUtil::Format("Spatial Filter:\n%s %s\n%s %s", Value::DOUBLE(rect.min_x).ToString(),
+	                          Value::DOUBLE(rect.min_y).ToString(), Value::DOUBLE(rect.max_x).ToString(),
+	                          Value::DOUBLE(rect.max_y).ToString());
 }
 
 unique_ptr<NodeStatistics> GdalTableFunction::Cardinality(ClientContext &context, const FunctionData *data) {
 	auto &gdal_data = data->Cast<GdalScanFunctionData>();
 	auto result = make_uniq<NodeStatistics>();
 
-	if (gdal_data.has_approximate_feature_count) {
-		result->has_estimated_cardinality = true;
-		result->estimated_cardinality = gdal_data.approximate_feature_count;
+	if (!gdal_data.has_approximate_feature_count) {
+		return result;
+	}
+	result->has_estimated_cardinality = true;
+	result->estimated_cardinality = gdal_data.approximate_feature_count;
+
+	// If we know the extent of the layer, assume the features are spread evenly over it and scale the estimate
+	// by how much of it the spatial filter covers
+	if (gdal_data.has_extent && gdal_data.spatial_filter &&
+	    gdal_data.spatial_filter->type == SpatialFilterType::Rectangle) {
+		auto &rect = (RectangleSpatialFilter &)*gdal_data.spatial_filter;
+		auto &extent = gdal_data.extent;
+		auto width = MinValue(rect.max_x, extent.MaxX) - MaxValue(rect.min_x, extent.MinX);
+		auto height = MinValue(rect.max_y, extent.MaxY) - MaxValue(rect.min_y, extent.MinY);
+		auto extent_width = extent.MaxX - extent.MinX;
+		auto extent_height = extent.MaxY - extent.MinY;
+		if (width < 0 || height < 0) {
+			result->estimated_cardinality = 0;
+		} else if (extent_width > 0 && extent_height > 0) {
+			auto fraction = (width / extent_width) * (height / extent_height);
+			result->estimated_cardinality = MaxValue<idx_t>(
+			    1, static_cast<idx_t>(fraction * static_cast<double>(gdal_data.approximate_feature_count)));
+		}
 	}
 	return result;
 }
@@ -602,6 +1434,164 @@ unique_ptr<TableRef> GdalTableFunction::ReplacementScan(ClientContext &, const s
 	return nullptr;
 }
 
+//-----------------------------------------------------------------------------
+// Spatial Filter Pushdown
+//-----------------------------------------------------------------------------
+//
+//	Derives a spatial filter rectangle for ST_Read from spatial predicates in a
+//  filter directly on top of the scan, e.g.
+//
+//		SELECT * FROM ST_Read('...') WHERE ST_Intersects(geom, <constant>)
+//
+//  All spatial predicates (except st_disjoint) imply an intersection of the
+//  bounding boxes of the two geometries, and ST_DWithin implies an intersection
+//  with the bounding box expanded by the distance. The predicate itself is kept
+//  above the scan, GDAL only uses the rectangle to skip features early (and use
+//  its spatial index, if the format has one).
+//
+class GdalSpatialFilterPushdown : public OptimizerExtension {
+public:
+	GdalSpatialFilterPushdown() {
+		optimize_function = GdalSpatialFilterPushdown::Optimize;
+	}
+
+	static bool TryGetConstantBounds(ClientContext &context, const Expression &expr, core::BoundingBox &bbox) {
+		if (!expr.IsFoldable() || expr.return_type != core::GeoTypes::GEOMETRY()) {
+			return false;
+		}
+		Value value;
+		if (!ExpressionExecutor::TryEvaluateScalar(context, expr, value) || value.IsNull()) {
+			return false;
+		}
+		auto &blob = StringValue::Get(value);
+		core::geometry_t geom(string_t(blob.c_str(), blob.size()));
+		return core::GeometryFactory::TryGetSerializedBoundingBox(geom, bbox);
+	}
+
+	// Returns true if the expression is a reference to the geometry column GDAL applies the spatial filter to
+	static bool IsFilterColumn(const Expression &expr, const LogicalGet &get, idx_t filter_column_idx) {
+		if (expr.type != ExpressionType::BOUND_COLUMN_REF) {
+			return false;
+		}
+		auto &colref = expr.Cast<BoundColumnRefExpression>();
+		if (colref.depth != 0 || colref.binding.table_index != get.table_index ||
+		    colref.binding.column_index >= get.column_ids.size()) {
+			return false;
+		}
+		return get.column_ids[colref.binding.column_index] == filter_column_idx;
+	}
+
+	static bool TryGetPredicateBounds(ClientContext &context, const Expression &expr, const LogicalGet &get,
+	                                  idx_t filter_column_idx, core::BoundingBox &bbox) {
+		if (expr.type != ExpressionType::BOUND_FUNCTION) {
+			return false;
+		}
+		auto &func = expr.Cast<BoundFunctionExpression>();
+
+		static const case_insensitive_set_t predicates = {
+		    "st_equals",   "st_intersects", "st_touches",   "st_crosses",          "st_within",           "st_contains",
+		    "st_overlaps", "st_covers",     "st_coveredby", "st_containsproperly", "st_intersects_extent"};
+
+		auto is_dwithin = StringUtil::CIEquals(func.function.name, "st_dwithin");
+		if (!is_dwithin && predicates.find(func.function.name) == predicates.end()) {
+			return false;
+		}
+		if (func.children.size() != (is_dwithin ? 3 : 2)) {
+			return false;
+		}
+
+		// One side has to be the geometry column, the other a constant geometry
+		idx_t constant_idx;
+		if (IsFilterColumn(*func.children[0], get, filter_column_idx)) {
+			constant_idx = 1;
+		} else if (IsFilterColumn(*func.children[1], get, filter_column_idx)) {
+			constant_idx = 0;
+		} else {
+			return false;
+		}
+		if (!TryGetConstantBounds(context, *func.children[constant_idx], bbox)) {
+			return false;
+		}
+
+		if (is_dwithin) {
+			auto &distance_expr = *func.children[2];
+			Value distance;
+			if (!distance_expr.IsFoldable() ||
+			    !ExpressionExecutor::TryEvaluateScalar(context, distance_expr, distance) || distance.IsNull()) {
+				return false;
+			}
+			auto dist = DoubleValue::Get(distance.DefaultCastAs(LogicalType::DOUBLE));
+			if (dist < 0 || !std::isfinite(dist)) {
+				return false;
+			}
+			bbox.minx -= dist;
+			bbox.miny -= dist;
+			bbox.maxx += dist;
+			bbox.maxy += dist;
+		}
+		return true;
+	}
+
+	static void TryOptimize(ClientContext &context, unique_ptr<LogicalOperator> &plan) {
+		if (plan->type != LogicalOperatorType::LOGICAL_FILTER || plan->children.empty() ||
+		    plan->children[0]->type != LogicalOperatorType::LOGICAL_GET) {
+			return;
+		}
+		auto &filter = plan->Cast<LogicalFilter>();
+		auto &get = plan->children[0]->Cast<LogicalGet>();
+		if (!StringUtil::CIEquals(get.function.name, "st_read") || !get.bind_data) {
+			return;
+		}
+		auto &data = get.bind_data->Cast<GdalScanFunctionData>();
+
+		// GDAL applies the spatial filter to the first geometry field, and we cant express it
+		// in terms of the WKB_BLOB column if we're keeping the geometries as WKB.
+		if (data.keep_wkb || data.geometry_column_ids.empty()) {
+			return;
+		}
+		auto filter_column_idx = *std::min_element(data.geometry_column_ids.begin(), data.geometry_column_ids.end());
+
+		// GDAL keeps the features that intersect the filter rectangle, not just their envelope. A geometry can
+		// intersect two boxes without intersecting the overlap of the two, so we cant combine the boxes of multiple
+		// predicates (or an explicit spatial filter) into one rectangle. Keep an explicit filter as it is, otherwise
+		// push the smallest box, the other predicates are still checked above the scan.
+		if (data.spatial_filter) {
+			return;
+		}
+		core::BoundingBox filter_bbox;
+		auto found = false;
+		for (auto &expr : filter.expressions) {
+			core::BoundingBox bbox;
+			if (!TryGetPredicateBounds(context, *expr, get, filter_column_idx, bbox)) {
+				continue;
+			}
+			auto area = (bbox.maxx - bbox.minx) * (bbox.maxy - bbox.miny);
+			if (!found || area < (filter_bbox.maxx - filter_bbox.minx) * (filter_bbox.maxy - filter_bbox.miny)) {
+				filter_bbox = bbox;
+				found = true;
+			}
+		}
+		if (!found) {
+			return;
+		}
+		data.spatial_filter =
+		    make_uniq<RectangleSpatialFilter>(filter_bbox.minx, filter_bbox.miny, filter_bbox.maxx, filter_bbox.maxy);
+	}
+
+	static void Optimize(ClientContext &context, OptimizerExtensionInfo *info, unique_ptr<LogicalOperator> &plan) {
+
+		TryOptimize(context, plan);
+
+		// Recursively optimize the children
+		for (auto &child : plan->children) {
+			Optimize(context, info, child);
+		}
+	}
+};
+
+//-----------------------------------------------------------------------------
+// Register
+//-----------------------------------------------------------------------------
 void GdalTableFunction::Register(DatabaseInstance &db) {
 
 	TableFunctionSet set("ST_Read");
@@ -609,6 +1599,7 @@ void GdalTableFunction::Register(DatabaseInstance &db) {
 	                   GdalTableFunction::InitGlobal, GdalTableFunction::InitLocal);
 
 	scan.cardinality = GdalTableFunction::Cardinality;
+	scan.to_string = GdalTableFunction::ToString;
 	scan.get_batch_index = ArrowTableFunction::ArrowGetBatchIndex;
 
 	scan.projection_pushdown = true;
@@ -623,6 +1614,12 @@ void GdalTableFunction::Register(DatabaseInstance &db) {
 	scan.named_parameters["sequential_layer_scan"] = LogicalType::BOOLEAN;
 	scan.named_parameters["max_batch_size"] = LogicalType::INTEGER;
 	scan.named_parameters["keep_wkb"] = LogicalType::BOOLEAN;
+	scan.named_parameters["union_by_name"] = LogicalType::BOOLEAN;
+	scan.named_parameters["filename"] = LogicalType::BOOLEAN;
+	set.AddFunction(scan);
+
+	// Multiple files (or glob patterns) can also be passed as a list
+	scan.arguments = {LogicalType::LIST(LogicalType::VARCHAR)};
 	set.AddFunction(scan);
 
 	ExtensionUtil::RegisterFunction(db, set);
@@ -630,6 +1627,9 @@ void GdalTableFunction::Register(DatabaseInstance &db) {
 	// Replacement scan
 	auto &config = DBConfig::GetConfig(db);
 	config.replacement_scans.emplace_back(GdalTableFunction::ReplacementScan);
+
+	// Push spatial predicates down into the scan
+	config.optimizer_extensions.push_back(GdalSpatialFilterPushdown());
 }
 
 } // namespace gdal
@@ -1,4 +1,5 @@
 #include "duckdb/catalog/catalog.hpp"
+#include "duckdb/common/types/column/column_data_collection.hpp"
 #include "duckdb/common/types/value.hpp"
 #include "duckdb/function/copy_function.hpp"
 #include "duckdb/function/table_function.hpp"
@@ -7,6 +8,7 @@
 #include "duckdb/parser/parsed_data/copy_info.hpp"
 #include "duckdb/parser/parsed_data/create_copy_function_info.hpp"
 #include "duckdb/parser/parsed_data/create_table_function_info.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
 #include "spatial/core/types.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
 #include "spatial/core/geometry/geometry_type.hpp"
@@ -31,6 +33,10 @@ struct BindData : public TableFunctionData {
 	CPLStringList layer_creation_options;
 	string target_srs;
 	OGRwkbGeometryType geometry_type = wkbUnknown;
+	// The number of features to insert per transaction, for drivers that support transactions
+	idx_t transaction_size = 100000;
+	// Whether to create the spatial index once all features are written (GPKG only)
+	bool deferred_spatial_index = false;
 
 	BindData(string file_path, vector<LogicalType> field_sql_types, vector<string> field_names)
 	    : file_path(std::move(file_path)), field_sql_types(std::move(field_sql_types)),
@@ -40,6 +46,8 @@ struct BindData : public TableFunctionData {
 
 struct LocalState : public LocalFunctionData {
 	core::GeometryFactory factory;
+	// The features of the current chunk, built by this thread before appending them to the layer
+	vector<OGRFeatureUniquePtr> features;
 	explicit LocalState(ClientContext &context) : factory(BufferAllocator::Get(context)) {
 	}
 };
@@ -49,6 +57,8 @@ struct GlobalState : public GlobalFunctionData {
 	GDALDatasetUniquePtr dataset;
 	OGRLayer *layer;
 	vector<unique_ptr<OGRFieldDefn>> field_defs;
+	bool in_transaction = false;
+	idx_t features_in_transaction = 0;
 
 	GlobalState(GDALDatasetUniquePtr dataset, OGRLayer *layer, vector<unique_ptr<OGRFieldDefn>> field_defs)
 	    : dataset(std::move(dataset)), layer(layer), field_defs(std::move(field_defs)) {
@@ -125,6 +135,13 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, CopyFunctionBindInp
 			} else {
 				throw BinderException("Geometry type must be a string");
 			}
+		} else if (StringUtil::Upper(option.first) == "TRANSACTION_SIZE") {
+			auto &set = option.second.front();
+			auto size = set.DefaultCastAs(LogicalType::BIGINT).GetValue<int64_t>();
+			if (size <= 0) {
+				throw BinderException("Transaction size must be positive");
+			}
+			bind_data->transaction_size = static_cast<idx_t>(size);
 		} else if (StringUtil::Upper(option.first) == "SRS") {
 			auto &set = option.second.front();
 			if (set.type().id() == LogicalTypeId::VARCHAR) {
@@ -173,6 +190,13 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, CopyFunctionBindInp
 		throw BinderException("OpenFileGDB requires 'GEOMETRY_TYPE' parameter to be set when writing!");
 	}
 
+	// Maintaining the R-tree of a GeoPackage for every inserted feature is slow, so unless the user
+	// asked for something else we create it in one go when all the features have been written.
+	if (bind_data->driver_name == "GPKG" && !bind_data->layer_creation_options.FetchNameValue("SPATIAL_INDEX")) {
+		bind_data->layer_creation_options.SetNameValue("SPATIAL_INDEX", "NO");
+		bind_data->deferred_spatial_index = true;
+	}
+
 	return std::move(bind_data);
 }
 
@@ -331,6 +355,13 @@ static unique_ptr<GlobalFunctionData> InitGlobal(ClientContext &context, Functio
 	}
 	auto global_data = make_uniq<GlobalState>(std::move(dataset), layer, std::move(field_defs));
 
+	// Group the inserts into large transactions if the driver supports it (e.g. GPKG and SQLite),
+	// otherwise every feature may end up in its own implicit transaction.
+	if (global_data->dataset->TestCapability(ODsCTransactions) &&
+	    global_data->dataset->StartTransaction() == OGRERR_NONE) {
+		global_data->in_transaction = true;
+	}
+
 	return std::move(global_data);
 }
 
@@ -338,156 +369,245 @@ static unique_ptr<GlobalFunctionData> InitGlobal(ClientContext &context, Functio
 // Sink
 //===--------------------------------------------------------------------===//
 
-static OGRGeometryUniquePtr OGRGeometryFromValue(const LogicalType &type, const Value &value,
-                                                 core::GeometryFactory &factory) {
-	if (type == core::GeoTypes::WKB_BLOB()) {
-		auto str = value.GetValueUnsafe<string_t>();
-
-		OGRGeometry *ptr;
-		size_t consumed;
-		auto ok = OGRGeometryFactory::createFromWkb(str.GetDataUnsafe(), nullptr, &ptr, str.GetSize(), wkbVariantIso,
-		                                            consumed);
+// Features are built column by column, directly from the vector data
+
+static void SetOgrDateTimeField(OGRFeature &feature, int field_idx, timestamp_t timestamp) {
+	auto date = Timestamp::GetDate(timestamp);
+	auto time = Timestamp::GetTime(timestamp);
+	auto year = Date::ExtractYear(date);
+	auto month = Date::ExtractMonth(date);
+	auto day = Date::ExtractDay(date);
+	auto hour = static_cast<int>((time.micros % Interval::MICROS_PER_DAY) / Interval::MICROS_PER_HOUR);
+	auto minute = static_cast<int>((time.micros % Interval::MICROS_PER_HOUR) / Interval::MICROS_PER_MINUTE);
+	auto second = static_cast<float>(static_cast<double>(time.micros % Interval::MICROS_PER_MINUTE) /
+	                                 static_cast<double>(Interval::MICROS_PER_SEC));
+	feature.SetField(field_idx, year, month, day, hour, minute, second, 0);
+}
 
-		if (ok != OGRERR_NONE) {
-			throw IOException("Could not parse WKB");
-		}
-		return OGRGeometryUniquePtr(ptr);
-	} else if (type == core::GeoTypes::GEOMETRY()) {
-		auto blob = value.GetValueUnsafe<string_t>();
-		uint32_t size;
-		auto wkb = core::WKBWriter::Write(core::geometry_t(blob), &size, factory.allocator);
-		OGRGeometry *ptr;
-		auto ok = OGRGeometryFactory::createFromWkb(wkb, nullptr, &ptr, size, wkbVariantIso);
-		if (ok != OGRERR_NONE) {
-			throw IOException("Could not parse WKB");
+template <class T, class OP>
+static void SetOgrFieldColumn(vector<OGRFeatureUniquePtr> &features, int field_idx, Vector &vec, idx_t count,
+                              OP &&op) {
+	UnifiedVectorFormat format;
+	vec.ToUnifiedFormat(count, format);
+	auto data = UnifiedVectorFormat::GetData<T>(format);
+	for (idx_t row_idx = 0; row_idx < count; row_idx++) {
+		auto idx = format.sel->get_index(row_idx);
+		if (!format.validity.RowIsValid(idx)) {
+			features[row_idx]->SetFieldNull(field_idx);
+		} else {
+			op(*features[row_idx], data[idx]);
 		}
-		return OGRGeometryUniquePtr(ptr);
-	} else if (type == core::GeoTypes::POINT_2D()) {
-		auto children = StructValue::GetChildren(value);
-		auto x = children[0].GetValue<double>();
-		auto y = children[1].GetValue<double>();
-		auto ogr_point = new OGRPoint(x, y);
-		return OGRGeometryUniquePtr(ogr_point);
-	} else {
-		throw NotImplementedException("Unsupported geometry type");
 	}
 }
 
-static void SetOgrFieldFromValue(OGRFeature *feature, int field_idx, const LogicalType &type, const Value &value) {
-	// TODO: Set field by index always instead of by name for performance.
-	if (value.IsNull()) {
-		feature->SetFieldNull(field_idx);
-		return;
-	}
+static void SetOgrFieldFromVector(vector<OGRFeatureUniquePtr> &features, int field_idx, const LogicalType &type,
+                                  Vector &vec, idx_t count) {
 	switch (type.id()) {
 	case LogicalTypeId::BOOLEAN:
-		feature->SetField(field_idx, value.GetValue<bool>());
+		SetOgrFieldColumn<bool>(features, field_idx, vec, count,
+		                        [&](OGRFeature &feature, bool value) { feature.SetField(field_idx, value); });
 		break;
 	case LogicalTypeId::TINYINT:
-		feature->SetField(field_idx, value.GetValue<int8_t>());
+		SetOgrFieldColumn<int8_t>(features, field_idx, vec, count,
+		                          [&](OGRFeature &feature, int8_t value) { feature.SetField(field_idx, value); });
 		break;
 	case LogicalTypeId::SMALLINT:
-		feature->SetField(field_idx, value.GetValue<int16_t>());
+		SetOgrFieldColumn<int16_t>(features, field_idx, vec, count,
+		                           [&](OGRFeature &feature, int16_t value) { feature.SetField(field_idx, value); });
 		break;
 	case LogicalTypeId::INTEGER:
-		feature->SetField(field_idx, value.GetValue<int32_t>());
+		SetOgrFieldColumn<int32_t>(features, field_idx, vec, count,
+		                           [&](OGRFeature &feature, int32_t value) { feature.SetField(field_idx, value); });
 		break;
 	case LogicalTypeId::BIGINT:
-		feature->SetField(field_idx, (GIntBig)value.GetValue<int64_t>());
+		SetOgrFieldColumn<int64_t>(features, field_idx, vec, count, [&](OGRFeature &feature, int64_t value) {
+			feature.SetField(field_idx, (GIntBig)value);
+		});
 		break;
 	case LogicalTypeId::FLOAT:
-		feature->SetField(field_idx, value.GetValue<float>());
+		SetOgrFieldColumn<float>(features, field_idx, vec, count,
+		                         [&](OGRFeature &feature, float value) { feature.SetField(field_idx, value); });
 		break;
 	case LogicalTypeId::DOUBLE:
-		feature->SetField(field_idx, value.GetValue<double>());
+		SetOgrFieldColumn<double>(features, field_idx, vec, count,
+		                          [&](OGRFeature &feature, double value) { feature.SetField(field_idx, value); });
 		break;
 	case LogicalTypeId::VARCHAR:
-	case LogicalTypeId::BLOB: {
-		auto str = value.GetValueUnsafe<string_t>();
-		feature->SetField(field_idx, (int)str.GetSize(), str.GetDataUnsafe());
-	} break;
-	case LogicalTypeId::DATE: {
-		auto date = value.GetValueUnsafe<date_t>();
-		auto year = Date::ExtractYear(date);
-		auto month = Date::ExtractMonth(date);
-		auto day = Date::ExtractDay(date);
-		feature->SetField(field_idx, year, month, day, 0, 0, 0, 0);
-	} break;
-	case LogicalTypeId::TIME: {
-		auto time = value.GetValueUnsafe<dtime_t>();
-		auto hour = static_cast<int>(time.micros / Interval::MICROS_PER_HOUR);
-		auto minute = static_cast<int>((time.micros % Interval::MICROS_PER_HOUR) / Interval::MICROS_PER_MINUTE);
-		auto second = static_cast<float>(static_cast<double>(time.micros % Interval::MICROS_PER_MINUTE) /
-		                                 static_cast<double>(Interval::MICROS_PER_SEC));
-		feature->SetField(field_idx, 0, 0, 0, hour, minute, second, 0);
-	} break;
-	case LogicalTypeId::TIMESTAMP: {
-		auto timestamp = value.GetValueUnsafe<timestamp_t>();
-		auto date = Timestamp::GetDate(timestamp);
-		auto time = Timestamp::GetTime(timestamp);
-		auto year = Date::ExtractYear(date);
-		auto month = Date::ExtractMonth(date);
-		auto day = Date::ExtractDay(date);
-		auto hour = static_cast<int>((time.micros % Interval::MICROS_PER_DAY) / Interval::MICROS_PER_HOUR);
-		auto minute = static_cast<int>((time.micros % Interval::MICROS_PER_HOUR) / Interval::MICROS_PER_MINUTE);
-		auto second = static_cast<float>(static_cast<double>(time.micros % Interval::MICROS_PER_MINUTE) /
-		                                 static_cast<double>(Interval::MICROS_PER_SEC));
-		feature->SetField(field_idx, year, month, day, hour, minute, second, 0);
-	} break;
-	case LogicalTypeId::TIMESTAMP_NS: {
-		auto timestamp = value.GetValueUnsafe<timestamp_t>();
-		timestamp = Timestamp::FromEpochNanoSeconds(timestamp.value);
-		auto date = Timestamp::GetDate(timestamp);
-		auto time = Timestamp::GetTime(timestamp);
-		auto year = Date::ExtractYear(date);
-		auto month = Date::ExtractMonth(date);
-		auto day = Date::ExtractDay(date);
-		auto hour = static_cast<int>((time.micros % Interval::MICROS_PER_DAY) / Interval::MICROS_PER_HOUR);
-		auto minute = static_cast<int>((time.micros % Interval::MICROS_PER_HOUR) / Interval::MICROS_PER_MINUTE);
-		auto second = static_cast<float>(static_cast<double>(time.micros % Interval::MICROS_PER_MINUTE) /
-		                                 static_cast<double>(Interval::MICROS_PER_SEC));
-		feature->SetField(field_idx, year, month, day, hour, minute, second, 0);
-	} break;
-	case LogicalTypeId::TIMESTAMP_MS: {
-		auto timestamp = value.GetValueUnsafe<timestamp_t>();
-		timestamp = Timestamp::FromEpochMs(timestamp.value);
-		auto date = Timestamp::GetDate(timestamp);
-		auto time = Timestamp::GetTime(timestamp);
-		auto year = Date::ExtractYear(date);
-		auto month = Date::ExtractMonth(date);
-		auto day = Date::ExtractDay(date);
-		auto hour = static_cast<int>((time.micros % Interval::MICROS_PER_DAY) / Interval::MICROS_PER_HOUR);
-		auto minute = static_cast<int>((time.micros % Interval::MICROS_PER_HOUR) / Interval::MICROS_PER_MINUTE);
-		auto second = static_cast<float>(static_cast<double>(time.micros % Interval::MICROS_PER_MINUTE) /
-		                                 static_cast<double>(Interval::MICROS_PER_SEC));
-		feature->SetField(field_idx, year, month, day, hour, minute, second, 0);
-	} break;
-	case LogicalTypeId::TIMESTAMP_SEC: {
-		auto timestamp = value.GetValueUnsafe<timestamp_t>();
-		timestamp = Timestamp::FromEpochSeconds(timestamp.value);
-		auto date = Timestamp::GetDate(timestamp);
-		auto time = Timestamp::GetTime(timestamp);
-		auto year = Date::ExtractYear(date);
-		auto month = Date::ExtractMonth(date);
-		auto day = Date::ExtractDay(date);
-		auto hour = static_cast<int>((time.micros % Interval::MICROS_PER_DAY) / Interval::MICROS_PER_HOUR);
-		auto minute = static_cast<int>((time.micros % Interval::MICROS_PER_HOUR) / Interval::MICROS_PER_MINUTE);
-		auto second = static_cast<float>(static_cast<double>(time.micros % Interval::MICROS_PER_MINUTE) /
-		                                 static_cast<double>(Interval::MICROS_PER_SEC));
-		feature->SetField(field_idx, year, month, day, hour, minute, second, 0);
-	} break;
-	case LogicalTypeId::TIMESTAMP_TZ: {
+	case LogicalTypeId::BLOB:
+		SetOgrFieldColumn<string_t>(features, field_idx, vec, count, [&](OGRFeature &feature, string_t value) {
+			feature.SetField(field_idx, (int)value.GetSize(), value.GetDataUnsafe());
+		});
+		break;
+	case LogicalTypeId::DATE:
+		SetOgrFieldColumn<date_t>(features, field_idx, vec, count, [&](OGRFeature &feature, date_t date) {
+			auto year = Date::ExtractYear(date);
+			auto month = Date::ExtractMonth(date);
+			auto day = Date::ExtractDay(date);
+			feature.SetField(field_idx, year, month, day, 0, 0, 0, 0);
+		});
+		break;
+	case LogicalTypeId::TIME:
+		SetOgrFieldColumn<dtime_t>(features, field_idx, vec, count, [&](OGRFeature &feature, dtime_t time) {
+			auto hour = static_cast<int>(time.micros / Interval::MICROS_PER_HOUR);
+			auto minute = static_cast<int>((time.micros % Interval::MICROS_PER_HOUR) / Interval::MICROS_PER_MINUTE);
+			auto second = static_cast<float>(static_cast<double>(time.micros % Interval::MICROS_PER_MINUTE) /
+			                                 static_cast<double>(Interval::MICROS_PER_SEC));
+			feature.SetField(field_idx, 0, 0, 0, hour, minute, second, 0);
+		});
+		break;
+	case LogicalTypeId::TIMESTAMP:
+		SetOgrFieldColumn<timestamp_t>(features, field_idx, vec, count,
+		                               [&](OGRFeature &feature, timestamp_t timestamp) {
+			                               SetOgrDateTimeField(feature, field_idx, timestamp);
+		                               });
+		break;
+	case LogicalTypeId::TIMESTAMP_NS:
+		SetOgrFieldColumn<timestamp_t>(features, field_idx, vec, count,
+		                               [&](OGRFeature &feature, timestamp_t timestamp) {
+			                               SetOgrDateTimeField(feature, field_idx,
+			                                                   Timestamp::FromEpochNanoSeconds(timestamp.value));
+		                               });
+		break;
+	case LogicalTypeId::TIMESTAMP_MS:
+		SetOgrFieldColumn<timestamp_t>(features, field_idx, vec, count,
+		                               [&](OGRFeature &feature, timestamp_t timestamp) {
+			                               SetOgrDateTimeField(feature, field_idx,
+			                                                   Timestamp::FromEpochMs(timestamp.value));
+		                               });
+		break;
+	case LogicalTypeId::TIMESTAMP_SEC:
+		SetOgrFieldColumn<timestamp_t>(features, field_idx, vec, count,
+		                               [&](OGRFeature &feature, timestamp_t timestamp) {
+			                               SetOgrDateTimeField(feature, field_idx,
+			                                                   Timestamp::FromEpochSeconds(timestamp.value));
+		                               });
+		break;
+	case LogicalTypeId::TIMESTAMP_TZ:
 		// Not sure what to with the timezone, just let GDAL parse it?
-		auto timestamp = value.GetValueUnsafe<timestamp_t>();
-		auto time_str = Timestamp::ToString(timestamp);
-		feature->SetField(field_idx, time_str.c_str());
-	} break;
+		SetOgrFieldColumn<timestamp_t>(features, field_idx, vec, count,
+		                               [&](OGRFeature &feature, timestamp_t timestamp) {
+			                               auto time_str = Timestamp::ToString(timestamp);
+			                               feature.SetField(field_idx, time_str.c_str());
+		                               });
+		break;
 	default:
 		// TODO: Handle list types
 		throw NotImplementedException("Unsupported field type");
 	}
 }
 
+static OGRGeometryUniquePtr OGRGeometryFromWKB(const_data_ptr_t wkb, idx_t size) {
+	OGRGeometry *ptr;
+	size_t consumed;
+	auto ok = OGRGeometryFactory::createFromWkb(wkb, nullptr, &ptr, size, wkbVariantIso, consumed);
+	if (ok != OGRERR_NONE) {
+		throw IOException("Could not parse WKB");
+	}
+	return OGRGeometryUniquePtr(ptr);
+}
+
+static void SetOgrGeometry(OGRFeature &feature, OGRGeometryUniquePtr geom, const BindData &bind_data) {
+	if (bind_data.geometry_type != wkbUnknown && geom->getGeometryType() != bind_data.geometry_type) {
+		auto got_name = StringUtil::Replace(StringUtil::Upper(OGRGeometryTypeToName(geom->getGeometryType())), " ", "");
+		auto expected_name =
+		    StringUtil::Replace(StringUtil::Upper(OGRGeometryTypeToName(bind_data.geometry_type)), " ", "");
+		throw InvalidInputException("Expected all geometries to be of type '%s', but got one of type '%s'",
+		                            expected_name, got_name);
+	}
+	// Hand the geometry over to the feature instead of copying it
+	if (feature.SetGeometryDirectly(geom.release()) != OGRERR_NONE) {
+		throw IOException("Could not set geometry");
+	}
+}
+
+static void SetOgrGeometryFromVector(vector<OGRFeatureUniquePtr> &features, const LogicalType &type, Vector &vec,
+                                     idx_t count, const BindData &bind_data, core::GeometryFactory &factory) {
+	if (type == core::GeoTypes::POINT_2D()) {
+		vec.Flatten(count);
+		auto &validity = FlatVector::Validity(vec);
+		auto &children = StructVector::GetEntries(vec);
+		auto x_data = FlatVector::GetData<double>(*children[0]);
+		auto y_data = FlatVector::GetData<double>(*children[1]);
+		for (idx_t row_idx = 0; row_idx < count; row_idx++) {
+			if (!validity.RowIsValid(row_idx)) {
+				continue;
+			}
+			auto ogr_point = new OGRPoint(x_data[row_idx], y_data[row_idx]);
+			SetOgrGeometry(*features[row_idx], OGRGeometryUniquePtr(ogr_point), bind_data);
+		}
+		return;
+	}
+
+	if (type != core::GeoTypes::WKB_BLOB() && type != core::GeoTypes::GEOMETRY()) {
+		throw NotImplementedException("Unsupported geometry type");
+	}
+	auto is_wkb = type == core::GeoTypes::WKB_BLOB();
+
+	UnifiedVectorFormat format;
+	vec.ToUnifiedFormat(count, format);
+	auto data = UnifiedVectorFormat::GetData<string_t>(format);
+	for (idx_t row_idx = 0; row_idx < count; row_idx++) {
+		auto idx = format.sel->get_index(row_idx);
+		if (!format.validity.RowIsValid(idx)) {
+			// Leave the geometry empty
+			continue;
+		}
+		auto &blob = data[idx];
+		if (is_wkb) {
+			auto geom = OGRGeometryFromWKB(const_data_ptr_cast(blob.GetDataUnsafe()), blob.GetSize());
+			SetOgrGeometry(*features[row_idx], std::move(geom), bind_data);
+		} else {
+			uint32_t size;
+			auto wkb = core::WKBWriter::Write(core::geometry_t(blob), &size, factory.allocator);
+			SetOgrGeometry(*features[row_idx], OGRGeometryFromWKB(wkb, size), bind_data);
+		}
+	}
+}
+
+// Build the features for a chunk. This only reads the layer definition, so it can run in parallel with other threads.
+static void BuildFeatures(const BindData &bind_data, OGRLayer &layer, DataChunk &input,
+                          vector<OGRFeatureUniquePtr> &features, core::GeometryFactory &factory) {
+	auto count = input.size();
+	features.clear();
+	for (idx_t row_idx = 0; row_idx < count; row_idx++) {
+		features.push_back(OGRFeatureUniquePtr(OGRFeature::CreateFeature(layer.GetLayerDefn())));
+	}
+
+	// Geometry fields do not count towards the field index, so we need to keep track of them separately.
+	int field_idx = 0;
+	for (idx_t col_idx = 0; col_idx < input.ColumnCount(); col_idx++) {
+		auto &type = bind_data.field_sql_types[col_idx];
+		if (IsGeometryType(type)) {
+			// TODO: check how many geometry fields there are and use the correct one.
+			SetOgrGeometryFromVector(features, type, input.data[col_idx], count, bind_data, factory);
+		} else {
+			SetOgrFieldFromVector(features, field_idx, type, input.data[col_idx], count);
+			field_idx++;
+		}
+	}
+}
+
+// Append the features to the layer, the caller has to hold the global lock
+static void AppendFeatures(const BindData &bind_data, GlobalState &global_state,
+                           vector<OGRFeatureUniquePtr> &features) {
+	for (auto &feature : features) {
+		if (global_state.layer->CreateFeature(feature.get()) != OGRERR_NONE) {
+			throw IOException("Could not create feature");
+		}
+	}
+
+	if (global_state.in_transaction) {
+		global_state.features_in_transaction += features.size();
+		if (global_state.features_in_transaction >= bind_data.transaction_size) {
+			if (global_state.dataset->CommitTransaction() != OGRERR_NONE) {
+				throw IOException("Could not commit transaction");
+			}
+			global_state.in_transaction = global_state.dataset->StartTransaction() == OGRERR_NONE;
+			global_state.features_in_transaction = 0;
+		}
+	}
+}
+
 static void Sink(ExecutionContext &context, FunctionData &bdata, GlobalFunctionData &gstate, LocalFunctionData &lstate,
                  DataChunk &input) {
 	auto &bind_data = bdata.Cast<BindData>();
@@ -495,45 +615,51 @@ static void Sink(ExecutionContext &context, FunctionData &bdata, GlobalFunctionD
 	auto &local_state = lstate.Cast<LocalState>();
 	local_state.factory.allocator.Reset();
 
+	auto &features = local_state.features;
+	BuildFeatures(bind_data, *global_state.layer, input, features, local_state.factory);
+
 	lock_guard<mutex> d_lock(global_state.lock);
-	auto layer = global_state.layer;
-
-	// Create the feature
-	input.Flatten();
-	for (idx_t row_idx = 0; row_idx < input.size(); row_idx++) {
-
-		auto feature = OGRFeatureUniquePtr(OGRFeature::CreateFeature(layer->GetLayerDefn()));
-
-		// Geometry fields do not count towards the field index, so we need to keep track of them separately.
-		idx_t field_idx = 0;
-		for (idx_t col_idx = 0; col_idx < input.ColumnCount(); col_idx++) {
-			auto &type = bind_data.field_sql_types[col_idx];
-			auto value = input.GetValue(col_idx, row_idx);
-
-			if (IsGeometryType(type)) {
-				// TODO: check how many geometry fields there are and use the correct one.
-				auto geom = OGRGeometryFromValue(type, value, local_state.factory);
-				if (bind_data.geometry_type != wkbUnknown && geom->getGeometryType() != bind_data.geometry_type) {
-					auto got_name =
-					    StringUtil::Replace(StringUtil::Upper(OGRGeometryTypeToName(geom->getGeometryType())), " ", "");
-					auto expected_name =
-					    StringUtil::Replace(StringUtil::Upper(OGRGeometryTypeToName(bind_data.geometry_type)), " ", "");
-					throw InvalidInputException("Expected all geometries to be of type '%s', but got one of type '%s'",
-					                            expected_name, got_name);
-				}
+	AppendFeatures(bind_data, global_state, features);
+}
 
-				if (feature->SetGeometry(geom.get()) != OGRERR_NONE) {
-					throw IOException("Could not set geometry");
-				}
-			} else {
-				SetOgrFieldFromValue(feature.get(), (int)field_idx, type, value);
-				field_idx++;
-			}
-		}
-		if (layer->CreateFeature(feature.get()) != OGRERR_NONE) {
-			throw IOException("Could not create feature");
+//===--------------------------------------------------------------------===//
+// Batch Copy
+//===--------------------------------------------------------------------===//
+// With insertion order preserved, DuckDB hands us the input in batches. Every thread builds the features of its
+// batch and DuckDB flushes the batches in order, so only appending them to the layer is serialized.
+struct GdalPreparedBatch : public PreparedBatchData {
+	vector<OGRFeatureUniquePtr> features;
+};
+
+static unique_ptr<PreparedBatchData> PrepareBatch(ClientContext &context, FunctionData &bdata,
+                                                  GlobalFunctionData &gstate,
+                                                  unique_ptr<ColumnDataCollection> collection) {
+	auto &bind_data = bdata.Cast<BindData>();
+	auto &global_state = gstate.Cast<GlobalState>();
+
+	auto result = make_uniq<GdalPreparedBatch>();
+	result->features.reserve(collection->Count());
+	core::GeometryFactory factory(BufferAllocator::Get(context));
+	vector<OGRFeatureUniquePtr> features;
+	for (auto &chunk : collection->Chunks()) {
+		factory.allocator.Reset();
+		BuildFeatures(bind_data, *global_state.layer, chunk, features, factory);
+		for (auto &feature : features) {
+			result->features.push_back(std::move(feature));
 		}
 	}
+	return std::move(result);
+}
+
+static void FlushBatch(ClientContext &context, FunctionData &bdata, GlobalFunctionData &gstate,
+                       PreparedBatchData &batch_p) {
+	auto &bind_data = bdata.Cast<BindData>();
+	auto &global_state = gstate.Cast<GlobalState>();
+	auto &batch = batch_p.Cast<GdalPreparedBatch>();
+
+	lock_guard<mutex> d_lock(global_state.lock);
+	AppendFeatures(bind_data, global_state, batch.features);
+	batch.features.clear();
 }
 
 //===--------------------------------------------------------------------===//
@@ -547,12 +673,59 @@ static void Combine(ExecutionContext &context, FunctionData &bind_data, GlobalFu
 //===--------------------------------------------------------------------===//
 // Finalize
 //===--------------------------------------------------------------------===//
-static void Finalize(ClientContext &context, FunctionData &bind_data, GlobalFunctionData &gstate) {
+static void Finalize(ClientContext &context, FunctionData &bdata, GlobalFunctionData &gstate) {
+	auto &bind_data = bdata.Cast<BindData>();
 	auto &global_state = (GlobalState &)gstate;
+
+	if (global_state.in_transaction) {
+		if (global_state.dataset->CommitTransaction() != OGRERR_NONE) {
+			throw IOException("Could not commit transaction");
+		}
+		global_state.in_transaction = false;
+	}
+
+	if (bind_data.deferred_spatial_index) {
+		auto geom_column = global_state.layer->GetGeometryColumn();
+		if (geom_column && geom_column[0] != '\0') {
+			auto sql = StringUtil::Format("SELECT CreateSpatialIndex(%s, %s)",
+			                              KeywordHelper::WriteQuoted(global_state.layer->GetName(), '\''),
+			                              KeywordHelper::WriteQuoted(geom_column, '\''));
+			CPLErrorReset();
+			auto result = global_state.dataset->ExecuteSQL(sql.c_str(), nullptr, nullptr);
+			// CreateSpatialIndex returns 1 if it created the index
+			auto created = false;
+			if (result) {
+				auto feature = OGRFeatureUniquePtr(result->GetNextFeature());
+				created = feature && feature->IsFieldSetAndNotNull(0) && feature->GetFieldAsInteger(0) == 1;
+				feature.reset();
+				global_state.dataset->ReleaseResultSet(result);
+			}
+			if (!created) {
+				throw IOException("Could not create spatial index on layer '%s': %s", global_state.layer->GetName(),
+				                  CPLGetLastErrorMsg());
+			}
+		}
+	}
+
 	global_state.dataset->FlushCache();
 	global_state.dataset->Close();
 }
 
+//===--------------------------------------------------------------------===//
+// Execution Mode
+//===--------------------------------------------------------------------===//
+static CopyFunctionExecutionMode ExecutionMode(bool preserve_insertion_order, bool supports_batch_index) {
+	// Features are built by every thread and appended under the lock. If the order of the features matters, the
+	// batches are appended in order instead, which needs the input to have batch indexes
+	if (!preserve_insertion_order) {
+		return CopyFunctionExecutionMode::PARALLEL_COPY_TO_FILE;
+	}
+	if (supports_batch_index) {
+		return CopyFunctionExecutionMode::BATCH_COPY_TO_FILE;
+	}
+	return CopyFunctionExecutionMode::REGULAR_COPY_TO_FILE;
+}
+
 void GdalCopyFunction::Register(DatabaseInstance &db) {
 	// register the copy function
 	CopyFunction info("GDAL");
@@ -562,6 +735,9 @@ void GdalCopyFunction::Register(DatabaseInstance &db) {
 	info.copy_to_sink = Sink;
 	info.copy_to_combine = Combine;
 	info.copy_to_finalize = Finalize;
+	info.execution_mode = ExecutionMode;
+	info.prepare_batch = PrepareBatch;
+	info.flush_batch = FlushBatch;
 	info.extension = "gdal";
 
 	ExtensionUtil::RegisterFunction(db, info);
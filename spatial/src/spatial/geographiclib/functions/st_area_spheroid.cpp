@@ -1,10 +1,12 @@
 #include "duckdb/common/vector_operations/generic_executor.hpp"
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/execution/expression_executor.hpp"
 
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
 #include "spatial/core/geometry/geometry.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
 #include "spatial/core/functions/common.hpp"
 
 #include "spatial/geographiclib/functions.hpp"
@@ -81,72 +83,84 @@ static void GeodesicPolygon2DFunction(DataChunk &args, ExpressionState &state, V
 //------------------------------------------------------------------------------
 // GEOMETRY
 //------------------------------------------------------------------------------
-static double PolygonArea(const Polygon &poly, GeographicLib::PolygonArea &comp) {
-	double total_area = 0;
-	for (uint32_t ring_idx = 0; ring_idx < poly.RingCount(); ring_idx++) {
+// Streams the vertices of the rings straight from the serialized geometry into the GeographicLib accumulator
+class GeodesicAreaProcessor final : GeometryProcessor<double> {
+	GeographicLib::PolygonArea comp;
+
+	double RingArea(const VertexData &vertices) {
 		comp.Clear();
-		auto &ring = poly[ring_idx];
 		// Note: the last point is the same as the first point, but geographiclib doesn't know that,
-		for (uint32_t coord_idx = 0; coord_idx < ring.Count() - 1; coord_idx++) {
-			auto coord = ring.Get(coord_idx);
-			comp.AddPoint(coord.x, coord.y);
+		// so skip it.
+		for (uint32_t i = 0; i + 1 < vertices.count; i++) {
+			comp.AddPoint(Load<double>(vertices.data[0] + i * vertices.stride[0]),
+			              Load<double>(vertices.data[1] + i * vertices.stride[1]));
 		}
 		double ring_area;
 		double _perimeter;
-		// We use the absolute value here so that the actual winding order of the polygon rings dont matter.
 		comp.Compute(false, true, _perimeter, ring_area);
-		if (ring_idx == 0) {
-			// Add outer ring
-			total_area += std::abs(ring_area);
-		} else {
-			// Subtract holes
-			total_area -= std::abs(ring_area);
-		}
+		// We use the absolute value here so that the actual winding order of the polygon rings dont matter.
+		return std::abs(ring_area);
 	}
-	return std::abs(total_area);
-}
 
-static double GeometryArea(const Geometry &geom, GeographicLib::PolygonArea &comp) {
-	switch (geom.Type()) {
-	case GeometryType::POLYGON: {
-		auto &poly = geom.As<Polygon>();
-		return PolygonArea(poly, comp);
+	double ProcessPoint(const VertexData &vertices) override {
+		return 0.0;
 	}
-	case GeometryType::MULTIPOLYGON: {
-		auto &mpoly = geom.As<MultiPolygon>();
+
+	double ProcessLineString(const VertexData &vertices) override {
+		return 0.0;
+	}
+
+	double ProcessPolygon(PolygonState &state) override {
 		double total_area = 0;
-		for (auto &poly : mpoly) {
-			total_area += PolygonArea(poly, comp);
+		if (!state.IsDone()) {
+			// Add outer ring
+			total_area += RingArea(state.Next());
 		}
-		return total_area;
+		while (!state.IsDone()) {
+			// Subtract holes
+			total_area -= RingArea(state.Next());
+		}
+		return std::abs(total_area);
 	}
-	case GeometryType::GEOMETRYCOLLECTION: {
-		auto &coll = geom.As<GeometryCollection>();
+
+	double ProcessCollection(CollectionState &state) override {
 		double total_area = 0;
-		for (auto &item : coll) {
-			total_area += GeometryArea(item, comp);
+		while (!state.IsDone()) {
+			total_area += state.Next();
 		}
 		return total_area;
 	}
-	default: {
-		return 0.0;
+
+public:
+	explicit GeodesicAreaProcessor(const GeographicLib::Geodesic &geod) : comp(geod, false) {
 	}
+
+	double Execute(const geometry_t &geometry) {
+		return Process(geometry);
 	}
-}
+};
+
+struct GeodesicAreaLocalState : public FunctionLocalState {
+	// Reused for all rows this thread processes
+	GeodesicAreaProcessor processor;
+
+	GeodesicAreaLocalState() : processor(GeographicLib::Geodesic::WGS84()) {
+	}
+
+	static unique_ptr<FunctionLocalState> Init(ExpressionState &state, const BoundFunctionExpression &expr,
+	                                           FunctionData *bind_data) {
+		return make_uniq<GeodesicAreaLocalState>();
+	}
+};
 
 static void GeodesicGeometryFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	auto &lstate = ExecuteFunctionState::GetFunctionState(state)->Cast<GeodesicAreaLocalState>();
 
 	auto &input = args.data[0];
 	auto count = args.size();
 
-	const GeographicLib::Geodesic &geod = GeographicLib::Geodesic::WGS84();
-	auto comp = GeographicLib::PolygonArea(geod, false);
-
-	UnaryExecutor::Execute<geometry_t, double>(input, result, count, [&](geometry_t input) {
-		auto geometry = lstate.factory.Deserialize(input);
-		return GeometryArea(geometry, comp);
-	});
+	UnaryExecutor::Execute<geometry_t, double>(input, result, count,
+	                                           [&](geometry_t input) { return lstate.processor.Execute(input); });
 
 	if (count == 1) {
 		result.SetVectorType(VectorType::CONSTANT_VECTOR);
@@ -159,7 +173,7 @@ void GeographicLibFunctions::RegisterArea(DatabaseInstance &db) {
 	ScalarFunctionSet set("ST_Area_Spheroid");
 	set.AddFunction(ScalarFunction({GeoTypes::POLYGON_2D()}, LogicalType::DOUBLE, GeodesicPolygon2DFunction));
 	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::DOUBLE, GeodesicGeometryFunction, nullptr,
-	                               nullptr, nullptr, GeometryFunctionLocalState::Init));
+	                               nullptr, nullptr, GeodesicAreaLocalState::Init));
 
 	ExtensionUtil::RegisterFunction(db, set);
 }
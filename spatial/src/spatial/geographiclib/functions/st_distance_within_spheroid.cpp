@@ -4,48 +4,235 @@
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
 #include "spatial/geographiclib/functions.hpp"
 #include "spatial/geographiclib/module.hpp"
 
 #include "GeographicLib/Geodesic.hpp"
 
+#include <cmath>
+
 namespace spatial {
 
 namespace geographiclib {
 
+using namespace core;
+
+//------------------------------------------------------------------------------
+// Kernel
+//------------------------------------------------------------------------------
+// Every radius of curvature of the WGS84 ellipsoid lies between the meridional radius at the equator, a(1 - e^2),
+// and the radius at the poles, a / sqrt(1 - e^2). So the geodesic between two points is at least as long as the
+// great circle between them on a sphere with the smaller radius, and at most as long as the great circle on a sphere
+// with the larger one. Most pairs are far enough from the limit that these bounds settle it, so we only solve the
+// (iterative) inverse geodesic problem for the pairs in between.
+
+static constexpr double DEG_TO_RAD = 0.017453292519943296;
+// Keep some distance from the bounds, so that rounding errors dont change the result
+static constexpr double BOUNDS_TOLERANCE = 1e-9;
+
+// The points are in latitude, longitude order
+static void DistanceWithin(const double *lat1, const double *lon1, const double *lat2, const double *lon2,
+                           const double *limit, const ValidityMask &validity, idx_t count, bool *result) {
+	const GeographicLib::Geodesic &geod = GeographicLib::Geodesic::WGS84();
+	auto a = geod.EquatorialRadius();
+	auto f = geod.Flattening();
+	auto e2 = f * (2 - f);
+	auto min_radius = a * (1 - e2) * (1 - BOUNDS_TOLERANCE);
+	auto max_radius = a / std::sqrt(1 - e2) * (1 + BOUNDS_TOLERANCE);
+
+	// First pass: settle what we can with the bounds, and collect the rest
+	SelectionVector uncertain(count);
+	idx_t uncertain_count = 0;
+	for (idx_t i = 0; i < count; i++) {
+		if (!validity.RowIsValid(i)) {
+			continue;
+		}
+		// The geodesic is at least as long as the difference in latitude
+		auto dlat = (lat2[i] - lat1[i]) * DEG_TO_RAD;
+		if (std::fabs(dlat) * min_radius > limit[i]) {
+			result[i] = false;
+			continue;
+		}
+
+		// Haversine
+		auto dlon = (lon2[i] - lon1[i]) * DEG_TO_RAD;
+		auto sin_dlat = std::sin(dlat * 0.5);
+		auto sin_dlon = std::sin(dlon * 0.5);
+		auto h = sin_dlat * sin_dlat +
+		         std::cos(lat1[i] * DEG_TO_RAD) * std::cos(lat2[i] * DEG_TO_RAD) * sin_dlon * sin_dlon;
+		auto angle = 2 * std::asin(std::sqrt(std::min(h, 1.0)));
+
+		if (angle * min_radius > limit[i]) {
+			result[i] = false;
+		} else if (angle * max_radius <= limit[i] && std::fabs(lat1[i]) <= 90 && std::fabs(lat2[i]) <= 90) {
+			result[i] = true;
+		} else {
+			// Too close to call (or invalid input), solve it exactly
+			uncertain.set_index(uncertain_count++, i);
+		}
+	}
+
+	// Second pass: solve the inverse geodesic problem for the pairs we could not settle
+	for (idx_t j = 0; j < uncertain_count; j++) {
+		auto i = uncertain.get_index(j);
+		double distance;
+		geod.Inverse(lat1[i], lon1[i], lat2[i], lon2[i], distance);
+		result[i] = distance <= limit[i];
+	}
+}
+
 //------------------------------------------------------------------------------
 // POINT_2D
 //------------------------------------------------------------------------------
 static void GeodesicPoint2DFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	using POINT_TYPE = StructTypeBinary<double, double>;
-	using DISTANCE_TYPE = PrimitiveType<double>;
-	using BOOL_TYPE = PrimitiveType<bool>;
 	auto count = args.size();
 	auto &p1_vec = args.data[0];
 	auto &p2_vec = args.data[1];
 	auto &limit_vec = args.data[2];
 
-	const GeographicLib::Geodesic &geod = GeographicLib::Geodesic::WGS84();
+	auto is_constant = p1_vec.GetVectorType() == VectorType::CONSTANT_VECTOR &&
+	                   p2_vec.GetVectorType() == VectorType::CONSTANT_VECTOR &&
+	                   limit_vec.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	if (is_constant) {
+		count = 1;
+	}
+
+	p1_vec.Flatten(count);
+	p2_vec.Flatten(count);
+	limit_vec.Flatten(count);
+
+	auto &result_validity = FlatVector::Validity(result);
+	result_validity.Reset();
+	result_validity.Combine(FlatVector::Validity(p1_vec), count);
+	result_validity.Combine(FlatVector::Validity(p2_vec), count);
+	result_validity.Combine(FlatVector::Validity(limit_vec), count);
+
+	auto &p1_children = StructVector::GetEntries(p1_vec);
+	auto &p2_children = StructVector::GetEntries(p2_vec);
+	DistanceWithin(FlatVector::GetData<double>(*p1_children[0]), FlatVector::GetData<double>(*p1_children[1]),
+	               FlatVector::GetData<double>(*p2_children[0]), FlatVector::GetData<double>(*p2_children[1]),
+	               FlatVector::GetData<double>(limit_vec), result_validity, count, FlatVector::GetData<bool>(result));
+
+	if (is_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+// Reads the coordinates of a point straight from the serialized geometry
+class PointReader final : GeometryProcessor<bool> {
+	double x = 0;
+	double y = 0;
+
+	bool ProcessPoint(const VertexData &vertices) override {
+		if (vertices.IsEmpty()) {
+			return false;
+		}
+		x = Load<double>(vertices.data[0]);
+		y = Load<double>(vertices.data[1]);
+		return true;
+	}
+
+	bool ProcessLineString(const VertexData &vertices) override {
+		throw InvalidInputException("ST_DWithin_Spheroid only supports POINT geometries");
+	}
+
+	bool ProcessPolygon(PolygonState &state) override {
+		throw InvalidInputException("ST_DWithin_Spheroid only supports POINT geometries");
+	}
+
+	bool ProcessCollection(CollectionState &state) override {
+		throw InvalidInputException("ST_DWithin_Spheroid only supports POINT geometries");
+	}
+
+public:
+	// Returns false if the point is empty
+	bool Read(const geometry_t &geom, double &x_p, double &y_p) {
+		if (geom.GetType() != GeometryType::POINT) {
+			throw InvalidInputException("ST_DWithin_Spheroid only supports POINT geometries");
+		}
+		if (!Process(geom)) {
+			return false;
+		}
+		x_p = x;
+		y_p = y;
+		return true;
+	}
+};
+
+static void GeodesicGeometryFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto count = args.size();
+	auto &p1_vec = args.data[0];
+	auto &p2_vec = args.data[1];
+	auto &limit_vec = args.data[2];
+
+	auto is_constant = p1_vec.GetVectorType() == VectorType::CONSTANT_VECTOR &&
+	                   p2_vec.GetVectorType() == VectorType::CONSTANT_VECTOR &&
+	                   limit_vec.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	if (is_constant) {
+		count = 1;
+	}
+
+	UnifiedVectorFormat p1_format;
+	UnifiedVectorFormat p2_format;
+	UnifiedVectorFormat limit_format;
+	p1_vec.ToUnifiedFormat(count, p1_format);
+	p2_vec.ToUnifiedFormat(count, p2_format);
+	limit_vec.ToUnifiedFormat(count, limit_format);
+	auto p1_data = UnifiedVectorFormat::GetData<geometry_t>(p1_format);
+	auto p2_data = UnifiedVectorFormat::GetData<geometry_t>(p2_format);
+	auto limit_data = UnifiedVectorFormat::GetData<double>(limit_format);
+
+	// Gather the coordinates into columns, so that we can run the same kernel as for POINT_2D
+	auto buffer = make_unsafe_uniq_array<double>(count * 5);
+	auto lat1 = buffer.get();
+	auto lon1 = lat1 + count;
+	auto lat2 = lon1 + count;
+	auto lon2 = lat2 + count;
+	auto limit = lon2 + count;
+
+	auto &result_validity = FlatVector::Validity(result);
+	result_validity.Reset();
+
+	PointReader reader;
+	for (idx_t i = 0; i < count; i++) {
+		auto p1_idx = p1_format.sel->get_index(i);
+		auto p2_idx = p2_format.sel->get_index(i);
+		auto limit_idx = limit_format.sel->get_index(i);
+		if (!p1_format.validity.RowIsValid(p1_idx) || !p2_format.validity.RowIsValid(p2_idx) ||
+		    !limit_format.validity.RowIsValid(limit_idx)) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		limit[i] = limit_data[limit_idx];
+		if (!reader.Read(p1_data[p1_idx], lat1[i], lon1[i]) || !reader.Read(p2_data[p2_idx], lat2[i], lon2[i])) {
+			// Empty points are not within any distance of anything, this ends up as false in the kernel
+			lat1[i] = lon1[i] = lat2[i] = lon2[i] = NAN;
+		}
+	}
+
+	DistanceWithin(lat1, lon1, lat2, lon2, limit, result_validity, count, FlatVector::GetData<bool>(result));
 
-	GenericExecutor::ExecuteTernary<POINT_TYPE, POINT_TYPE, DISTANCE_TYPE, BOOL_TYPE>(
-	    p1_vec, p2_vec, limit_vec, result, count, [&](POINT_TYPE p1, POINT_TYPE p2, DISTANCE_TYPE limit) {
-		    double distance;
-		    geod.Inverse(p1.a_val, p1.b_val, p2.a_val, p2.b_val, distance);
-		    return distance <= limit.val;
-	    });
+	if (is_constant) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
 }
 
 void GeographicLibFunctions::RegisterDistanceWithin(DatabaseInstance &db) {
 
 	// Distance
 	ScalarFunctionSet set("ST_DWithin_Spheroid");
-	set.AddFunction(
-	    ScalarFunction({spatial::core::GeoTypes::POINT_2D(), spatial::core::GeoTypes::POINT_2D(), LogicalType::DOUBLE},
-	                   LogicalType::DOUBLE, GeodesicPoint2DFunction));
+	set.AddFunction(ScalarFunction({GeoTypes::POINT_2D(), GeoTypes::POINT_2D(), LogicalType::DOUBLE},
+	                               LogicalType::BOOLEAN, GeodesicPoint2DFunction));
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), GeoTypes::GEOMETRY(), LogicalType::DOUBLE},
+	                               LogicalType::BOOLEAN, GeodesicGeometryFunction));
 
 	ExtensionUtil::RegisterFunction(db, set);
 }
 
 } // namespace geographiclib
 
-} // namespace spatial
\ No newline at end of file
+} // namespace spatial
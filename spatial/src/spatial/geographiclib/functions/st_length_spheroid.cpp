@@ -1,10 +1,12 @@
 #include "duckdb/common/vector_operations/generic_executor.hpp"
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/execution/expression_executor.hpp"
 
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
 #include "spatial/core/geometry/geometry.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/geographiclib/functions.hpp"
 #include "spatial/geographiclib/module.hpp"
@@ -59,58 +61,66 @@ static void GeodesicLineString2DFunction(DataChunk &args, ExpressionState &state
 //------------------------------------------------------------------------------
 // GEOMETRY
 //------------------------------------------------------------------------------
-static double LineLength(const LineString &line, GeographicLib::PolygonArea &comp) {
-	comp.Clear();
-	for (uint32_t i = 0; i < line.Vertices().Count(); i++) {
-		auto vert = line.Vertices().Get(i);
-		comp.AddPoint(vert.x, vert.y);
-	}
-	double _area;
-	double linestring_length;
-	comp.Compute(false, true, linestring_length, _area);
-	return linestring_length;
-}
+class GeodesicLengthProcessor final : GeometryProcessor<double> {
+	GeographicLib::PolygonArea comp;
 
-static double GeometryLength(const Geometry &geom, GeographicLib::PolygonArea &comp) {
-	switch (geom.Type()) {
-	case GeometryType::LINESTRING: {
-		return LineLength(geom.As<LineString>(), comp);
+	double ProcessPoint(const VertexData &vertices) override {
+		return 0.0;
 	}
-	case GeometryType::MULTILINESTRING: {
-		auto &mline = geom.As<MultiLineString>();
-		double mline_length = 0;
-		for (auto &line : mline) {
-			mline_length += LineLength(line, comp);
+
+	double ProcessLineString(const VertexData &vertices) override {
+		comp.Clear();
+		for (uint32_t i = 0; i < vertices.count; i++) {
+			comp.AddPoint(Load<double>(vertices.data[0] + i * vertices.stride[0]),
+			              Load<double>(vertices.data[1] + i * vertices.stride[1]));
 		}
-		return mline_length;
+		double _area;
+		double linestring_length;
+		comp.Compute(false, true, linestring_length, _area);
+		return linestring_length;
+	}
+
+	double ProcessPolygon(PolygonState &state) override {
+		return 0.0;
 	}
-	case GeometryType::GEOMETRYCOLLECTION: {
-		auto &coll = geom.As<GeometryCollection>();
-		auto sum = 0;
-		for (auto &item : coll) {
-			sum += GeometryLength(item, comp);
+
+	double ProcessCollection(CollectionState &state) override {
+		double total_length = 0;
+		while (!state.IsDone()) {
+			total_length += state.Next();
 		}
-		return sum;
+		return total_length;
 	}
-	default: {
-		return 0.0;
+
+public:
+	explicit GeodesicLengthProcessor(const GeographicLib::Geodesic &geod) : comp(geod, true) {
 	}
+
+	double Execute(const geometry_t &geometry) {
+		return Process(geometry);
+	}
+};
+
+struct GeodesicLengthLocalState : public FunctionLocalState {
+	GeodesicLengthProcessor processor;
+
+	GeodesicLengthLocalState() : processor(GeographicLib::Geodesic::WGS84()) {
 	}
-}
+
+	static unique_ptr<FunctionLocalState> Init(ExpressionState &state, const BoundFunctionExpression &expr,
+	                                           FunctionData *bind_data) {
+		return make_uniq<GeodesicLengthLocalState>();
+	}
+};
 
 static void GeodesicGeometryFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	auto &lstate = ExecuteFunctionState::GetFunctionState(state)->Cast<GeodesicLengthLocalState>();
 
 	auto &input = args.data[0];
 	auto count = args.size();
 
-	const GeographicLib::Geodesic &geod = GeographicLib::Geodesic::WGS84();
-	auto comp = GeographicLib::PolygonArea(geod, true);
-
-	UnaryExecutor::Execute<geometry_t, double>(input, result, count, [&](geometry_t input) {
-		auto geometry = lstate.factory.Deserialize(input);
-		return GeometryLength(geometry, comp);
-	});
+	UnaryExecutor::Execute<geometry_t, double>(input, result, count,
+	                                           [&](geometry_t input) { return lstate.processor.Execute(input); });
 
 	if (count == 1) {
 		result.SetVectorType(VectorType::CONSTANT_VECTOR);
@@ -123,7 +133,7 @@ void GeographicLibFunctions::RegisterLength(DatabaseInstance &db) {
 	ScalarFunctionSet set("ST_Length_Spheroid");
 	set.AddFunction(ScalarFunction({GeoTypes::LINESTRING_2D()}, LogicalType::DOUBLE, GeodesicLineString2DFunction));
 	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::DOUBLE, GeodesicGeometryFunction, nullptr,
-	                               nullptr, nullptr, GeometryFunctionLocalState::Init));
+	                               nullptr, nullptr, GeodesicLengthLocalState::Init));
 
 	ExtensionUtil::RegisterFunction(db, set);
 }
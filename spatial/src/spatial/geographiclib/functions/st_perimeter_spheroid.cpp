@@ -1,10 +1,12 @@
 #include "duckdb/common/vector_operations/generic_executor.hpp"
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/execution/expression_executor.hpp"
 
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
 #include "spatial/core/geometry/geometry.hpp"
 #include "spatial/core/geometry/geometry_factory.hpp"
+#include "spatial/core/geometry/geometry_processor.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/geographiclib/functions.hpp"
 #include "spatial/geographiclib/module.hpp"
@@ -71,66 +73,76 @@ static void GeodesicPolygon2DFunction(DataChunk &args, ExpressionState &state, V
 //------------------------------------------------------------------------------
 // GEOMETRY
 //------------------------------------------------------------------------------
-static double PolygonPerimeter(const Polygon &poly, GeographicLib::PolygonArea &comp) {
+class GeodesicPerimeterProcessor final : GeometryProcessor<double> {
+	GeographicLib::PolygonArea comp;
 
-	double total_perimeter = 0;
-	for (auto &ring : poly) {
+	double RingPerimeter(const VertexData &vertices) {
 		comp.Clear();
 		// Note: the last point is the same as the first point, but geographiclib doesn't know that,
 		// so skip it.
-		for (uint32_t coord_idx = 0; coord_idx < ring.Count() - 1; coord_idx++) {
-			auto coord = ring.Get(coord_idx);
-			comp.AddPoint(coord.x, coord.y);
+		for (uint32_t i = 0; i + 1 < vertices.count; i++) {
+			comp.AddPoint(Load<double>(vertices.data[0] + i * vertices.stride[0]),
+			              Load<double>(vertices.data[1] + i * vertices.stride[1]));
 		}
 		double _ring_area;
 		double perimeter;
 		comp.Compute(false, true, perimeter, _ring_area);
-		total_perimeter += perimeter;
+		return perimeter;
+	}
+
+	double ProcessPoint(const VertexData &vertices) override {
+		return 0.0;
 	}
-	return total_perimeter;
-}
 
-static double GeometryPerimeter(const Geometry &geom, GeographicLib::PolygonArea &comp) {
-	switch (geom.Type()) {
-	case GeometryType::POLYGON: {
-		auto &poly = geom.As<Polygon>();
-		return PolygonPerimeter(poly, comp);
+	double ProcessLineString(const VertexData &vertices) override {
+		return 0.0;
 	}
-	case GeometryType::MULTIPOLYGON: {
-		auto &mpoly = geom.As<MultiPolygon>();
+
+	double ProcessPolygon(PolygonState &state) override {
 		double total_perimeter = 0;
-		for (auto &poly : mpoly) {
-			total_perimeter += PolygonPerimeter(poly, comp);
+		while (!state.IsDone()) {
+			total_perimeter += RingPerimeter(state.Next());
 		}
 		return total_perimeter;
 	}
-	case GeometryType::GEOMETRYCOLLECTION: {
-		auto &coll = geom.As<GeometryCollection>();
+
+	double ProcessCollection(CollectionState &state) override {
 		double total_perimeter = 0;
-		for (auto &item : coll) {
-			total_perimeter += GeometryPerimeter(item, comp);
+		while (!state.IsDone()) {
+			total_perimeter += state.Next();
 		}
 		return total_perimeter;
 	}
-	default: {
-		return 0.0;
+
+public:
+	explicit GeodesicPerimeterProcessor(const GeographicLib::Geodesic &geod) : comp(geod, false) {
 	}
+
+	double Execute(const geometry_t &geometry) {
+		return Process(geometry);
+	}
+};
+
+struct GeodesicPerimeterLocalState : public FunctionLocalState {
+	GeodesicPerimeterProcessor processor;
+
+	GeodesicPerimeterLocalState() : processor(GeographicLib::Geodesic::WGS84()) {
 	}
-}
+
+	static unique_ptr<FunctionLocalState> Init(ExpressionState &state, const BoundFunctionExpression &expr,
+	                                           FunctionData *bind_data) {
+		return make_uniq<GeodesicPerimeterLocalState>();
+	}
+};
 
 static void GeodesicGeometryFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	auto &lstate = ExecuteFunctionState::GetFunctionState(state)->Cast<GeodesicPerimeterLocalState>();
 
 	auto &input = args.data[0];
 	auto count = args.size();
 
-	const GeographicLib::Geodesic &geod = GeographicLib::Geodesic::WGS84();
-	auto comp = GeographicLib::PolygonArea(geod, false);
-
-	UnaryExecutor::Execute<geometry_t, double>(input, result, count, [&](geometry_t input) {
-		auto geometry = lstate.factory.Deserialize(input);
-		return GeometryPerimeter(geometry, comp);
-	});
+	UnaryExecutor::Execute<geometry_t, double>(input, result, count,
+	                                           [&](geometry_t input) { return lstate.processor.Execute(input); });
 
 	if (count == 1) {
 		result.SetVectorType(VectorType::CONSTANT_VECTOR);
@@ -143,7 +155,7 @@ void GeographicLibFunctions::RegisterPerimeter(DatabaseInstance &db) {
 	ScalarFunctionSet set("ST_Perimeter_Spheroid");
 	set.AddFunction(ScalarFunction({GeoTypes::POLYGON_2D()}, LogicalType::DOUBLE, GeodesicPolygon2DFunction));
 	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::DOUBLE, GeodesicGeometryFunction, nullptr,
-	                               nullptr, nullptr, GeometryFunctionLocalState::Init));
+	                               nullptr, nullptr, GeodesicPerimeterLocalState::Init));
 	ExtensionUtil::RegisterFunction(db, set);
 }
 
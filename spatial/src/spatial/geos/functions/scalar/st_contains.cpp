@@ -20,6 +20,9 @@ static void ContainsFunction(DataChunk &args, ExpressionState &state, Vector &re
 	auto &left = args.data[0];
 	auto &right = args.data[1];
 	auto count = args.size();
+	if (GEOSExecutor::TryExecutePointInPolygon(lstate, left, right, count, result, false)) {
+		return;
+	}
 	GEOSExecutor::ExecuteNonSymmetricPreparedBinary(lstate, left, right, count, result, GEOSContains_r,
 	                                                GEOSPreparedContains_r);
 }
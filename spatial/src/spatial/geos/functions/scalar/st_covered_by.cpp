@@ -20,6 +20,9 @@ static void CoveredByFunction(DataChunk &args, ExpressionState &state, Vector &r
 	auto &left = args.data[0];
 	auto &right = args.data[1];
 	auto count = args.size();
+	if (GEOSExecutor::TryExecutePointInPolygon(lstate, right, left, count, result, true)) {
+		return;
+	}
 	GEOSExecutor::ExecuteNonSymmetricPreparedBinary(lstate, left, right, count, result, GEOSCoveredBy_r,
 	                                                GEOSPreparedCoveredBy_r);
 }
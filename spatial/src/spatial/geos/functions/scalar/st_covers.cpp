@@ -20,6 +20,9 @@ static void CoversFunction(DataChunk &args, ExpressionState &state, Vector &resu
 	auto &left = args.data[0];
 	auto &right = args.data[1];
 	auto count = args.size();
+	if (GEOSExecutor::TryExecutePointInPolygon(lstate, left, right, count, result, true)) {
+		return;
+	}
 	GEOSExecutor::ExecuteNonSymmetricPreparedBinary(lstate, left, right, count, result, GEOSCovers_r,
 	                                                GEOSPreparedCovers_r);
 }
@@ -20,6 +20,10 @@ static void IntersectsFunction(DataChunk &args, ExpressionState &state, Vector &
 	auto &left = args.data[0];
 	auto &right = args.data[1];
 	auto count = args.size();
+	if (GEOSExecutor::TryExecutePointInPolygon(lstate, left, right, count, result, true) ||
+	    GEOSExecutor::TryExecutePointInPolygon(lstate, right, left, count, result, true)) {
+		return;
+	}
 	GEOSExecutor::ExecuteSymmetricPreparedBinary(lstate, left, right, count, result, GEOSIntersects_r,
 	                                             GEOSPreparedIntersects_r);
 }
@@ -20,6 +20,9 @@ static void WithinFunction(DataChunk &args, ExpressionState &state, Vector &resu
 	auto &left = args.data[0];
 	auto &right = args.data[1];
 	auto count = args.size();
+	if (GEOSExecutor::TryExecutePointInPolygon(lstate, right, left, count, result, false)) {
+		return;
+	}
 	GEOSExecutor::ExecuteNonSymmetricPreparedBinary(lstate, left, right, count, result, GEOSWithin_r,
 	                                                GEOSPreparedWithin_r);
 }
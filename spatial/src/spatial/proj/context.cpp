@@ -0,0 +1,111 @@
+#include "spatial/common.hpp"
+#include "spatial/proj/context.hpp"
+#include "spatial/proj/module.hpp"
+
+namespace spatial {
+
+namespace proj {
+
+ProjContext::ProjContext() : ctx(ProjModule::CreateContext()) {
+}
+
+ProjContext::~ProjContext() {
+	// The objects have to go before the context they were created in
+	transformation_map.clear();
+	transformations.clear();
+	crs_map.clear();
+	proj_context_destroy(ctx);
+}
+
+bool ProjContext::Transformation::Matches(const string_t &from_p, const string_t &to_p, bool always_xy_p) const {
+	return always_xy == always_xy_p && from.size() == from_p.GetSize() && to.size() == to_p.GetSize() &&
+	       memcmp(from.data(), from_p.GetDataUnsafe(), from.size()) == 0 &&
+	       memcmp(to.data(), to_p.GetDataUnsafe(), to.size()) == 0;
+}
+
+string ProjContext::GetTransformationKey(const string_t &from, const string_t &to, bool always_xy) {
+	// Prefix with the length of the source so that the key is unambiguous
+	return to_string(from.GetSize()) + ":" + from.GetString() + to.GetString() + (always_xy ? "1" : "0");
+}
+
+const ProjTransformation &ProjContext::GetTransformation(const string_t &from, const string_t &to, bool always_xy) {
+	// Fast path: the same transformation as last time
+	if (!transformations.empty() && transformations.front().Matches(from, to, always_xy)) {
+		return transformations.front().transformation;
+	}
+
+	auto key = GetTransformationKey(from, to, always_xy);
+	auto entry = transformation_map.find(key);
+	if (entry != transformation_map.end()) {
+		// Move it to the front
+		transformations.splice(transformations.begin(), transformations, entry->second);
+		return transformations.front().transformation;
+	}
+
+	auto from_str = from.GetString();
+	auto to_str = to.GetString();
+	auto transformation = CreateTransformation(from_str, to_str, always_xy);
+	if (transformations.size() >= TRANSFORMATION_CACHE_SIZE) {
+		// Evict the least recently used transformation
+		auto &last = transformations.back();
+		transformation_map.erase(GetTransformationKey(last.from, last.to, last.always_xy));
+		transformations.pop_back();
+	}
+	transformations.push_front(
+	    Transformation {std::move(from_str), std::move(to_str), always_xy, std::move(transformation)});
+	transformation_map[key] = transformations.begin();
+	return transformations.front().transformation;
+}
+
+PJ *ProjContext::GetCRS(const string &definition) {
+	auto entry = crs_map.find(definition);
+	if (entry != crs_map.end()) {
+		return entry->second.get();
+	}
+	auto crs = ProjObject(proj_create(ctx, definition.c_str()));
+	if (!crs || !proj_is_crs(crs.get())) {
+		// e.g. a PROJ string without +type=crs, leave these to proj_create_crs_to_crs
+		return nullptr;
+	}
+	if (crs_map.size() >= CRS_CACHE_SIZE) {
+		// Transformations dont reference the CRS objects they were created from, so we can just start over
+		crs_map.clear();
+	}
+	return crs_map.emplace(definition, std::move(crs)).first->second.get();
+}
+
+ProjTransformation ProjContext::CreateTransformation(const string &from, const string &to, bool always_xy) {
+	// Resolving a CRS definition (e.g. looking up an EPSG code) is a good part of the work, so create the
+	// transformation from the cached CRS objects when we can.
+	ProjObject pj;
+	FastTransform fast;
+	auto from_crs = GetCRS(from);
+	auto to_crs = GetCRS(to);
+	if (from_crs && to_crs) {
+		pj = ProjObject(proj_create_crs_to_crs_from_pj(ctx, from_crs, to_crs, nullptr, nullptr));
+		if (pj) {
+			// Check if this is one of the transformations we can do without PROJ
+			fast = FastTransform::Create(ctx, from_crs, to_crs, always_xy);
+		}
+	}
+	if (!pj) {
+		pj = ProjObject(proj_create_crs_to_crs(ctx, from.c_str(), to.c_str(), nullptr));
+	}
+	if (!pj) {
+		throw InvalidInputException("Could not create projection: " + from + " -> " + to);
+	}
+	if (always_xy) {
+		auto normalized = proj_normalize_for_visualization(ctx, pj.get());
+		if (normalized) {
+			pj = ProjObject(normalized);
+		} else {
+			// otherwise fall back to the original CRS, and with that to its axis order
+			fast = FastTransform();
+		}
+	}
+	return ProjTransformation(std::move(pj), fast);
+}
+
+} // namespace proj
+
+} // namespace spatial
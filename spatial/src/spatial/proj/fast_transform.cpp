@@ -0,0 +1,447 @@
+#include "spatial/common.hpp"
+#include "spatial/proj/fast_transform.hpp"
+
+#include "duckdb/common/string_util.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace spatial {
+
+namespace proj {
+
+//------------------------------------------------------------------------------
+// Constants
+//------------------------------------------------------------------------------
+// These match the values PROJ uses, so that we end up with (almost) the same results
+
+static constexpr double DEG_TO_RAD = 0.017453292519943296;
+static constexpr double RAD_TO_DEG = 57.295779513082321;
+static constexpr double PI = 3.14159265358979323846;
+static constexpr double HALF_PI = 1.5707963267948966;
+static constexpr double EPS_LAT = 1e-12;
+
+// WGS84
+static constexpr double WGS84_A = 6378137.0;
+static constexpr double WGS84_RF = 298.257223563;
+
+// UTM
+static constexpr double UTM_K0 = 0.9996;
+static constexpr double UTM_X0 = 500000.0;
+static constexpr double UTM_SOUTH_Y0 = 10000000.0;
+// Beyond this (normalized) easting the series dont converge, PROJ gives up here as well
+static constexpr double UTM_MAX_EASTING = 2.623395162778;
+
+static constexpr idx_t TMERC_ORDER = 6;
+
+//------------------------------------------------------------------------------
+// Transverse Mercator
+//------------------------------------------------------------------------------
+// The coefficients of the Krüger series for the WGS84 ellipsoid, as given by Poder and Engsager.
+// This is the same 6th order series that PROJ uses for "utm" and "tmerc" by default.
+struct TransverseMercatorSeries {
+	double qn;                // Meridian quadrant, scaled by k0 (and normalized by a)
+	double cgb[TMERC_ORDER]; // Gaussian -> geodetic latitude
+	double cbg[TMERC_ORDER]; // Geodetic -> Gaussian latitude
+	double utg[TMERC_ORDER]; // Ellipsoidal N, E -> spherical N, E
+	double gtu[TMERC_ORDER]; // Spherical N, E -> ellipsoidal N, E
+
+	TransverseMercatorSeries() {
+		auto f = 1.0 / WGS84_RF;
+		auto es = f * (2 - f);
+		f = es / (1 + std::sqrt(1 - es));
+
+		// Third flattening
+		auto n = f / (2 - f);
+		auto np = n;
+
+		cgb[0] = n * (2 + n * (-2 / 3.0 + n * (-2 + n * (116 / 45.0 + n * (26 / 45.0 + n * (-2854 / 675.0))))));
+		cbg[0] = n * (-2 + n * (2 / 3.0 + n * (4 / 3.0 + n * (-82 / 45.0 + n * (32 / 45.0 + n * (4642 / 4725.0))))));
+		np *= n;
+		cgb[1] = np * (7 / 3.0 + n * (-8 / 5.0 + n * (-227 / 45.0 + n * (2704 / 315.0 + n * (2323 / 945.0)))));
+		cbg[1] = np * (5 / 3.0 + n * (-16 / 15.0 + n * (-13 / 9.0 + n * (904 / 315.0 + n * (-1522 / 945.0)))));
+		np *= n;
+		cgb[2] = np * (56 / 15.0 + n * (-136 / 35.0 + n * (-1262 / 105.0 + n * (73814 / 2835.0))));
+		cbg[2] = np * (-26 / 15.0 + n * (34 / 21.0 + n * (8 / 5.0 + n * (-12686 / 2835.0))));
+		np *= n;
+		cgb[3] = np * (4279 / 630.0 + n * (-332 / 35.0 + n * (-399572 / 14175.0)));
+		cbg[3] = np * (1237 / 630.0 + n * (-12 / 5.0 + n * (-24832 / 14175.0)));
+		np *= n;
+		cgb[4] = np * (4174 / 315.0 + n * (-144838 / 6237.0));
+		cbg[4] = np * (-734 / 315.0 + n * (109598 / 31185.0));
+		np *= n;
+		cgb[5] = np * (601676 / 22275.0);
+		cbg[5] = np * (444337 / 155925.0);
+
+		np = n * n;
+		qn = UTM_K0 / (1 + n) * (1 + np * (1 / 4.0 + np * (1 / 64.0 + np / 256.0)));
+
+		utg[0] = n * (-0.5 + n * (2 / 3.0 + n * (-37 / 96.0 + n * (1 / 360.0 + n * (81 / 512.0 +
+		                                                                          n * (-96199 / 604800.0))))));
+		gtu[0] = n * (0.5 + n * (-2 / 3.0 + n * (5 / 16.0 + n * (41 / 180.0 + n * (-127 / 288.0 +
+		                                                                        n * (7891 / 37800.0))))));
+		utg[1] =
+		    np * (-1 / 48.0 + n * (-1 / 15.0 + n * (437 / 1440.0 + n * (-46 / 105.0 + n * (1118711 / 3870720.0)))));
+		gtu[1] =
+		    np * (13 / 48.0 + n * (-3 / 5.0 + n * (557 / 1440.0 + n * (281 / 630.0 + n * (-1983433 / 1935360.0)))));
+		np *= n;
+		utg[2] = np * (-17 / 480.0 + n * (37 / 840.0 + n * (209 / 4480.0 + n * (-5569 / 90720.0))));
+		gtu[2] = np * (61 / 240.0 + n * (-103 / 140.0 + n * (15061 / 26880.0 + n * (167603 / 181440.0))));
+		np *= n;
+		utg[3] = np * (-4397 / 161280.0 + n * (11 / 504.0 + n * (830251 / 7257600.0)));
+		gtu[3] = np * (49561 / 161280.0 + n * (-179 / 168.0 + n * (6601661 / 7257600.0)));
+		np *= n;
+		utg[4] = np * (-4583 / 161280.0 + n * (108847 / 3991680.0));
+		gtu[4] = np * (34729 / 80640.0 + n * (-3418889 / 1995840.0));
+		np *= n;
+		utg[5] = np * (-20648693 / 638668800.0);
+		gtu[5] = np * (212378941 / 319334400.0);
+	}
+
+	static const TransverseMercatorSeries &Get() {
+		static const TransverseMercatorSeries series;
+		return series;
+	}
+};
+
+// Real Clenshaw summation of the series in the latitude
+static inline double GaussLatitude(const double *p, double b) {
+	auto cos_2b = 2 * std::cos(2 * b);
+	double h = 0;
+	double h1 = p[TMERC_ORDER - 1];
+	double h2 = 0;
+	for (idx_t i = TMERC_ORDER - 1; i > 0; i--) {
+		h = -h2 + cos_2b * h1 + p[i - 1];
+		h2 = h1;
+		h1 = h;
+	}
+	return b + h * std::sin(2 * b);
+}
+
+// Complex Clenshaw summation, returns the real and imaginary parts of the sum in re and im
+static inline void ClenshawComplex(const double *a, double arg_r, double arg_i, double &re, double &im) {
+	auto sin_arg_r = std::sin(arg_r);
+	auto cos_arg_r = std::cos(arg_r);
+	auto sinh_arg_i = std::sinh(arg_i);
+	auto cosh_arg_i = std::cosh(arg_i);
+	auto r = 2 * cos_arg_r * cosh_arg_i;
+	auto i = -2 * sin_arg_r * sinh_arg_i;
+
+	double hr = a[TMERC_ORDER - 1];
+	double hi = 0;
+	double hr1 = 0;
+	double hi1 = 0;
+	for (idx_t j = TMERC_ORDER - 1; j > 0; j--) {
+		auto hr2 = hr1;
+		auto hi2 = hi1;
+		hr1 = hr;
+		hi1 = hi;
+		hr = -hr2 + r * hr1 - i * hi1 + a[j - 1];
+		hi = -hi2 + i * hr1 + r * hi1;
+	}
+	r = sin_arg_r * cosh_arg_i;
+	i = cos_arg_r * sinh_arg_i;
+	re = r * hr - i * hi;
+	im = r * hi + i * hr;
+}
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+
+static inline double &Coordinate(double *data, size_t stride, idx_t idx) {
+	return *reinterpret_cast<double *>(reinterpret_cast<data_ptr_t>(data) + idx * stride);
+}
+
+// Wrap a longitude (in radians) into [-pi, pi]
+static inline double AdjustLongitude(double lon) {
+	if (std::fabs(lon) < PI + 1e-12) {
+		return lon;
+	}
+	lon += PI;
+	lon -= 2 * PI * std::floor(lon / (2 * PI));
+	lon -= PI;
+	return lon;
+}
+
+// Convert a latitude to radians, returns false if it is out of range
+static inline bool LatitudeToRadians(double lat, double &phi) {
+	phi = lat * DEG_TO_RAD;
+	auto over = std::fabs(phi) - HALF_PI;
+	if (!(over <= EPS_LAT)) {
+		return false;
+	}
+	if (over > 0) {
+		phi = phi < 0 ? -HALF_PI : HALF_PI;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// Kernels
+//------------------------------------------------------------------------------
+// Geographic coordinates are in degrees, in the axis order of the geographic CRS
+
+static void GeographicToWebMercator(double *lon_data, size_t lon_stride, double *lat_data, size_t lat_stride,
+                                    double *x_data, size_t x_stride, double *y_data, size_t y_stride, idx_t count) {
+	for (idx_t i = 0; i < count; i++) {
+		auto lon = Coordinate(lon_data, lon_stride, i);
+		auto lat = Coordinate(lat_data, lat_stride, i);
+		double phi;
+		if (!LatitudeToRadians(lat, phi) || lon == HUGE_VAL) {
+			Coordinate(x_data, x_stride, i) = HUGE_VAL;
+			Coordinate(y_data, y_stride, i) = HUGE_VAL;
+			continue;
+		}
+		auto lam = AdjustLongitude(lon * DEG_TO_RAD);
+		Coordinate(x_data, x_stride, i) = WGS84_A * lam;
+		Coordinate(y_data, y_stride, i) = WGS84_A * std::asinh(std::tan(phi));
+	}
+}
+
+static void WebMercatorToGeographic(double *x_data, size_t x_stride, double *y_data, size_t y_stride,
+                                    double *lon_data, size_t lon_stride, double *lat_data, size_t lat_stride,
+                                    idx_t count) {
+	for (idx_t i = 0; i < count; i++) {
+		auto x = Coordinate(x_data, x_stride, i);
+		auto y = Coordinate(y_data, y_stride, i);
+		if (x == HUGE_VAL || y == HUGE_VAL) {
+			Coordinate(lon_data, lon_stride, i) = HUGE_VAL;
+			Coordinate(lat_data, lat_stride, i) = HUGE_VAL;
+			continue;
+		}
+		auto lam = AdjustLongitude(x * (1 / WGS84_A));
+		auto phi = std::atan(std::sinh(y * (1 / WGS84_A)));
+		Coordinate(lon_data, lon_stride, i) = lam * RAD_TO_DEG;
+		Coordinate(lat_data, lat_stride, i) = phi * RAD_TO_DEG;
+	}
+}
+
+static void GeographicToUTM(double *lon_data, size_t lon_stride, double *lat_data, size_t lat_stride, double *x_data,
+                            size_t x_stride, double *y_data, size_t y_stride, idx_t count, double lon_0, double y_0) {
+	auto &series = TransverseMercatorSeries::Get();
+	for (idx_t i = 0; i < count; i++) {
+		auto lon = Coordinate(lon_data, lon_stride, i);
+		auto lat = Coordinate(lat_data, lat_stride, i);
+		double phi;
+		if (!LatitudeToRadians(lat, phi) || lon == HUGE_VAL) {
+			Coordinate(x_data, x_stride, i) = HUGE_VAL;
+			Coordinate(y_data, y_stride, i) = HUGE_VAL;
+			continue;
+		}
+		auto lam = AdjustLongitude(lon * DEG_TO_RAD - lon_0);
+
+		// Ellipsoidal latitude, longitude -> Gaussian latitude, longitude
+		auto cn = GaussLatitude(series.cbg, phi);
+		// Gaussian latitude, longitude -> complex spherical latitude
+		auto sin_cn = std::sin(cn);
+		auto cos_cn = std::cos(cn);
+		auto sin_ce = std::sin(lam);
+		auto cos_ce = std::cos(lam);
+		auto cos_cn_cos_ce = cos_cn * cos_ce;
+		cn = std::atan2(sin_cn, cos_cn_cos_ce);
+		auto tan_ce = sin_ce * cos_cn / std::hypot(sin_cn, cos_cn_cos_ce);
+		// Complex spherical N, E -> ellipsoidal normalized N, E
+		auto ce = std::asinh(tan_ce);
+		double dcn, dce;
+		ClenshawComplex(series.gtu, 2 * cn, 2 * ce, dcn, dce);
+		cn += dcn;
+		ce += dce;
+
+		if (std::fabs(ce) <= UTM_MAX_EASTING) {
+			Coordinate(x_data, x_stride, i) = WGS84_A * (series.qn * ce) + UTM_X0;
+			Coordinate(y_data, y_stride, i) = WGS84_A * (series.qn * cn) + y_0;
+		} else {
+			Coordinate(x_data, x_stride, i) = HUGE_VAL;
+			Coordinate(y_data, y_stride, i) = HUGE_VAL;
+		}
+	}
+}
+
+static void UTMToGeographic(double *x_data, size_t x_stride, double *y_data, size_t y_stride, double *lon_data,
+                            size_t lon_stride, double *lat_data, size_t lat_stride, idx_t count, double lon_0,
+                            double y_0) {
+	auto &series = TransverseMercatorSeries::Get();
+	for (idx_t i = 0; i < count; i++) {
+		auto x = Coordinate(x_data, x_stride, i);
+		auto y = Coordinate(y_data, y_stride, i);
+
+		// Normalize N, E
+		auto cn = ((y - y_0) * (1 / WGS84_A)) / series.qn;
+		auto ce = ((x - UTM_X0) * (1 / WGS84_A)) / series.qn;
+
+		if (x == HUGE_VAL || y == HUGE_VAL || !(std::fabs(ce) <= UTM_MAX_EASTING)) {
+			Coordinate(lon_data, lon_stride, i) = HUGE_VAL;
+			Coordinate(lat_data, lat_stride, i) = HUGE_VAL;
+			continue;
+		}
+
+		// Normalized N, E -> complex spherical latitude, longitude
+		double dcn, dce;
+		ClenshawComplex(series.utg, 2 * cn, 2 * ce, dcn, dce);
+		cn += dcn;
+		ce += dce;
+		ce = std::atan(std::sinh(ce));
+		// Complex spherical latitude -> Gaussian latitude, longitude
+		auto sin_cn = std::sin(cn);
+		auto cos_cn = std::cos(cn);
+		auto sin_ce = std::sin(ce);
+		auto cos_ce = std::cos(ce);
+		auto lam = std::atan2(sin_ce, cos_ce * cos_cn);
+		cn = std::atan2(sin_cn * cos_ce, std::hypot(sin_ce, cos_ce * cos_cn));
+		// Gaussian latitude, longitude -> ellipsoidal latitude, longitude
+		auto phi = GaussLatitude(series.cgb, cn);
+
+		Coordinate(lon_data, lon_stride, i) = AdjustLongitude(lam + lon_0) * RAD_TO_DEG;
+		Coordinate(lat_data, lat_stride, i) = phi * RAD_TO_DEG;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Transform
+//------------------------------------------------------------------------------
+
+void FastTransform::Transform(double *x, size_t x_stride, double *y, size_t y_stride, idx_t count) const {
+	// The geographic side may have its axes swapped
+	auto lon = lat_first ? y : x;
+	auto lon_stride = lat_first ? y_stride : x_stride;
+	auto lat = lat_first ? x : y;
+	auto lat_stride = lat_first ? x_stride : y_stride;
+
+	switch (kind) {
+	case Kind::GEOGRAPHIC_TO_WEB_MERCATOR:
+		GeographicToWebMercator(lon, lon_stride, lat, lat_stride, x, x_stride, y, y_stride, count);
+		break;
+	case Kind::WEB_MERCATOR_TO_GEOGRAPHIC:
+		WebMercatorToGeographic(x, x_stride, y, y_stride, lon, lon_stride, lat, lat_stride, count);
+		break;
+	case Kind::GEOGRAPHIC_TO_UTM:
+		GeographicToUTM(lon, lon_stride, lat, lat_stride, x, x_stride, y, y_stride, count, lon_0, y_0);
+		break;
+	case Kind::UTM_TO_GEOGRAPHIC:
+		UTMToGeographic(x, x_stride, y, y_stride, lon, lon_stride, lat, lat_stride, count, lon_0, y_0);
+		break;
+	default:
+		throw InternalException("FastTransform::Transform called without a closed-form transformation");
+	}
+}
+
+//------------------------------------------------------------------------------
+// Create
+//------------------------------------------------------------------------------
+
+enum class KnownCRS : uint8_t { OTHER, WGS84_GEOGRAPHIC, WEB_MERCATOR, UTM_NORTH, UTM_SOUTH };
+
+static KnownCRS IdentifyCRS(PJ *crs, int &utm_zone) {
+	auto auth = proj_get_id_auth_name(crs, 0);
+	auto code = proj_get_id_code(crs, 0);
+	if (!auth || !code) {
+		return KnownCRS::OTHER;
+	}
+	if (strcmp(auth, "OGC") == 0 && strcmp(code, "CRS84") == 0) {
+		return KnownCRS::WGS84_GEOGRAPHIC;
+	}
+	if (strcmp(auth, "EPSG") != 0) {
+		return KnownCRS::OTHER;
+	}
+	char *end = nullptr;
+	auto epsg = std::strtol(code, &end, 10);
+	if (end == code || *end != '\0') {
+		return KnownCRS::OTHER;
+	}
+	if (epsg == 4326) {
+		return KnownCRS::WGS84_GEOGRAPHIC;
+	}
+	if (epsg == 3857) {
+		return KnownCRS::WEB_MERCATOR;
+	}
+	if (epsg >= 32601 && epsg <= 32660) {
+		utm_zone = static_cast<int>(epsg - 32600);
+		return KnownCRS::UTM_NORTH;
+	}
+	if (epsg >= 32701 && epsg <= 32760) {
+		utm_zone = static_cast<int>(epsg - 32700);
+		return KnownCRS::UTM_SOUTH;
+	}
+	return KnownCRS::OTHER;
+}
+
+// Get the direction of the first axis of a CRS, e.g. "north" or "east"
+static string GetFirstAxisDirection(PJ_CONTEXT *ctx, PJ *crs) {
+	string result;
+	auto cs = proj_crs_get_coordinate_system(ctx, crs);
+	if (!cs) {
+		return result;
+	}
+	const char *direction = nullptr;
+	if (proj_cs_get_axis_info(ctx, cs, 0, nullptr, nullptr, &direction, nullptr, nullptr, nullptr, nullptr) &&
+	    direction) {
+		result = direction;
+	}
+	proj_destroy(cs);
+	return result;
+}
+
+FastTransform FastTransform::Create(PJ_CONTEXT *ctx, PJ *from, PJ *to, bool always_xy) {
+	FastTransform result;
+
+	int from_zone = 0;
+	int to_zone = 0;
+	auto from_kind = IdentifyCRS(from, from_zone);
+	auto to_kind = IdentifyCRS(to, to_zone);
+
+	PJ *geographic;
+	PJ *projected;
+	KnownCRS projected_kind;
+	int zone;
+	bool forward;
+	if (from_kind == KnownCRS::WGS84_GEOGRAPHIC) {
+		geographic = from;
+		projected = to;
+		projected_kind = to_kind;
+		zone = to_zone;
+		forward = true;
+	} else if (to_kind == KnownCRS::WGS84_GEOGRAPHIC) {
+		geographic = to;
+		projected = from;
+		projected_kind = from_kind;
+		zone = from_zone;
+		forward = false;
+	} else {
+		return result;
+	}
+
+	switch (projected_kind) {
+	case KnownCRS::WEB_MERCATOR:
+		result.kind = forward ? Kind::GEOGRAPHIC_TO_WEB_MERCATOR : Kind::WEB_MERCATOR_TO_GEOGRAPHIC;
+		break;
+	case KnownCRS::UTM_NORTH:
+	case KnownCRS::UTM_SOUTH:
+		result.kind = forward ? Kind::GEOGRAPHIC_TO_UTM : Kind::UTM_TO_GEOGRAPHIC;
+		result.lon_0 = ((zone - 1.) + 0.5) * PI / 30. - PI;
+		result.y_0 = projected_kind == KnownCRS::UTM_SOUTH ? UTM_SOUTH_Y0 : 0;
+		break;
+	default:
+		return FastTransform();
+	}
+
+	// Dont trust the identifiers blindly for the axis order, a CRS definition could override it
+	auto geographic_axis = GetFirstAxisDirection(ctx, geographic);
+	auto projected_axis = GetFirstAxisDirection(ctx, projected);
+	if (!StringUtil::CIEquals(projected_axis, "east")) {
+		return FastTransform();
+	}
+	if (StringUtil::CIEquals(geographic_axis, "north")) {
+		result.lat_first = !always_xy;
+	} else if (StringUtil::CIEquals(geographic_axis, "east")) {
+		result.lat_first = false;
+	} else {
+		return FastTransform();
+	}
+	return result;
+}
+
+} // namespace proj
+
+} // namespace spatial
@@ -10,6 +10,7 @@
 #include "spatial/core/geometry/geometry_factory.hpp"
 #include "spatial/proj/functions.hpp"
 #include "spatial/proj/module.hpp"
+#include "spatial/proj/context.hpp"
 
 #include "proj.h"
 
@@ -21,15 +22,16 @@ using namespace core;
 
 struct ProjFunctionLocalState : public FunctionLocalState {
 
-	PJ_CONTEXT *proj_ctx;
+	unique_ptr<ProjContext> proj_ctx;
 	GeometryFactory factory;
 
 	explicit ProjFunctionLocalState(ClientContext &context)
-	    : proj_ctx(ProjModule::GetThreadProjContext()), factory(BufferAllocator::Get(context)) {
+	    : proj_ctx(ProjModule::AcquireContext()), factory(BufferAllocator::Get(context)) {
 	}
 
 	~ProjFunctionLocalState() override {
-		proj_context_destroy(proj_ctx);
+		// Hand the context (and the transformations created in it) back for the next query to use
+		ProjModule::ReleaseContext(std::move(proj_ctx));
 	}
 
 	static unique_ptr<FunctionLocalState> Init(ExpressionState &state, const BoundFunctionExpression &expr,
@@ -89,7 +91,7 @@ static void Box2DTransformFunction(DataChunk &args, ExpressionState &state, Vect
 	auto &proj_to = args.data[2];
 
 	auto &local_state = ProjFunctionLocalState::ResetAndGet(state);
-	auto &proj_ctx = local_state.proj_ctx;
+	auto proj_ctx = local_state.proj_ctx->Get();
 	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
 	auto &info = func_expr.bind_info->Cast<TransformFunctionData>();
 
@@ -97,22 +99,9 @@ static void Box2DTransformFunction(DataChunk &args, ExpressionState &state, Vect
 	    proj_to.GetVectorType() == VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(proj_from) &&
 	    !ConstantVector::IsNull(proj_to)) {
 		// Special case: both projections are constant, so we can create the projection once and reuse it
-		auto from_str = ConstantVector::GetData<PROJ_TYPE>(proj_from)[0].val.GetString();
-		auto to_str = ConstantVector::GetData<PROJ_TYPE>(proj_to)[0].val.GetString();
-
-		auto crs = proj_create_crs_to_crs(proj_ctx, from_str.c_str(), to_str.c_str(), nullptr);
-		if (!crs) {
-			throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
-		}
-
-		if (info.conventional_gis_order) {
-			auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs);
-			if (normalized_crs) {
-				proj_destroy(crs);
-				crs = normalized_crs;
-			}
-			// otherwise fall back to the original CRS
-		}
+		auto &from = ConstantVector::GetData<PROJ_TYPE>(proj_from)[0].val;
+		auto &to = ConstantVector::GetData<PROJ_TYPE>(proj_to)[0].val;
+		auto crs = local_state.proj_ctx->GetTransformation(from, to, info.conventional_gis_order).Get();
 
 		GenericExecutor::ExecuteUnary<BOX_TYPE, BOX_TYPE>(box, result, count, [&](BOX_TYPE box_in) {
 			BOX_TYPE box_out;
@@ -121,36 +110,18 @@ static void Box2DTransformFunction(DataChunk &args, ExpressionState &state, Vect
 			                  &box_out.a_val, &box_out.b_val, &box_out.c_val, &box_out.d_val, densify_pts);
 			return box_out;
 		});
-
-		proj_destroy(crs);
 	} else {
 		GenericExecutor::ExecuteTernary<BOX_TYPE, PROJ_TYPE, PROJ_TYPE, BOX_TYPE>(
 		    box, proj_from, proj_to, result, count, [&](BOX_TYPE box_in, PROJ_TYPE proj_from, PROJ_TYPE proj_to) {
-			    auto from_str = proj_from.val.GetString();
-			    auto to_str = proj_to.val.GetString();
-
-			    auto crs = proj_create_crs_to_crs(nullptr, from_str.c_str(), to_str.c_str(), nullptr);
-			    if (!crs) {
-				    throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
-			    }
-
-			    if (info.conventional_gis_order) {
-				    auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs);
-				    if (normalized_crs) {
-					    proj_destroy(crs);
-					    crs = normalized_crs;
-				    }
-				    // otherwise fall back to the original CRS
-			    }
+			    auto crs = local_state.proj_ctx
+			                   ->GetTransformation(proj_from.val, proj_to.val, info.conventional_gis_order)
+			                   .Get();
 
 			    // TODO: this may be interesting to use, but at that point we can only return a BOX_TYPE
 			    int densify_pts = 0;
 			    BOX_TYPE box_out;
 			    proj_trans_bounds(proj_ctx, crs, PJ_FWD, box_in.a_val, box_in.b_val, box_in.c_val, box_in.d_val,
 			                      &box_out.a_val, &box_out.b_val, &box_out.c_val, &box_out.d_val, densify_pts);
-
-			    proj_destroy(crs);
-
 			    return box_out;
 		    });
 	}
@@ -166,7 +137,6 @@ static void Point2DTransformFunction(DataChunk &args, ExpressionState &state, Ve
 	auto &proj_to = args.data[2];
 
 	auto &local_state = ProjFunctionLocalState::ResetAndGet(state);
-	auto &proj_ctx = local_state.proj_ctx;
 	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
 	auto &info = func_expr.bind_info->Cast<TransformFunctionData>();
 
@@ -174,122 +144,96 @@ static void Point2DTransformFunction(DataChunk &args, ExpressionState &state, Ve
 	    proj_to.GetVectorType() == VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(proj_from) &&
 	    !ConstantVector::IsNull(proj_to)) {
 		// Special case: both projections are constant, so we can create the projection once and reuse it
-		auto from_str = ConstantVector::GetData<PROJ_TYPE>(proj_from)[0].val.GetString();
-		auto to_str = ConstantVector::GetData<PROJ_TYPE>(proj_to)[0].val.GetString();
-
-		auto crs = proj_create_crs_to_crs(proj_ctx, from_str.c_str(), to_str.c_str(), nullptr);
-		if (!crs) {
-			throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
-		}
-
-		if (info.conventional_gis_order) {
-			auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs);
-			if (normalized_crs) {
-				proj_destroy(crs);
-				crs = normalized_crs;
-			}
-			// otherwise fall back to the original CRS
+		auto &from = ConstantVector::GetData<PROJ_TYPE>(proj_from)[0].val;
+		auto &to = ConstantVector::GetData<PROJ_TYPE>(proj_to)[0].val;
+		auto &transformation = local_state.proj_ctx->GetTransformation(from, to, info.conventional_gis_order);
+
+		// Copy the coordinates to the result and transform them all in place with a single call
+		auto is_constant = point.GetVectorType() == VectorType::CONSTANT_VECTOR;
+		point.Flatten(count);
+		auto &point_children = StructVector::GetEntries(point);
+		auto &result_children = StructVector::GetEntries(result);
+		FlatVector::SetValidity(result, FlatVector::Validity(point));
+
+		auto x_data = FlatVector::GetData<double>(*result_children[0]);
+		auto y_data = FlatVector::GetData<double>(*result_children[1]);
+		memcpy(x_data, FlatVector::GetData<double>(*point_children[0]), count * sizeof(double));
+		memcpy(y_data, FlatVector::GetData<double>(*point_children[1]), count * sizeof(double));
+		FlatVector::SetValidity(*result_children[0], FlatVector::Validity(*point_children[0]));
+		FlatVector::SetValidity(*result_children[1], FlatVector::Validity(*point_children[1]));
+
+		transformation.Transform(x_data, sizeof(double), y_data, sizeof(double), count);
+		if (is_constant) {
+			result.SetVectorType(VectorType::CONSTANT_VECTOR);
 		}
-
-		GenericExecutor::ExecuteUnary<POINT_TYPE, POINT_TYPE>(point, result, count, [&](POINT_TYPE point_in) {
-			POINT_TYPE point_out;
-			auto transformed = proj_trans(crs, PJ_FWD, proj_coord(point_in.a_val, point_in.b_val, 0, 0)).xy;
-			point_out.a_val = transformed.x;
-			point_out.b_val = transformed.y;
-			return point_out;
-		});
-		proj_destroy(crs);
-
 	} else {
 		GenericExecutor::ExecuteTernary<POINT_TYPE, PROJ_TYPE, PROJ_TYPE, POINT_TYPE>(
 		    point, proj_from, proj_to, result, count, [&](POINT_TYPE point_in, PROJ_TYPE proj_from, PROJ_TYPE proj_to) {
-			    auto from_str = proj_from.val.GetString();
-			    auto to_str = proj_to.val.GetString();
-
-			    auto crs = proj_create_crs_to_crs(proj_ctx, from_str.c_str(), to_str.c_str(), nullptr);
-			    if (!crs) {
-				    throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
-			    }
-
-			    if (info.conventional_gis_order) {
-				    auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs);
-				    if (normalized_crs) {
-					    proj_destroy(crs);
-					    crs = normalized_crs;
-				    }
-				    // otherwise fall back to the original CRS
-			    }
+			    auto &transformation =
+			        local_state.proj_ctx->GetTransformation(proj_from.val, proj_to.val, info.conventional_gis_order);
 
 			    POINT_TYPE point_out;
-			    auto transformed = proj_trans(crs, PJ_FWD, proj_coord(point_in.a_val, point_in.b_val, 0, 0)).xy;
-			    point_out.a_val = transformed.x;
-			    point_out.b_val = transformed.y;
-
-			    proj_destroy(crs);
-
+			    point_out.a_val = point_in.a_val;
+			    point_out.b_val = point_in.b_val;
+			    transformation.Transform(&point_out.a_val, sizeof(double), &point_out.b_val, sizeof(double), 1);
 			    return point_out;
 		    });
 	}
 }
 
 struct TransformOp {
-	static void Transform(VertexArray &array, PJ *crs, ArenaAllocator &arena) {
+	static void Transform(VertexArray &array, const ProjTransformation &transformation, ArenaAllocator &arena) {
+		// Once we own the array its coordinates are aligned, so we can transform them in place
 		array.MakeOwning(arena);
-		for (uint32_t i = 0; i < array.Count(); i++) {
-			auto vertex = array.Get(i);
-			auto transformed = proj_trans(crs, PJ_FWD, proj_coord(vertex.x, vertex.y, 0, 0)).xy;
-			// we own the array, so we can use SetUnsafe
-			array.Set(i, transformed.x, transformed.y);
+		auto count = array.Count();
+		if (count == 0) {
+			return;
 		}
+		// The vertices are interleaved, so step over any z/m values. These are left as they are.
+		auto stride = array.GetProperties().VertexSize();
+		auto data = reinterpret_cast<double *>(array.GetData());
+		transformation.Transform(data, stride, data + 1, stride, count);
 	}
 
-	static void Apply(Point &point, PJ *crs, ArenaAllocator &arena) {
-		Transform(point.Vertices(), crs, arena);
+	static void Apply(Point &point, const ProjTransformation &transformation, ArenaAllocator &arena) {
+		Transform(point.Vertices(), transformation, arena);
 	}
 
-	static void Apply(LineString &line, PJ *crs, ArenaAllocator &arena) {
-		Transform(line.Vertices(), crs, arena);
+	static void Apply(LineString &line, const ProjTransformation &transformation, ArenaAllocator &arena) {
+		Transform(line.Vertices(), transformation, arena);
 	}
 
-	static void Apply(Polygon &poly, PJ *crs, ArenaAllocator &arena) {
+	static void Apply(Polygon &poly, const ProjTransformation &transformation, ArenaAllocator &arena) {
 		for (auto &ring : poly) {
-			Transform(ring, crs, arena);
+			Transform(ring, transformation, arena);
 		}
 	}
 
-	static void Apply(MultiPoint &multi_point, PJ *crs, ArenaAllocator &arena) {
+	static void Apply(MultiPoint &multi_point, const ProjTransformation &transformation, ArenaAllocator &arena) {
 		for (auto &point : multi_point) {
-			Apply(point, crs, arena);
+			Apply(point, transformation, arena);
 		}
 	}
 
-	static void Apply(MultiLineString &multi_line, PJ *crs, ArenaAllocator &arena) {
+	static void Apply(MultiLineString &multi_line, const ProjTransformation &transformation, ArenaAllocator &arena) {
 		for (auto &line : multi_line) {
-			Apply(line, crs, arena);
+			Apply(line, transformation, arena);
 		}
 	}
 
-	static void Apply(MultiPolygon &multi_poly, PJ *crs, ArenaAllocator &arena) {
+	static void Apply(MultiPolygon &multi_poly, const ProjTransformation &transformation, ArenaAllocator &arena) {
 		for (auto &poly : multi_poly) {
-			Apply(poly, crs, arena);
+			Apply(poly, transformation, arena);
 		}
 	}
 
-	static void Apply(GeometryCollection &geom, PJ *crs, ArenaAllocator &arena) {
+	static void Apply(GeometryCollection &geom, const ProjTransformation &transformation, ArenaAllocator &arena) {
 		for (auto &child : geom) {
-			child.Dispatch<TransformOp>(crs, arena);
+			child.Dispatch<TransformOp>(transformation, arena);
 		}
 	}
 };
 
-struct ProjCRSDelete {
-	void operator()(PJ *crs) {
-		proj_destroy(crs);
-	}
-};
-
-using ProjCRS = unique_ptr<PJ, ProjCRSDelete>;
-
 static void GeometryTransformFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto count = args.size();
 	auto &geom_vec = args.data[0];
@@ -301,63 +245,35 @@ static void GeometryTransformFunction(DataChunk &args, ExpressionState &state, V
 	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
 	auto &info = func_expr.bind_info->Cast<TransformFunctionData>();
 
-	auto &proj_ctx = local_state.proj_ctx;
 	auto &factory = local_state.factory;
 
 	if (proj_from_vec.GetVectorType() == VectorType::CONSTANT_VECTOR &&
 	    proj_to_vec.GetVectorType() == VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(proj_from_vec) &&
 	    !ConstantVector::IsNull(proj_to_vec)) {
 		// Special case: both projections are constant (very common)
-		// we can create the projection once and reuse it for all geometries
-
-		// TODO: In the future we can cache the projections in the state instead.
-
-		auto from_str = ConstantVector::GetData<string_t>(proj_from_vec)[0].GetString();
-		auto to_str = ConstantVector::GetData<string_t>(proj_to_vec)[0].GetString();
-		auto crs = ProjCRS(proj_create_crs_to_crs(proj_ctx, from_str.c_str(), to_str.c_str(), nullptr));
-		if (!crs.get()) {
-			throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
-		}
-
-		if (info.conventional_gis_order) {
-			auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs.get());
-			if (normalized_crs) {
-				crs = ProjCRS(normalized_crs);
-			}
-			// otherwise fall back to the original CRS
-		}
+		// we can look up the projection once and reuse it for all geometries
+		auto &from = ConstantVector::GetData<string_t>(proj_from_vec)[0];
+		auto &to = ConstantVector::GetData<string_t>(proj_to_vec)[0];
+		auto &transformation = local_state.proj_ctx->GetTransformation(from, to, info.conventional_gis_order);
 
 		UnaryExecutor::Execute<geometry_t, geometry_t>(geom_vec, result, count, [&](geometry_t input_geom) {
 			auto props = input_geom.GetProperties();
 			auto geom = factory.Deserialize(input_geom);
-			geom.Dispatch<TransformOp>(crs.get(), factory.allocator);
+			geom.Dispatch<TransformOp>(transformation, factory.allocator);
 			return factory.Serialize(result, geom, props.HasZ(), props.HasM());
 		});
 	} else {
 		// General case: projections are not constant
-		// we need to create a projection for each geometry
+		// we look up the projection for each geometry, which is cheap as long as there are only a few different ones
 		TernaryExecutor::Execute<geometry_t, string_t, string_t, geometry_t>(
 		    geom_vec, proj_from_vec, proj_to_vec, result, count,
 		    [&](geometry_t input_geom, string_t proj_from, string_t proj_to) {
-			    auto from_str = proj_from.GetString();
-			    auto to_str = proj_to.GetString();
-			    auto crs = ProjCRS(proj_create_crs_to_crs(proj_ctx, from_str.c_str(), to_str.c_str(), nullptr));
-
-			    if (!crs.get()) {
-				    throw InvalidInputException("Could not create projection: " + from_str + " -> " + to_str);
-			    }
-
-			    if (info.conventional_gis_order) {
-				    auto normalized_crs = proj_normalize_for_visualization(proj_ctx, crs.get());
-				    if (normalized_crs) {
-					    crs = ProjCRS(normalized_crs);
-				    }
-				    // otherwise fall back to the original CRS
-			    }
+			    auto &transformation =
+			        local_state.proj_ctx->GetTransformation(proj_from, proj_to, info.conventional_gis_order);
 
 			    auto props = input_geom.GetProperties();
 			    auto geom = factory.Deserialize(input_geom);
-			    geom.Dispatch<TransformOp>(crs.get(), factory.allocator);
+			    geom.Dispatch<TransformOp>(transformation, factory.allocator);
 			    // TransformGeometry(crs.get(), geom);
 			    return factory.Serialize(result, geom, props.HasZ(), props.HasM());
 		    });
@@ -1,6 +1,8 @@
 #include "spatial/common.hpp"
+#include "duckdb/common/mutex.hpp"
 
 #include "spatial/proj/module.hpp"
+#include "spatial/proj/context.hpp"
 #include "spatial/proj/functions.hpp"
 
 #include "proj.h"
@@ -20,7 +22,7 @@ extern "C" unsigned char proj_db[];
 extern "C" unsigned int proj_db_len;
 extern "C" int sqlite3_memvfs_init(sqlite3 *, char **, const sqlite3_api_routines *);
 
-PJ_CONTEXT *ProjModule::GetThreadProjContext() {
+PJ_CONTEXT *ProjModule::CreateContext() {
 
 	auto ctx = proj_context_create();
 
@@ -44,6 +46,32 @@ PJ_CONTEXT *ProjModule::GetThreadProjContext() {
 	return ctx;
 }
 
+// Contexts that are not in use. These keep the transformations created in them, so the pool is shared by the
+// whole process rather than per database.
+static mutex context_pool_lock;
+static vector<unique_ptr<ProjContext>> context_pool;
+// We dont need to keep more contexts around than there are threads using them at once
+static constexpr idx_t MAX_POOLED_CONTEXTS = 128;
+
+unique_ptr<ProjContext> ProjModule::AcquireContext() {
+	{
+		lock_guard<mutex> guard(context_pool_lock);
+		if (!context_pool.empty()) {
+			auto context = std::move(context_pool.back());
+			context_pool.pop_back();
+			return context;
+		}
+	}
+	return make_uniq<ProjContext>();
+}
+
+void ProjModule::ReleaseContext(unique_ptr<ProjContext> context) {
+	lock_guard<mutex> guard(context_pool_lock);
+	if (context_pool.size() < MAX_POOLED_CONTEXTS) {
+		context_pool.push_back(std::move(context));
+	}
+}
+
 // TODO: ignore memvfs, load into :memory: at runtime instead...?
 
 // IMPORTANT: Make sure this module is loaded before any other modules that use proj (like GDAL)
@@ -73,6 +101,9 @@ void ProjModule::Register(DatabaseInstance &db) {
 		throw InternalException("Could not set proj.db path");
 	}
 
+	// Set up the first context up front, so that the first query doesnt have to
+	ReleaseContext(AcquireContext());
+
 	// Register functions
 	ProjFunctions::Register(db);
 }